@@ -0,0 +1,78 @@
+#################################################################
+#
+# This file is part of RSS Guard.
+#
+# Copyright (C) 2011-2017 by Martin Rotter <rotter.martinos@gmail.com>
+#
+# RSS Guard is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# RSS Guard is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with RSS Guard. If not, see <http:# www.gnu.org/licenses/>.
+#
+#
+#  This is RSS Guard benchmark compilation script for qmake.
+#  Benchmark is headless console application which links
+#  all core sources of RSS Guard, it is not installed.
+#
+#  Benchmark includes whole rssguard.pri, GUI modules included.
+#  Core sources are not separable from GUI ones, messages model
+#  provides fonts and icons, service roots and feeds create
+#  their dialogs and rendering benchmarks use web viewer.
+#  Benchmark runs on "offscreen" platform instead.
+#
+# Usage:
+#     cd ../build-bench-dir
+#     qmake ../rssguard-dir/benchmark/benchmark.pro CONFIG+=release
+#     make
+#     ./rssguard-bench -h
+#
+# Benchmarks of core operations run against generated database,
+# "rssguard-bench update" measures full update rounds of feeds
+# served by local mock feed server.
+#
+# Bundled AdBlock list and URL corpus in "data" folder are
+# used by AdBlock matching benchmarks, which are available
+# only in builds with WebEngine.
+#
+# Results are printed to standard output, one JSON object per line.
+#
+#################################################################
+
+TEMPLATE    = app
+TARGET      = rssguard-bench
+
+CONFIG      *= console
+CONFIG      -= app_bundle
+
+message(rssguard-bench: Welcome RSS Guard benchmark qmake script.)
+
+include(../rssguard.pri)
+
+HEADERS +=  src/benchmarkrunner.h \
+            src/mockfeedserver.h \
+            src/syntheticdatabase.h \
+            src/syntheticfeeds.h \
+            src/updateharness.h
+
+SOURCES +=  src/benchmarkrunner.cpp \
+            src/main.cpp \
+            src/mockfeedserver.cpp \
+            src/syntheticdatabase.cpp \
+            src/syntheticfeeds.cpp \
+            src/updateharness.cpp
+
+INCLUDEPATH +=  $$PWD/src
+
+RESOURCES += benchmark.qrc
+
+win32 {
+  LIBS += -lpsapi
+}
@@ -0,0 +1,503 @@
+// This file is part of RSS Guard.
+
+//
+// Copyright (C) 2011-2017 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+#include "benchmarkrunner.h"
+
+#include "syntheticdatabase.h"
+
+#include "core/feedsmodel.h"
+#include "core/messagesmodel.h"
+#include "core/messagesproxymodel.h"
+#include "definitions/definitions.h"
+#include "miscellaneous/application.h"
+#include "miscellaneous/databasefactory.h"
+#include "miscellaneous/databasequeries.h"
+#include "miscellaneous/feedreader.h"
+#include "miscellaneous/skinfactory.h"
+#include "services/abstract/category.h"
+#include "services/abstract/serviceroot.h"
+#include "services/standard/atomparser.h"
+#include "services/standard/rdfparser.h"
+#include "services/standard/rssparser.h"
+
+#if defined(USE_WEBENGINE)
+#include "gui/webviewer.h"
+#include "network-web/adblock/adblockmatcher.h"
+#include "network-web/adblock/adblockrule.h"
+#include "network-web/adblock/adblocksubscription.h"
+#endif
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QIcon>
+#include <QJsonDocument>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QtMath>
+
+#include <algorithm>
+#include <cstdio>
+
+BenchmarkRunner::BenchmarkRunner(SyntheticDatabase* database, int iterations)
+  : m_database(database), m_db(qApp->database()->connection(QSL("Benchmark"), DatabaseFactory::FromSettings)),
+  m_iterations(qMax(1, iterations)) {}
+
+void BenchmarkRunner::run(const QString& prefix) {
+  m_prefix = prefix;
+
+  benchmarkParsers();
+  benchmarkIngest();
+  benchmarkCounts();
+  benchmarkModel();
+  benchmarkModelRoles();
+  benchmarkRendering();
+  benchmarkAdBlock();
+  benchmarkBulkOperations();
+}
+
+QJsonObject BenchmarkRunner::timings(QVector<double> times_ms) {
+  QJsonObject result;
+
+  if (times_ms.isEmpty()) {
+    return result;
+  }
+
+  std::sort(times_ms.begin(), times_ms.end());
+
+  const int count = times_ms.size();
+  double sum = 0.0;
+
+  foreach (double time, times_ms) {
+    sum += time;
+  }
+
+  // Nearest-rank percentiles.
+  auto percentile = [&times_ms, count](double p) {
+    return times_ms.at(qBound(0, int(qCeil(p * count)) - 1, count - 1));
+  };
+
+  result[QSL("min_ms")] = times_ms.first();
+  result[QSL("median_ms")] = count % 2 == 1 ? times_ms.at(count / 2) : (times_ms.at(count / 2 - 1) + times_ms.at(count / 2)) / 2.0;
+  result[QSL("mean_ms")] = sum / count;
+  result[QSL("p95_ms")] = percentile(0.95);
+  result[QSL("p99_ms")] = percentile(0.99);
+  result[QSL("max_ms")] = times_ms.last();
+  return result;
+}
+
+void BenchmarkRunner::print(const QJsonObject& result) {
+  fprintf(stdout, "%s\n", QJsonDocument(result).toJson(QJsonDocument::Compact).constData());
+  fflush(stdout);
+}
+
+void BenchmarkRunner::measure(const QString& name, const Operation& operation, const Step& setup, const Step& cleanup) {
+  if (!m_prefix.isEmpty() && !name.startsWith(m_prefix)) {
+    return;
+  }
+
+  QVector<double> times_ms;
+  QElapsedTimer timer;
+  int items = 0;
+
+  times_ms.reserve(m_iterations);
+
+  for (int i = 0; i < m_iterations; i++) {
+    if (setup) {
+      setup();
+    }
+
+    timer.start();
+    items = operation();
+    times_ms.append(timer.nsecsElapsed() / 1000000.0);
+
+    if (cleanup) {
+      cleanup();
+    }
+  }
+
+  QJsonObject result = timings(times_ms);
+
+  result[QSL("benchmark")] = name;
+  result[QSL("iterations")] = m_iterations;
+  result[QSL("items")] = items;
+  print(result);
+}
+
+void BenchmarkRunner::benchmarkParsers() {
+  const int items = 500;
+  SyntheticFeeds* generator = m_database->generator();
+  const QByteArray rss = generator->document(SyntheticFeeds::Rss, QSL("http://bench.rssguard.invalid/parser"),
+                                             QSL("RSS parser"), items, m_database->scale().m_contentsLength);
+  const QByteArray atom = generator->document(SyntheticFeeds::Atom, QSL("http://bench.rssguard.invalid/parser"),
+                                              QSL("ATOM parser"), items, m_database->scale().m_contentsLength);
+  const QByteArray rdf = generator->document(SyntheticFeeds::Rdf, QSL("http://bench.rssguard.invalid/parser"),
+                                             QSL("RDF parser"), items, m_database->scale().m_contentsLength);
+
+  measure(QSL("parse_rss"), [&rss]() {
+    return RssParser(rss).messages().size();
+  });
+  measure(QSL("parse_atom"), [&atom]() {
+    return AtomParser(atom).messages().size();
+  });
+  measure(QSL("parse_rdf"), [&rdf]() {
+    return RdfParser().parseXmlData(rdf).size();
+  });
+}
+
+void BenchmarkRunner::benchmarkIngest() {
+  const int account_id = m_database->accountId();
+  const QString url = QSL("http://bench.rssguard.invalid/ingest");
+  const QList<Message> messages = m_database->generator()->messages(url, 500, m_database->scale().m_contentsLength);
+  int feed_id = 0;
+
+  // Each iteration stores messages into brand new feed, which is removed afterwards.
+  auto add_feed = [this, account_id, &url, &feed_id]() {
+    feed_id = DatabaseQueries::addFeed(m_db, NO_PARENT_CATEGORY, account_id, QSL("Ingest"), QString(),
+                                       QDateTime::currentDateTime(), QIcon(), DEFAULT_FEED_ENCODING, url,
+                                       false, QString(), QString(), Feed::DontAutoUpdate, 0, StandardFeed::Rss2X);
+  };
+  auto ingest = [this, account_id, &url, &feed_id, &messages]() {
+    bool any_changed, ok;
+
+    return DatabaseQueries::updateMessages(m_db, messages, QString::number(feed_id), account_id, url, &any_changed, &ok);
+  };
+  auto delete_feed = [this, account_id, &feed_id]() {
+    DatabaseQueries::deleteFeed(m_db, feed_id, account_id);
+  };
+
+  measure(QSL("ingest_new"), ingest, add_feed, delete_feed);
+
+  // Messages which are already stored are recognized and skipped.
+  measure(QSL("ingest_unchanged"), [&messages, &ingest]() {
+    ingest();
+    return messages.size();
+  }, [&add_feed, &ingest]() {
+    add_feed();
+    ingest();
+  }, delete_feed);
+}
+
+void BenchmarkRunner::benchmarkCounts() {
+  const int account_id = m_database->accountId();
+  const QString feed_custom_id = QString::number(m_database->feedIds().first());
+  const QString category_custom_id = m_database->categoryIds().isEmpty()
+                                     ? QString::number(NO_PARENT_CATEGORY)
+                                     : QString::number(m_database->categoryIds().first());
+
+  measure(QSL("count_account"), [this, account_id]() {
+    return DatabaseQueries::getMessageCountsForAccount(m_db, account_id, true).size();
+  });
+  measure(QSL("count_category"), [this, account_id, &category_custom_id]() {
+    return DatabaseQueries::getMessageCountsForCategory(m_db, category_custom_id, account_id, true).size();
+  });
+  measure(QSL("count_feed"), [this, account_id, &feed_custom_id]() {
+    return DatabaseQueries::getMessageCountsForFeed(m_db, feed_custom_id, account_id, true);
+  });
+}
+
+void BenchmarkRunner::benchmarkModel() {
+  ServiceRoot* root = serviceRoot();
+
+  if (root == nullptr) {
+    qCritical("Service account of synthetic database is not loaded, skipping model benchmarks.");
+    return;
+  }
+
+  MessagesModel model;
+  MessagesProxyModel proxy(&model);
+  RootItem* feed = root->getSubTreeFeeds().first();
+  RootItem* category = root->getSubTreeCategories().isEmpty() ? feed : root->getSubTreeCategories().first();
+
+  measure(QSL("model_account"), [&model, root]() {
+    model.loadMessages(root);
+    return model.rowCount();
+  });
+  measure(QSL("model_category"), [&model, category]() {
+    model.loadMessages(category);
+    return model.rowCount();
+  });
+  measure(QSL("model_feed"), [&model, feed]() {
+    model.loadMessages(feed);
+    return model.rowCount();
+  });
+
+  model.loadMessages(root);
+  measure(QSL("search"), [&proxy]() {
+    proxy.setFilterRegExp(QSL("dolor sit"));
+    return proxy.rowCount();
+  }, Step(), [&proxy]() {
+    proxy.setFilterRegExp(QString());
+  });
+}
+
+void BenchmarkRunner::benchmarkModelRoles() {
+  ServiceRoot* root = serviceRoot();
+
+  if (root == nullptr) {
+    qCritical("Service account of synthetic database is not loaded, skipping model role benchmarks.");
+    return;
+  }
+
+  MessagesModel model;
+
+  // Whole account is loaded once, then roles which are queried by view
+  // when painting rows are read for all cells, like when scrolling through all messages.
+  model.loadMessages(root);
+
+  const int rows = model.rowCount();
+  const int columns = model.columnCount();
+  auto walk = [&model, rows, columns](int role) {
+    for (int row = 0; row < rows; row++) {
+      for (int column = 0; column < columns; column++) {
+        model.data(model.index(row, column), role);
+      }
+    }
+
+    return rows;
+  };
+
+  measure(QSL("model_role_font"), [&walk]() {
+    return walk(Qt::FontRole);
+  });
+  measure(QSL("model_role_foreground"), [&walk]() {
+    return walk(Qt::ForegroundRole);
+  });
+  measure(QSL("model_role_decoration"), [&walk]() {
+    return walk(Qt::DecorationRole);
+  });
+}
+
+void BenchmarkRunner::benchmarkRendering() {
+#if defined(USE_WEBENGINE)
+  const int items = 500;
+  QList<Message> messages = m_database->generator()->messages(QSL("http://bench.rssguard.invalid/render"), items,
+                                                              m_database->scale().m_contentsLength);
+
+  // Some messages have attachments, so that templates of enclosures are rendered too.
+  for (int i = 0; i < messages.size(); i += 5) {
+    messages[i].m_enclosures.append(Enclosure(messages.at(i).m_url + QSL("/image.png"), QSL("image/png")));
+    messages[i].m_enclosures.append(Enclosure(messages.at(i).m_url + QSL("/podcast.mp3"), QSL("audio/mpeg")));
+  }
+
+  // Templates are compiled when skin is loaded.
+  qApp->skins()->loadCurrentSkin();
+
+  measure(QSL("render_messages"), [&messages]() {
+    WebViewer::prepareMessagesLayout(messages, false);
+    return messages.size();
+  });
+  measure(QSL("render_messages_lazy"), [&messages]() {
+    WebViewer::prepareMessagesLayout(messages, true);
+    return messages.size();
+  });
+#else
+  if (m_prefix.isEmpty() || QSL("render_messages").startsWith(m_prefix)) {
+    qWarning("Application is built without WebEngine, skipping rendering benchmarks.");
+  }
+#endif
+}
+
+void BenchmarkRunner::benchmarkAdBlock() {
+#if defined(USE_WEBENGINE)
+  // Subscription stores compiled form of the list next to it, so bundled list
+  // is copied to writable location first.
+  const QString list_path = QDir(qApp->userDataFolder()).absoluteFilePath(QSL("bench-adblock.txt"));
+
+  QFile::remove(list_path);
+  QFile::copy(QSL(":/benchmark/data/adblock-rules.txt"), list_path);
+  QFile::setPermissions(list_path, QFile::ReadOwner | QFile::WriteOwner);
+
+  AdBlockSubscription subscription(QSL("Benchmark list"));
+
+  subscription.setFilePath(list_path);
+  subscription.loadSubscription(QStringList());
+
+  if (subscription.allRules().isEmpty()) {
+    qWarning("Cannot load bundled AdBlock list, skipping AdBlock benchmarks.");
+    return;
+  }
+
+  // Each line of corpus holds requested URL and host of page which requested it.
+  QFile corpus_file(QSL(":/benchmark/data/adblock-urls.txt"));
+  QList<AdBlockRequest> requests;
+
+  corpus_file.open(QIODevice::ReadOnly);
+
+  foreach (const QByteArray& line, corpus_file.readAll().split('\n')) {
+    const QList<QByteArray> parts = line.trimmed().split(' ');
+
+    if (parts.size() != 2) {
+      continue;
+    }
+
+    const QUrl url = QUrl::fromEncoded(parts.at(0));
+    const QString path = url.path();
+    QWebEngineUrlRequestInfo::ResourceType type = QWebEngineUrlRequestInfo::ResourceTypeOther;
+
+    if (path.endsWith(QL1S(".js"))) {
+      type = QWebEngineUrlRequestInfo::ResourceTypeScript;
+    }
+    else if (path.endsWith(QL1S(".png")) || path.endsWith(QL1S(".gif"))) {
+      type = QWebEngineUrlRequestInfo::ResourceTypeImage;
+    }
+    else if (path.endsWith(QL1S(".css"))) {
+      type = QWebEngineUrlRequestInfo::ResourceTypeStylesheet;
+    }
+    else if (path.endsWith(QL1S(".html"))) {
+      type = QWebEngineUrlRequestInfo::ResourceTypeSubFrame;
+    }
+
+    requests.append(AdBlockRequest(url, QUrl(QSL("http://") + QString::fromLatin1(parts.at(1)) + QL1C('/')), type));
+  }
+
+  // Domain and URL strings are prepared just like AdBlockManager does it for each request.
+  QStringList domains, urls;
+
+  foreach (const AdBlockRequest& request, requests) {
+    domains.append(request.m_requestUrl.host().toLower());
+    urls.append(QString::fromLatin1(request.m_requestUrl.toEncoded().toLower()));
+  }
+
+  AdBlockMatcher matcher(nullptr);
+
+  matcher.update(QList<AdBlockSubscription*>() << &subscription);
+
+  measure(QSL("adblock_match_indexed"), [&matcher, &requests, &domains, &urls]() {
+    int blocked = 0;
+
+    for (int i = 0; i < requests.size(); i++) {
+      if (matcher.match(requests.at(i), domains.at(i), urls.at(i)) != nullptr) {
+        blocked++;
+      }
+    }
+
+    return blocked;
+  });
+
+  // Baseline, all network rules are tried one by one without search tree and token index.
+  QVector<const AdBlockRule*> exception_rules, block_rules;
+
+  foreach (const AdBlockRule* rule, subscription.allRules()) {
+    if (rule->isInternalDisabled() || rule->isCssRule() || rule->isDocument() || rule->isElemhide()) {
+      continue;
+    }
+    else if (rule->isException()) {
+      exception_rules.append(rule);
+    }
+    else {
+      block_rules.append(rule);
+    }
+  }
+
+  measure(QSL("adblock_match_linear"), [&exception_rules, &block_rules, &requests, &domains, &urls]() {
+    int blocked = 0;
+
+    for (int i = 0; i < requests.size(); i++) {
+      auto matches = [&](const AdBlockRule* rule) {
+        return rule->networkMatch(requests.at(i), domains.at(i), urls.at(i));
+      };
+
+      if (std::none_of(exception_rules.constBegin(), exception_rules.constEnd(), matches) &&
+          std::any_of(block_rules.constBegin(), block_rules.constEnd(), matches)) {
+        blocked++;
+      }
+    }
+
+    return blocked;
+  });
+#else
+  if (m_prefix.isEmpty() || QSL("adblock_match").startsWith(m_prefix)) {
+    qWarning("Application is built without WebEngine, skipping AdBlock benchmarks.");
+  }
+#endif
+}
+
+void BenchmarkRunner::benchmarkBulkOperations() {
+  const int account_id = m_database->accountId();
+  QStringList unread_ids;
+  QStringList feed_ids;
+  QSqlQuery q(m_db);
+
+  q.setForwardOnly(true);
+  q.prepare(QSL("SELECT id FROM Messages WHERE is_read = 0 AND is_deleted = 0 AND is_pdeleted = 0 AND account_id = :account_id LIMIT 10000;"));
+  q.bindValue(QSL(":account_id"), account_id);
+
+  if (q.exec()) {
+    while (q.next()) {
+      unread_ids.append(q.value(0).toString());
+    }
+  }
+
+  foreach (int feed_id, m_database->feedIds()) {
+    feed_ids.append(QString::number(feed_id));
+  }
+
+  // Bulk operations are measured inside transaction which is rolled back,
+  // so that each iteration starts with the same data.
+  const Step begin = [this]() {
+    m_db.transaction();
+  };
+  const Step rollback = [this]() {
+    m_db.rollback();
+  };
+  const int read_messages = countMessages(QSL("is_read = 1 AND is_deleted = 0 AND is_important = 0"));
+  const int old_messages = countMessages(QSL("is_important = 0 AND date_created < %1")
+                                         .arg(QDateTime::currentDateTime().addDays(-30).toMSecsSinceEpoch()));
+
+  measure(QSL("bulk_mark_read"), [this, &unread_ids]() {
+    DatabaseQueries::markMessagesReadUnread(m_db, unread_ids, RootItem::Read);
+    return unread_ids.size();
+  }, begin, rollback);
+  measure(QSL("bulk_mark_feeds_read"), [this, account_id, &feed_ids]() {
+    DatabaseQueries::markFeedsReadUnread(m_db, feed_ids, account_id, RootItem::Read);
+    return feed_ids.size();
+  }, begin, rollback);
+  measure(QSL("bulk_purge_read"), [this, read_messages]() {
+    DatabaseQueries::purgeReadMessages(m_db);
+    return read_messages;
+  }, begin, rollback);
+  measure(QSL("bulk_purge_old"), [this, old_messages]() {
+    DatabaseQueries::purgeOldMessages(m_db, 30);
+    return old_messages;
+  }, begin, rollback);
+}
+
+int BenchmarkRunner::countMessages(const QString& condition) const {
+  QSqlQuery q(m_db);
+
+  q.setForwardOnly(true);
+
+  if (q.exec(QSL("SELECT count(*) FROM Messages WHERE account_id = %1 AND %2;").arg(QString::number(m_database->accountId()),
+                                                                                     condition)) && q.next()) {
+    return q.value(0).toInt();
+  }
+  else {
+    qWarning("Counting of messages failed: '%s'.", qPrintable(q.lastError().text()));
+    return 0;
+  }
+}
+
+ServiceRoot* BenchmarkRunner::serviceRoot() const {
+  foreach (ServiceRoot* root, qApp->feedReader()->feedsModel()->serviceRoots()) {
+    if (root->accountId() == m_database->accountId()) {
+      return root;
+    }
+  }
+
+  return nullptr;
+}
@@ -0,0 +1,70 @@
+// This file is part of RSS Guard.
+
+//
+// Copyright (C) 2011-2017 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+#ifndef BENCHMARKRUNNER_H
+#define BENCHMARKRUNNER_H
+
+#include <QJsonObject>
+#include <QSqlDatabase>
+#include <QVector>
+
+#include <functional>
+
+class ServiceRoot;
+class SyntheticDatabase;
+
+// Runs benchmarks of core operations against synthetic database.
+// Result of each benchmark is printed to standard output as single JSON line.
+class BenchmarkRunner {
+  public:
+    explicit BenchmarkRunner(SyntheticDatabase* database, int iterations);
+
+    // Runs benchmarks whose names start with given prefix, all of them if prefix is empty.
+    void run(const QString& prefix = QString());
+
+    // Returns min/median/mean/max and tail percentiles of given times, keys are suffixed with "_ms".
+    static QJsonObject timings(QVector<double> times_ms);
+
+    static void print(const QJsonObject& result);
+
+  private:
+    // Operation returns number of processed items, only operation itself is measured.
+    typedef std::function<int()> Operation;
+    typedef std::function<void()> Step;
+
+    void measure(const QString& name, const Operation& operation,
+                 const Step& setup = Step(), const Step& cleanup = Step());
+
+    void benchmarkParsers();
+    void benchmarkIngest();
+    void benchmarkCounts();
+    void benchmarkModel();
+    void benchmarkModelRoles();
+    void benchmarkRendering();
+    void benchmarkAdBlock();
+    void benchmarkBulkOperations();
+
+    int countMessages(const QString& condition) const;
+    ServiceRoot* serviceRoot() const;
+
+    SyntheticDatabase* m_database;
+    QSqlDatabase m_db;
+    int m_iterations;
+    QString m_prefix;
+};
+
+#endif // BENCHMARKRUNNER_H
@@ -0,0 +1,266 @@
+// This file is part of RSS Guard.
+
+//
+// Copyright (C) 2011-2017 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+#include "benchmarkrunner.h"
+#include "mockfeedserver.h"
+#include "syntheticdatabase.h"
+#include "updateharness.h"
+
+#include "core/feedsmodel.h"
+#include "core/message.h"
+#include "definitions/definitions.h"
+#include "miscellaneous/application.h"
+#include "miscellaneous/databasefactory.h"
+#include "miscellaneous/debugging.h"
+#include "miscellaneous/feedreader.h"
+#include "services/abstract/rootitem.h"
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QThread>
+#include <QTimer>
+
+int main(int argc, char* argv[]) {
+  const bool update_mode = argc > 1 && QString::fromLocal8Bit(argv[1]) == QL1S("update");
+  QString work_folder = QDir::tempPath() + QDir::separator() + QSL(APP_LOW_NAME "-bench");
+  QString prefix;
+  QStringList services = QStringList() << QSL(SERVICE_CODE_STD_RSS) << QSL(SERVICE_CODE_TT_RSS) << QSL(SERVICE_CODE_OWNCLOUD);
+  SyntheticScale scale;
+  MockServerOptions server_options;
+  int iterations = 5;
+  int rounds = 2;
+  quint16 port = 0;
+  quint32 seed = 1;
+  bool keep = false;
+
+  for (int i = update_mode ? 2 : 1; i < argc; i++) {
+    const QString str = QString::fromLocal8Bit(argv[i]);
+    const QString value = i + 1 < argc ? QString::fromLocal8Bit(argv[i + 1]) : QString();
+
+    if (str == QL1S("-h")) {
+      qDebug("Usage: rssguard-bench [OPTIONS]\n"
+             "       rssguard-bench update [OPTIONS]\n\n"
+             "First form runs benchmarks of core operations against generated database.\n"
+             "Second form starts local mock feed server and measures full update rounds of feeds.\n\n"
+             "Option\t\t\tMeaning\n"
+             "-h\t\t\tDisplays this help.\n"
+             "--work-dir DIR\t\tFolder for generated profiles, defaults to \"%s\".\n"
+             "--keep\t\t\tKeeps generated profile, database is then reused by next run of benchmarks.\n"
+             "--categories N\t\tNumber of categories, defaults to %d (%d for update).\n"
+             "--feeds N\t\tNumber of feeds, defaults to %d (%d for update).\n"
+             "--seed N\t\tSeed of generated data, defaults to %u.\n\n"
+             "Benchmarks:\n"
+             "--messages N\t\tNumber of generated messages, defaults to %d.\n"
+             "--read-ratio R\t\tRatio of read messages, defaults to %.2f.\n"
+             "--iterations N\t\tNumber of iterations of each benchmark, defaults to %d.\n"
+             "--only PREFIX\t\tRuns only benchmarks whose names start with PREFIX.\n\n"
+             "Update:\n"
+             "--services LIST\t\tComma-separated services to update, defaults to \"%s\".\n"
+             "--rounds N\t\tNumber of update rounds, defaults to %d.\n"
+             "--items N\t\tNumber of messages in each feed, defaults to %d.\n"
+             "--latency MS\t\tDelay of each response, defaults to %d.\n"
+             "--jitter MS\t\tMaximal random extra delay of each response, defaults to %d.\n"
+             "--bandwidth B\t\tBytes per second for each connection, zero is unlimited, defaults to %d.\n"
+             "--error-rate R\t\tRatio of failing requests for feeds, defaults to %.2f.\n"
+             "--redirect-rate R\tRatio of redirected requests for feeds, defaults to %.2f.\n"
+             "--port N\t\tPort of mock server, random free port is used by default.",
+             qPrintable(QDir::toNativeSeparators(work_folder)), scale.m_categories, server_options.m_categories,
+             scale.m_feeds, server_options.m_feeds, seed, scale.m_messages, scale.m_readRatio, iterations,
+             qPrintable(services.join(QL1C(','))), rounds, server_options.m_itemsPerFeed, server_options.m_latency,
+             server_options.m_latencyJitter, server_options.m_bandwidth, server_options.m_errorRate,
+             server_options.m_redirectRate);
+      return EXIT_SUCCESS;
+    }
+    else if (str == QL1S("--keep")) {
+      keep = true;
+      continue;
+    }
+    else if (value.isEmpty()) {
+      qWarning("Unknown option or missing value: '%s'.", qPrintable(str));
+      return EXIT_FAILURE;
+    }
+    else if (str == QL1S("--work-dir")) {
+      work_folder = value;
+    }
+    else if (str == QL1S("--categories")) {
+      scale.m_categories = server_options.m_categories = qMax(0, value.toInt());
+    }
+    else if (str == QL1S("--feeds")) {
+      scale.m_feeds = server_options.m_feeds = qMax(1, value.toInt());
+    }
+    else if (str == QL1S("--seed")) {
+      seed = server_options.m_seed = value.toUInt();
+    }
+    else if (str == QL1S("--messages")) {
+      scale.m_messages = qMax(0, value.toInt());
+    }
+    else if (str == QL1S("--read-ratio")) {
+      scale.m_readRatio = qBound(0.0, value.toDouble(), 1.0);
+    }
+    else if (str == QL1S("--iterations")) {
+      iterations = qMax(1, value.toInt());
+    }
+    else if (str == QL1S("--only")) {
+      prefix = value;
+    }
+    else if (str == QL1S("--services")) {
+      services = value.split(QL1C(','), QString::SkipEmptyParts);
+    }
+    else if (str == QL1S("--rounds")) {
+      rounds = qMax(1, value.toInt());
+    }
+    else if (str == QL1S("--items")) {
+      server_options.m_itemsPerFeed = qMax(0, value.toInt());
+    }
+    else if (str == QL1S("--latency")) {
+      server_options.m_latency = qMax(0, value.toInt());
+    }
+    else if (str == QL1S("--jitter")) {
+      server_options.m_latencyJitter = qMax(0, value.toInt());
+    }
+    else if (str == QL1S("--bandwidth")) {
+      server_options.m_bandwidth = qMax(0, value.toInt());
+    }
+    else if (str == QL1S("--error-rate")) {
+      server_options.m_errorRate = qBound(0.0, value.toDouble(), 1.0);
+    }
+    else if (str == QL1S("--redirect-rate")) {
+      server_options.m_redirectRate = qBound(0.0, value.toDouble(), 1.0);
+    }
+    else if (str == QL1S("--port")) {
+      port = quint16(value.toUInt());
+    }
+    else {
+      qWarning("Unknown option: '%s'.", qPrintable(str));
+      return EXIT_FAILURE;
+    }
+
+    i++;
+  }
+
+  // Benchmark never touches real user profile, settings and database
+  // are located via home folder, which is redirected to work folder.
+  // Accounts of update harness point to mock server with random port, so they are always fresh.
+  const QString profile_folder = QDir(work_folder).absoluteFilePath(update_mode ? QSL("profile-update") : QSL("profile"));
+
+  if (update_mode) {
+    QDir(profile_folder).removeRecursively();
+  }
+
+  if (!QDir().mkpath(profile_folder)) {
+    qCritical("Cannot create profile folder '%s'.", qPrintable(profile_folder));
+    return EXIT_FAILURE;
+  }
+
+  qputenv("HOME", QFile::encodeName(profile_folder));
+  qputenv("XDG_CONFIG_HOME", QFile::encodeName(profile_folder + QSL("/config")));
+  qputenv("XDG_DATA_HOME", QFile::encodeName(profile_folder + QSL("/data")));
+  qputenv("QT_QPA_PLATFORM", "offscreen");
+
+  qInstallMessageHandler(Debugging::debugHandler);
+  Debugging::setLoggingRules(QSL("*.debug=false"));
+
+  int exit_code;
+
+  {
+    Application application(QSL(APP_LOW_NAME "-bench"), argc, argv, true);
+
+    application.setFeedReader(new FeedReader(&application));
+    qRegisterMetaType<QList<Message>>("QList<Message>");
+    qRegisterMetaType<QList<RootItem*>>("QList<RootItem*>");
+
+    if (update_mode) {
+      // Server has its own thread, so that serving does not compete with application event loop.
+      QThread server_thread;
+      MockFeedServer* server = new MockFeedServer(server_options);
+      bool listening = false;
+
+      server->moveToThread(&server_thread);
+      QObject::connect(&server_thread, &QThread::finished, server, &QObject::deleteLater);
+      server_thread.start();
+      QMetaObject::invokeMethod(server, "start", Qt::BlockingQueuedConnection,
+                                Q_RETURN_ARG(bool, listening), Q_ARG(quint16, port));
+
+      if (listening) {
+        UpdateHarness harness(server, server_options.m_feeds, server_options.m_categories, services, rounds);
+        QJsonObject info;
+
+        info[QSL("event")] = QSL("server");
+        info[QSL("url")] = server->baseUrl();
+        info[QSL("feeds")] = server_options.m_feeds;
+        info[QSL("items")] = server_options.m_itemsPerFeed;
+        info[QSL("latency_ms")] = server_options.m_latency;
+        info[QSL("jitter_ms")] = server_options.m_latencyJitter;
+        info[QSL("bandwidth")] = server_options.m_bandwidth;
+        info[QSL("error_rate")] = server_options.m_errorRate;
+        info[QSL("redirect_rate")] = server_options.m_redirectRate;
+        BenchmarkRunner::print(info);
+
+        QTimer::singleShot(0, &harness, &UpdateHarness::start);
+        exit_code = Application::exec();
+      }
+      else {
+        exit_code = EXIT_FAILURE;
+      }
+
+      server_thread.quit();
+      server_thread.wait();
+    }
+    else {
+      SyntheticDatabase database(scale, seed);
+
+      // Benchmarks run inside event loop, so that application cleans up as usual when it quits.
+      QTimer::singleShot(0, &application, [&database, iterations, seed, &prefix]() {
+        QElapsedTimer timer;
+        bool generated;
+
+        timer.start();
+
+        if (!database.prepare(qApp->database()->connection(QSL("Benchmark"), DatabaseFactory::FromSettings), &generated)) {
+          qCritical("Synthetic database could not be prepared.");
+          qApp->exit(EXIT_FAILURE);
+          return;
+        }
+
+        QJsonObject info;
+
+        info[QSL("event")] = QSL("database");
+        info[QSL("generated")] = generated;
+        info[QSL("categories")] = database.scale().m_categories;
+        info[QSL("feeds")] = database.scale().m_feeds;
+        info[QSL("messages")] = database.scale().m_messages;
+        info[QSL("read_ratio")] = database.scale().m_readRatio;
+        info[QSL("seed")] = qint64(seed);
+        info[QSL("ms")] = timer.elapsed();
+        BenchmarkRunner::print(info);
+
+        qApp->feedReader()->feedsModel()->loadActivatedServiceAccounts();
+        BenchmarkRunner(&database, iterations).run(prefix);
+        qApp->exit(EXIT_SUCCESS);
+      });
+
+      exit_code = Application::exec();
+    }
+  }
+
+  if (!keep) {
+    QDir(profile_folder).removeRecursively();
+  }
+
+  return exit_code;
+}
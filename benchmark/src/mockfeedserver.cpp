@@ -0,0 +1,629 @@
+// This file is part of RSS Guard.
+
+//
+// Copyright (C) 2011-2017 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+#include "mockfeedserver.h"
+
+#include "definitions/definitions.h"
+#include "services/tt-rss/definitions.h"
+
+#include <QJsonDocument>
+#include <QRegularExpression>
+#include <QTcpSocket>
+#include <QTimer>
+
+#define MOCK_TTRSS_PATH         "/tt-rss/api/"
+#define MOCK_TTRSS_SESSION      "mock-session"
+#define MOCK_TTRSS_API_LEVEL    14
+#define MOCK_NEXTCLOUD_PATH     "/nextcloud/index.php/apps/news/api/v1-2/"
+#define MOCK_INOREADER_PATH     "/inoreader/reader/api/0/"
+#define MOCK_INOREADER_USER     "user/1005921515/"
+#define MOCK_REDIRECTED_PATH    "/redirected"
+#define MOCK_THROTTLE_INTERVAL  50
+
+MockFeedServer::MockFeedServer(const MockServerOptions& options, QObject* parent)
+  : QTcpServer(parent), m_options(options), m_random(options.m_seed), m_requestCount(0),
+  m_throttleTimer(new QTimer(this)) {
+  m_throttleTimer->setInterval(MOCK_THROTTLE_INTERVAL);
+  connect(m_throttleTimer, &QTimer::timeout, this, &MockFeedServer::writePending);
+}
+
+MockFeedServer::~MockFeedServer() {}
+
+QString MockFeedServer::baseUrl() const {
+  return QSL("http://127.0.0.1:%1").arg(serverPort());
+}
+
+QString MockFeedServer::feedPath(int feed_id) const {
+  return QSL("/feeds/%1.%2").arg(QString::number(feed_id), SyntheticFeeds::formatName(feedFormat(feed_id)));
+}
+
+int MockFeedServer::requestCount() const {
+  return m_requestCount.load();
+}
+
+bool MockFeedServer::start(quint16 port) {
+  if (!listen(QHostAddress::LocalHost, port)) {
+    qCritical("Mock feed server cannot listen on port %d: '%s'.", port, qPrintable(errorString()));
+    return false;
+  }
+
+  if (m_options.m_bandwidth > 0) {
+    m_throttleTimer->start();
+  }
+
+  return true;
+}
+
+void MockFeedServer::incomingConnection(qintptr socket_descriptor) {
+  QTcpSocket* socket = new QTcpSocket(this);
+
+  if (!socket->setSocketDescriptor(socket_descriptor)) {
+    delete socket;
+    return;
+  }
+
+  connect(socket, &QTcpSocket::readyRead, this, &MockFeedServer::readRequest);
+  connect(socket, &QTcpSocket::disconnected, this, &MockFeedServer::removeSocket);
+}
+
+void MockFeedServer::readRequest() {
+  QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
+  QByteArray request = m_requests.value(socket) + socket->readAll();
+  const int header_end = request.indexOf("\r\n\r\n");
+
+  if (header_end < 0) {
+    m_requests.insert(socket, request);
+    return;
+  }
+
+  const QList<QByteArray> lines = request.left(header_end).split('\n');
+  const QList<QByteArray> request_line = lines.first().trimmed().split(' ');
+  int content_length = 0;
+
+  foreach (const QByteArray& line, lines.mid(1)) {
+    const int colon = line.indexOf(':');
+
+    if (colon > 0 && line.left(colon).trimmed().toLower() == "content-length") {
+      content_length = line.mid(colon + 1).trimmed().toInt();
+    }
+  }
+
+  if (request.size() < header_end + 4 + content_length) {
+    m_requests.insert(socket, request);
+    return;
+  }
+
+  // Whole request is here, nothing else is read from this connection.
+  disconnect(socket, &QTcpSocket::readyRead, this, &MockFeedServer::readRequest);
+  m_requests.remove(socket);
+  m_requestCount.ref();
+
+  const Response response = request_line.size() < 2
+                            ? errorResponse(400)
+                            : route(request_line.at(0), QUrl(QString::fromLatin1(request_line.at(1))),
+                                    request.mid(header_end + 4, content_length));
+  const int delay = m_options.m_latency + m_random.bounded(m_options.m_latencyJitter + 1);
+
+  if (delay > 0) {
+    QTimer::singleShot(delay, socket, [this, socket, response]() {
+      respond(socket, response);
+    });
+  }
+  else {
+    respond(socket, response);
+  }
+}
+
+void MockFeedServer::writePending() {
+  const int chunk_size = qMax(1, m_options.m_bandwidth * MOCK_THROTTLE_INTERVAL / 1000);
+  QMutableHashIterator<QTcpSocket*, QByteArray> i(m_pending);
+
+  while (i.hasNext()) {
+    i.next();
+    i.key()->write(i.value().left(chunk_size));
+    i.value().remove(0, chunk_size);
+
+    if (i.value().isEmpty()) {
+      i.key()->disconnectFromHost();
+      i.remove();
+    }
+  }
+}
+
+void MockFeedServer::removeSocket() {
+  QTcpSocket* socket = qobject_cast<QTcpSocket*>(sender());
+
+  m_requests.remove(socket);
+  m_pending.remove(socket);
+  socket->deleteLater();
+}
+
+MockFeedServer::Response MockFeedServer::route(const QByteArray& method, const QUrl& url, const QByteArray& body) {
+  QString path = url.path(QUrl::FullyDecoded);
+  const bool redirected = path.startsWith(QL1S(MOCK_REDIRECTED_PATH "/"));
+
+  if (redirected) {
+    path = path.mid(int(sizeof(MOCK_REDIRECTED_PATH)) - 1);
+  }
+
+  if (path.startsWith(QL1S("/feeds/"))) {
+    if (!redirected && method == "GET" && chance(m_options.m_redirectRate)) {
+      Response response;
+
+      response.m_status = 302;
+      response.m_location = (baseUrl() + QSL(MOCK_REDIRECTED_PATH) + url.toString(QUrl::FullyEncoded)).toUtf8();
+      return response;
+    }
+    else if (chance(m_options.m_errorRate)) {
+      return errorResponse(503);
+    }
+    else {
+      return feedDocument(path.mid(7));
+    }
+  }
+  else if (path == QL1S(MOCK_TTRSS_PATH) && method == "POST") {
+    return ttRss(body);
+  }
+  else if (path.startsWith(QL1S(MOCK_NEXTCLOUD_PATH))) {
+    return nextcloud(path.mid(int(sizeof(MOCK_NEXTCLOUD_PATH)) - 1), QUrlQuery(url));
+  }
+  else if (path.startsWith(QL1S(MOCK_INOREADER_PATH))) {
+    return inoreader(path.mid(int(sizeof(MOCK_INOREADER_PATH)) - 1), QUrlQuery(url));
+  }
+  else {
+    return errorResponse(404);
+  }
+}
+
+void MockFeedServer::respond(QTcpSocket* socket, const Response& response) {
+  QByteArray reason;
+
+  switch (response.m_status) {
+    case 200:
+      reason = "OK";
+      break;
+
+    case 302:
+      reason = "Found";
+      break;
+
+    case 400:
+      reason = "Bad Request";
+      break;
+
+    case 404:
+      reason = "Not Found";
+      break;
+
+    default:
+      reason = "Service Unavailable";
+      break;
+  }
+
+  QByteArray data = "HTTP/1.1 " + QByteArray::number(response.m_status) + ' ' + reason + "\r\n"
+                    "Content-Type: " + response.m_contentType + "\r\n"
+                    "Content-Length: " + QByteArray::number(response.m_body.size()) + "\r\n"
+                    "Connection: close\r\n";
+
+  if (!response.m_location.isEmpty()) {
+    data += "Location: " + response.m_location + "\r\n";
+  }
+
+  data += "\r\n" + response.m_body;
+
+  if (m_options.m_bandwidth > 0) {
+    m_pending[socket] += data;
+  }
+  else {
+    socket->write(data);
+    socket->disconnectFromHost();
+  }
+}
+
+MockFeedServer::Response MockFeedServer::feedDocument(const QString& file_name) {
+  bool ok;
+  const int dot = file_name.indexOf(QL1C('.'));
+  const int feed_id = file_name.left(dot).toInt(&ok);
+
+  if (dot < 0 || !ok || !isValidFeed(feed_id) || file_name.mid(dot + 1) != SyntheticFeeds::formatName(feedFormat(feed_id))) {
+    return errorResponse(404);
+  }
+
+  if (!m_documents.contains(feed_id)) {
+    SyntheticFeeds generator(m_options.m_seed + quint32(feed_id) * 2654435761u);
+
+    m_documents.insert(feed_id, generator.document(feedFormat(feed_id), baseUrl() + QSL("/feeds/%1").arg(feed_id),
+                                                   QSL("Feed %1").arg(feed_id), m_options.m_itemsPerFeed,
+                                                   m_options.m_contentsLength));
+  }
+
+  Response response;
+
+  switch (feedFormat(feed_id)) {
+    case SyntheticFeeds::Atom:
+      response.m_contentType = "application/atom+xml; charset=utf-8";
+      break;
+
+    case SyntheticFeeds::Rdf:
+      response.m_contentType = "application/rdf+xml; charset=utf-8";
+      break;
+
+    case SyntheticFeeds::Rss:
+    default:
+      response.m_contentType = "application/rss+xml; charset=utf-8";
+      break;
+  }
+
+  response.m_body = m_documents.value(feed_id);
+  return response;
+}
+
+MockFeedServer::Response MockFeedServer::ttRss(const QByteArray& body) {
+  const QJsonObject request = QJsonDocument::fromJson(body).object();
+  const QString op = request[QSL("op")].toString();
+  QJsonObject content;
+
+  if (op == QL1S("login")) {
+    content[QSL("session_id")] = QSL(MOCK_TTRSS_SESSION);
+    content[QSL("api_level")] = MOCK_TTRSS_API_LEVEL;
+    return jsonResponse(ttRssResult(TTRSS_API_STATUS_OK, content));
+  }
+  else if (request[QSL("sid")].toString() != QL1S(MOCK_TTRSS_SESSION)) {
+    content[QSL("error")] = QSL(TTRSS_NOT_LOGGED_IN);
+    return jsonResponse(ttRssResult(TTRSS_API_STATUS_ERR, content));
+  }
+  else if (op == QL1S("logout")) {
+    content[QSL("status")] = QSL("OK");
+  }
+  else if (op == QL1S("isLoggedIn")) {
+    content[QSL("status")] = true;
+  }
+  else if (op == QL1S("getApiLevel")) {
+    content[QSL("level")] = MOCK_TTRSS_API_LEVEL;
+  }
+  else if (op == QL1S("getFeedTree")) {
+    QHash<int, QJsonArray> category_feeds;
+    QJsonArray categories;
+    QJsonObject tree;
+
+    for (int feed_id = 1; feed_id <= m_options.m_feeds; feed_id++) {
+      QJsonObject feed;
+
+      feed[QSL("id")] = QSL("FEED:%1").arg(feed_id);
+      feed[QSL("bare_id")] = feed_id;
+      feed[QSL("name")] = QSL("Feed %1").arg(feed_id);
+      feed[QSL("icon")] = false;
+      category_feeds[feedCategory(feed_id)].append(feed);
+    }
+
+    // Category with zero ID contains uncategorized feeds.
+    for (int category_id = 0; category_id <= m_options.m_categories; category_id++) {
+      QJsonObject category;
+
+      category[QSL("id")] = QSL("CAT:%1").arg(category_id);
+      category[QSL("bare_id")] = category_id;
+      category[QSL("type")] = QSL(TTRSS_GFT_TYPE_CATEGORY);
+      category[QSL("name")] = category_id == 0 ? QSL("Uncategorized") : QSL("Category %1").arg(category_id);
+      category[QSL("items")] = category_feeds.value(category_id);
+      categories.append(category);
+    }
+
+    tree[QSL("identifier")] = QSL("id");
+    tree[QSL("label")] = QSL("name");
+    tree[QSL("items")] = categories;
+    content[QSL("categories")] = tree;
+  }
+  else if (op == QL1S("getHeadlines")) {
+    const int feed_id = request[QSL("feed_id")].toInt();
+
+    if (!isValidFeed(feed_id)) {
+      content[QSL("error")] = QSL(TTRSS_INCORRECT_USAGE);
+      return jsonResponse(ttRssResult(TTRSS_API_STATUS_ERR, content));
+    }
+    else if (chance(m_options.m_errorRate)) {
+      return errorResponse(503);
+    }
+    else {
+      return jsonResponse(ttRssResult(TTRSS_API_STATUS_OK,
+                                      ttRssHeadlines(feed_id, request[QSL("skip")].toInt(), request[QSL("limit")].toInt())));
+    }
+  }
+  else if (op == QL1S("updateArticle")) {
+    content[QSL("status")] = QSL("OK");
+    content[QSL("updated")] = request[QSL("article_ids")].toString().split(QL1C(','), QString::SkipEmptyParts).size();
+  }
+  else {
+    content[QSL("error")] = QSL(TTRSS_UNKNOWN_METHOD);
+    return jsonResponse(ttRssResult(TTRSS_API_STATUS_ERR, content));
+  }
+
+  return jsonResponse(ttRssResult(TTRSS_API_STATUS_OK, content));
+}
+
+MockFeedServer::Response MockFeedServer::nextcloud(const QString& endpoint, const QUrlQuery& query) {
+  QJsonObject result;
+
+  if (endpoint == QL1S("status")) {
+    result[QSL("version")] = QSL("11.0.5");
+  }
+  else if (endpoint == QL1S("version")) {
+    result[QSL("version")] = QSL("11.0.5");
+  }
+  else if (endpoint == QL1S("user")) {
+    result[QSL("userId")] = QSL("bench");
+    result[QSL("displayName")] = QSL("Benchmark");
+  }
+  else if (endpoint == QL1S("folders")) {
+    QJsonArray folders;
+
+    for (int category_id = 1; category_id <= m_options.m_categories; category_id++) {
+      QJsonObject folder;
+
+      folder[QSL("id")] = category_id;
+      folder[QSL("name")] = QSL("Category %1").arg(category_id);
+      folders.append(folder);
+    }
+
+    result[QSL("folders")] = folders;
+  }
+  else if (endpoint == QL1S("feeds")) {
+    QJsonArray feeds;
+
+    for (int feed_id = 1; feed_id <= m_options.m_feeds; feed_id++) {
+      QJsonObject feed;
+
+      feed[QSL("id")] = feed_id;
+      feed[QSL("url")] = baseUrl() + feedPath(feed_id);
+      feed[QSL("link")] = baseUrl() + feedPath(feed_id);
+      feed[QSL("title")] = QSL("Feed %1").arg(feed_id);
+      feed[QSL("faviconLink")] = QString();
+      feed[QSL("folderId")] = feedCategory(feed_id);
+      feed[QSL("unreadCount")] = m_options.m_itemsPerFeed;
+      feeds.append(feed);
+    }
+
+    result[QSL("feeds")] = feeds;
+    result[QSL("starredCount")] = 0;
+  }
+  else if (endpoint == QL1S("items")) {
+    const int feed_id = query.queryItemValue(QSL("id")).toInt();
+
+    if (!isValidFeed(feed_id)) {
+      return errorResponse(404);
+    }
+    else if (chance(m_options.m_errorRate)) {
+      return errorResponse(503);
+    }
+
+    result[QSL("items")] = nextcloudItems(feed_id);
+  }
+
+  // Other endpoints only change state of items, which is not tracked.
+  return jsonResponse(result);
+}
+
+MockFeedServer::Response MockFeedServer::inoreader(const QString& endpoint, const QUrlQuery& query) {
+  QJsonObject result;
+
+  if (endpoint == QL1S("tag/list")) {
+    QJsonArray tags;
+    QJsonObject starred;
+
+    starred[QSL("id")] = QSL(MOCK_INOREADER_USER "state/com.google/starred");
+    tags.append(starred);
+
+    for (int category_id = 1; category_id <= m_options.m_categories; category_id++) {
+      QJsonObject tag;
+
+      tag[QSL("id")] = QSL(MOCK_INOREADER_USER "label/Category %1").arg(category_id);
+      tags.append(tag);
+    }
+
+    result[QSL("tags")] = tags;
+  }
+  else if (endpoint == QL1S("subscription/list")) {
+    QJsonArray subscriptions;
+
+    for (int feed_id = 1; feed_id <= m_options.m_feeds; feed_id++) {
+      QJsonObject subscription;
+      QJsonArray categories;
+
+      if (feedCategory(feed_id) > 0) {
+        QJsonObject category;
+
+        category[QSL("id")] = QSL(MOCK_INOREADER_USER "label/Category %1").arg(feedCategory(feed_id));
+        category[QSL("label")] = QSL("Category %1").arg(feedCategory(feed_id));
+        categories.append(category);
+      }
+
+      subscription[QSL("id")] = QSL("feed/") + baseUrl() + feedPath(feed_id);
+      subscription[QSL("title")] = QSL("Feed %1").arg(feed_id);
+      subscription[QSL("categories")] = categories;
+      subscription[QSL("url")] = baseUrl() + feedPath(feed_id);
+      subscription[QSL("htmlUrl")] = baseUrl() + feedPath(feed_id);
+      subscription[QSL("iconUrl")] = QString();
+      subscriptions.append(subscription);
+    }
+
+    result[QSL("subscriptions")] = subscriptions;
+  }
+  else if (endpoint.startsWith(QL1S("stream/contents/"))) {
+    const QRegularExpressionMatch match = QRegularExpression(QSL("/feeds/(\\d+)\\.")).match(endpoint);
+    const int feed_id = match.hasMatch() ? match.captured(1).toInt() : 0;
+    const int limit = query.hasQueryItem(QSL("n")) ? query.queryItemValue(QSL("n")).toInt() : m_options.m_itemsPerFeed;
+
+    if (!isValidFeed(feed_id)) {
+      return errorResponse(404);
+    }
+    else if (chance(m_options.m_errorRate)) {
+      return errorResponse(503);
+    }
+
+    result[QSL("items")] = inoreaderItems(feed_id, limit);
+  }
+  else if (endpoint == QL1S("edit-tag")) {
+    Response response;
+
+    response.m_contentType = "text/plain; charset=utf-8";
+    response.m_body = "OK";
+    return response;
+  }
+  else {
+    return errorResponse(404);
+  }
+
+  return jsonResponse(result);
+}
+
+QJsonObject MockFeedServer::ttRssResult(int status, const QJsonValue& content) const {
+  QJsonObject result;
+
+  result[QSL("seq")] = 0;
+  result[QSL("status")] = status;
+  result[QSL("content")] = content;
+  return result;
+}
+
+QJsonArray MockFeedServer::ttRssHeadlines(int feed_id, int skip, int limit) {
+  const QList<Message>& messages = feedMessages(feed_id);
+  QJsonArray headlines;
+
+  for (int i = qMax(skip, 0); i < messages.size() && i < skip + limit; i++) {
+    const Message& message = messages.at(i);
+    QJsonObject headline;
+
+    headline[QSL("id")] = feed_id * 100000 + i + 1;
+    headline[QSL("feed_id")] = QString::number(feed_id);
+    headline[QSL("title")] = message.m_title;
+    headline[QSL("link")] = message.m_url;
+    headline[QSL("author")] = message.m_author;
+    headline[QSL("content")] = message.m_contents;
+    headline[QSL("updated")] = message.m_created.toSecsSinceEpoch();
+    headline[QSL("unread")] = true;
+    headline[QSL("marked")] = false;
+    headline[QSL("attachments")] = QJsonArray();
+    headlines.append(headline);
+  }
+
+  return headlines;
+}
+
+QJsonArray MockFeedServer::nextcloudItems(int feed_id) {
+  const QList<Message>& messages = feedMessages(feed_id);
+  QJsonArray items;
+
+  for (int i = 0; i < messages.size(); i++) {
+    const Message& message = messages.at(i);
+    QJsonObject item;
+
+    item[QSL("id")] = feed_id * 100000 + i + 1;
+    item[QSL("guid")] = message.m_url;
+    item[QSL("guidHash")] = QString::number(feed_id * 100000 + i + 1);
+    item[QSL("url")] = message.m_url;
+    item[QSL("title")] = message.m_title;
+    item[QSL("author")] = message.m_author;
+    item[QSL("pubDate")] = message.m_created.toSecsSinceEpoch();
+    item[QSL("lastModified")] = message.m_created.toSecsSinceEpoch();
+    item[QSL("body")] = message.m_contents;
+    item[QSL("enclosureMime")] = QJsonValue();
+    item[QSL("enclosureLink")] = QJsonValue();
+    item[QSL("feedId")] = feed_id;
+    item[QSL("unread")] = true;
+    item[QSL("starred")] = false;
+    items.append(item);
+  }
+
+  return items;
+}
+
+QJsonArray MockFeedServer::inoreaderItems(int feed_id, int limit) {
+  const QList<Message>& messages = feedMessages(feed_id);
+  QJsonArray items;
+
+  for (int i = 0; i < messages.size() && i < limit; i++) {
+    const Message& message = messages.at(i);
+    QJsonObject item;
+    QJsonObject alternate;
+    QJsonObject summary;
+    QJsonObject origin;
+
+    alternate[QSL("href")] = message.m_url;
+    alternate[QSL("type")] = QSL("text/html");
+    summary[QSL("direction")] = QSL("ltr");
+    summary[QSL("content")] = message.m_contents;
+    origin[QSL("streamId")] = QSL("feed/") + baseUrl() + feedPath(feed_id);
+    origin[QSL("title")] = QSL("Feed %1").arg(feed_id);
+
+    item[QSL("id")] = QSL("tag:google.com,2005:reader/item/%1").arg(qint64(feed_id) * 100000 + i + 1, 16, 16, QL1C('0'));
+    item[QSL("title")] = message.m_title;
+    item[QSL("author")] = message.m_author;
+    item[QSL("published")] = message.m_created.toSecsSinceEpoch();
+    item[QSL("updated")] = message.m_created.toSecsSinceEpoch();
+    item[QSL("alternate")] = QJsonArray() << alternate;
+    item[QSL("categories")] = QJsonArray() << QSL(MOCK_INOREADER_USER "state/com.google/reading-list");
+    item[QSL("summary")] = summary;
+    item[QSL("origin")] = origin;
+    items.append(item);
+  }
+
+  return items;
+}
+
+const QList<Message>& MockFeedServer::feedMessages(int feed_id) {
+  if (!m_messages.contains(feed_id)) {
+    SyntheticFeeds generator(m_options.m_seed + quint32(feed_id) * 2654435761u);
+
+    m_messages.insert(feed_id, generator.messages(baseUrl() + QSL("/feeds/%1").arg(feed_id),
+                                                  m_options.m_itemsPerFeed, m_options.m_contentsLength));
+  }
+
+  return m_messages[feed_id];
+}
+
+SyntheticFeeds::Format MockFeedServer::feedFormat(int feed_id) const {
+  return SyntheticFeeds::Format((feed_id - 1) % 3);
+}
+
+int MockFeedServer::feedCategory(int feed_id) const {
+  return m_options.m_categories > 0 ? (feed_id - 1) % m_options.m_categories + 1 : 0;
+}
+
+bool MockFeedServer::isValidFeed(int feed_id) const {
+  return feed_id >= 1 && feed_id <= m_options.m_feeds;
+}
+
+bool MockFeedServer::chance(double ratio) {
+  return ratio > 0.0 && m_random.bounded(10000) < int(ratio * 10000);
+}
+
+MockFeedServer::Response MockFeedServer::jsonResponse(const QJsonValue& json) {
+  Response response;
+
+  response.m_body = json.isArray()
+                    ? QJsonDocument(json.toArray()).toJson(QJsonDocument::Compact)
+                    : QJsonDocument(json.toObject()).toJson(QJsonDocument::Compact);
+  return response;
+}
+
+MockFeedServer::Response MockFeedServer::errorResponse(int status) {
+  Response response;
+
+  response.m_status = status;
+  response.m_contentType = "text/plain; charset=utf-8";
+  response.m_body = "Mock error " + QByteArray::number(status);
+  return response;
+}
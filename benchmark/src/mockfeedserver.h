@@ -0,0 +1,133 @@
+// This file is part of RSS Guard.
+
+//
+// Copyright (C) 2011-2017 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+#ifndef MOCKFEEDSERVER_H
+#define MOCKFEEDSERVER_H
+
+#include <QTcpServer>
+
+#include "syntheticfeeds.h"
+
+#include <QAtomicInt>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QUrl>
+#include <QUrlQuery>
+
+class QTcpSocket;
+class QTimer;
+
+// Behavior of mock feed server.
+struct MockServerOptions {
+  int m_feeds = 1000;
+  int m_categories = 10;
+  int m_itemsPerFeed = 25;
+  int m_contentsLength = 1000;
+
+  // Each response is delayed by latency plus random jitter, in milliseconds.
+  int m_latency = 0;
+  int m_latencyJitter = 0;
+
+  // Bytes per second for each connection, zero means unlimited.
+  int m_bandwidth = 0;
+
+  // Ratios of requests for feeds or messages which fail with HTTP 503
+  // and of feed requests which are redirected first.
+  double m_errorRate = 0.0;
+  double m_redirectRate = 0.0;
+
+  quint32 m_seed = 1;
+};
+
+// Local HTTP/1.1 server for benchmarks, each connection serves one request.
+// Feeds are numbered from 1, each feed is available as:
+//   - /feeds/N.rss, /feeds/N.atom or /feeds/N.rdf, format depends on N,
+//   - Tiny Tiny RSS feed via /tt-rss/api/,
+//   - Nextcloud News feed via /nextcloud/index.php/apps/news/api/v1-2/,
+//   - Inoreader stream via /inoreader/reader/api/0/.
+// Redirected requests go to the same path prefixed with /redirected.
+class MockFeedServer : public QTcpServer {
+  Q_OBJECT
+
+  public:
+    explicit MockFeedServer(const MockServerOptions& options, QObject* parent = nullptr);
+    virtual ~MockFeedServer();
+
+    // Returns address of the server, e.g. "http://127.0.0.1:8080".
+    QString baseUrl() const;
+
+    // Returns path of document of given feed.
+    QString feedPath(int feed_id) const;
+
+    int requestCount() const;
+
+  public slots:
+
+    // Starts listening on localhost, random free port is used if port is zero.
+    bool start(quint16 port = 0);
+
+  protected:
+    void incomingConnection(qintptr socket_descriptor);
+
+  private slots:
+    void readRequest();
+    void writePending();
+    void removeSocket();
+
+  private:
+    struct Response {
+      int m_status = 200;
+      QByteArray m_contentType = "application/json; charset=utf-8";
+      QByteArray m_body;
+      QByteArray m_location;
+    };
+
+    Response route(const QByteArray& method, const QUrl& url, const QByteArray& body);
+    void respond(QTcpSocket* socket, const Response& response);
+
+    Response feedDocument(const QString& file_name);
+    Response ttRss(const QByteArray& body);
+    Response nextcloud(const QString& endpoint, const QUrlQuery& query);
+    Response inoreader(const QString& endpoint, const QUrlQuery& query);
+
+    QJsonObject ttRssResult(int status, const QJsonValue& content) const;
+    QJsonArray ttRssHeadlines(int feed_id, int skip, int limit);
+    QJsonArray nextcloudItems(int feed_id);
+    QJsonArray inoreaderItems(int feed_id, int limit);
+
+    const QList<Message>& feedMessages(int feed_id);
+    SyntheticFeeds::Format feedFormat(int feed_id) const;
+    int feedCategory(int feed_id) const;
+    bool isValidFeed(int feed_id) const;
+    bool chance(double ratio);
+
+    static Response jsonResponse(const QJsonValue& json);
+    static Response errorResponse(int status);
+
+    MockServerOptions m_options;
+    SyntheticFeeds m_random;
+    QAtomicInt m_requestCount;
+    QTimer* m_throttleTimer;
+    QHash<int, QByteArray> m_documents;
+    QHash<int, QList<Message>> m_messages;
+    QHash<QTcpSocket*, QByteArray> m_requests;
+    QHash<QTcpSocket*, QByteArray> m_pending;
+};
+
+#endif // MOCKFEEDSERVER_H
@@ -0,0 +1,206 @@
+// This file is part of RSS Guard.
+
+//
+// Copyright (C) 2011-2017 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+#include "syntheticdatabase.h"
+
+#include "definitions/definitions.h"
+#include "miscellaneous/application.h"
+#include "miscellaneous/databasefactory.h"
+#include "miscellaneous/databasequeries.h"
+#include "miscellaneous/knownmessagesfilter.h"
+
+#include <QIcon>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QtMath>
+
+SyntheticDatabase::SyntheticDatabase(const SyntheticScale& scale, quint32 seed)
+  : m_scale(scale), m_generator(seed), m_accountId(0) {}
+
+bool SyntheticDatabase::prepare(QSqlDatabase db, bool* generated) {
+  *generated = false;
+
+  if (load(db)) {
+    return true;
+  }
+
+  *generated = true;
+
+  if (!db.transaction()) {
+    qCritical("Transaction start for synthetic database failed: '%s'.", qPrintable(db.lastError().text()));
+    return false;
+  }
+
+  if (!generate(db) || !insertMessages(db)) {
+    db.rollback();
+    return false;
+  }
+
+  if (!db.commit()) {
+    qCritical("Transaction commit for synthetic database failed: '%s'.", qPrintable(db.lastError().text()));
+    return false;
+  }
+
+  // Messages were inserted behind back of the application, so nothing cached about them can be trusted.
+  qApp->database()->knownMessages()->clear();
+  return true;
+}
+
+int SyntheticDatabase::accountId() const {
+  return m_accountId;
+}
+
+QList<int> SyntheticDatabase::categoryIds() const {
+  return m_categoryIds;
+}
+
+QList<int> SyntheticDatabase::feedIds() const {
+  return m_feedIds;
+}
+
+const SyntheticScale& SyntheticDatabase::scale() const {
+  return m_scale;
+}
+
+SyntheticFeeds* SyntheticDatabase::generator() {
+  return &m_generator;
+}
+
+bool SyntheticDatabase::load(QSqlDatabase db) {
+  QSqlQuery q(db);
+
+  q.setForwardOnly(true);
+
+  if (!q.exec(QSL("SELECT min(id) FROM Accounts WHERE type = '" SERVICE_CODE_STD_RSS "';")) || !q.next() || q.value(0).isNull()) {
+    return false;
+  }
+
+  m_accountId = q.value(0).toInt();
+  m_categoryIds.clear();
+  m_feedIds.clear();
+
+  q.prepare(QSL("SELECT id FROM Categories WHERE account_id = :account_id ORDER BY id;"));
+  q.bindValue(QSL(":account_id"), m_accountId);
+
+  if (!q.exec()) {
+    return false;
+  }
+
+  while (q.next()) {
+    m_categoryIds.append(q.value(0).toInt());
+  }
+
+  q.prepare(QSL("SELECT id FROM Feeds WHERE account_id = :account_id ORDER BY id;"));
+  q.bindValue(QSL(":account_id"), m_accountId);
+
+  if (!q.exec()) {
+    return false;
+  }
+
+  while (q.next()) {
+    m_feedIds.append(q.value(0).toInt());
+  }
+
+  q.prepare(QSL("SELECT count(*) FROM Messages WHERE account_id = :account_id;"));
+  q.bindValue(QSL(":account_id"), m_accountId);
+
+  if (m_feedIds.isEmpty() || !q.exec() || !q.next()) {
+    return false;
+  }
+
+  // Reused database keeps its own scale.
+  m_scale.m_categories = m_categoryIds.size();
+  m_scale.m_feeds = m_feedIds.size();
+  m_scale.m_messages = q.value(0).toInt();
+  return true;
+}
+
+bool SyntheticDatabase::generate(QSqlDatabase db) {
+  bool ok;
+
+  m_accountId = DatabaseQueries::createAccount(db, SERVICE_CODE_STD_RSS, &ok);
+
+  if (!ok) {
+    return false;
+  }
+
+  // Roughly square root of categories forms top level, others are nested in them.
+  const int top_categories = qMax(1, int(qSqrt(m_scale.m_categories)));
+
+  for (int i = 0; i < m_scale.m_categories; i++) {
+    const int parent_id = i < top_categories ? NO_PARENT_CATEGORY : m_categoryIds.at(m_generator.bounded(top_categories));
+    const int category_id = DatabaseQueries::addCategory(db, parent_id, m_accountId, QSL("Category %1").arg(i + 1),
+                                                         m_generator.words(6), QDateTime::currentDateTime(), QIcon(), &ok);
+
+    if (!ok) {
+      return false;
+    }
+
+    m_categoryIds.append(category_id);
+  }
+
+  for (int i = 0; i < m_scale.m_feeds; i++) {
+    const int parent_id = m_categoryIds.isEmpty() ? NO_PARENT_CATEGORY : m_categoryIds.at(i % m_categoryIds.size());
+    const StandardFeed::Type type = i % 3 == 0 ? StandardFeed::Rss2X : (i % 3 == 1 ? StandardFeed::Atom10 : StandardFeed::Rdf);
+    const int feed_id = DatabaseQueries::addFeed(db, parent_id, m_accountId, QSL("Feed %1").arg(i + 1),
+                                                 m_generator.words(8), QDateTime::currentDateTime(), QIcon(),
+                                                 DEFAULT_FEED_ENCODING, QSL("http://bench.rssguard.invalid/feed-%1").arg(i + 1),
+                                                 false, QString(), QString(), Feed::DontAutoUpdate, 0, type, &ok);
+
+    if (!ok) {
+      return false;
+    }
+
+    m_feedIds.append(feed_id);
+  }
+
+  return !m_feedIds.isEmpty();
+}
+
+bool SyntheticDatabase::insertMessages(QSqlDatabase db) {
+  QSqlQuery q(db);
+
+  q.setForwardOnly(true);
+  q.prepare(QSL("INSERT INTO Messages "
+                "(feed, title, is_read, is_important, url, author, date_created, contents, enclosures, custom_id, custom_hash, account_id) "
+                "VALUES (:feed, :title, :is_read, :is_important, :url, :author, :date_created, :contents, '', '', '', :account_id);"));
+
+  const int read_threshold = int(m_scale.m_readRatio * 10000);
+  const int important_threshold = int(m_scale.m_importantRatio * 10000);
+
+  for (int i = 0; i < m_scale.m_messages; i++) {
+    const int feed_index = i % m_feedIds.size();
+    const int feed_id = m_feedIds.at(feed_index);
+
+    q.bindValue(QSL(":feed"), QString::number(feed_id));
+    q.bindValue(QSL(":title"), m_generator.words(4 + m_generator.bounded(6)));
+    q.bindValue(QSL(":is_read"), m_generator.bounded(10000) < read_threshold ? 1 : 0);
+    q.bindValue(QSL(":is_important"), m_generator.bounded(10000) < important_threshold ? 1 : 0);
+    q.bindValue(QSL(":url"), QSL("http://bench.rssguard.invalid/feed-%1/item-%2").arg(QString::number(feed_index + 1), QString::number(i)));
+    q.bindValue(QSL(":author"), QSL("Author %1").arg(m_generator.bounded(50)));
+    q.bindValue(QSL(":date_created"), m_generator.date(m_scale.m_maxAgeDays).toMSecsSinceEpoch());
+    q.bindValue(QSL(":contents"), m_generator.contents(m_scale.m_contentsLength));
+    q.bindValue(QSL(":account_id"), m_accountId);
+
+    if (!q.exec()) {
+      qCritical("Failed to insert synthetic message: '%s'.", qPrintable(q.lastError().text()));
+      return false;
+    }
+  }
+
+  return true;
+}
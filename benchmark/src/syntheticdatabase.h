@@ -0,0 +1,66 @@
+// This file is part of RSS Guard.
+
+//
+// Copyright (C) 2011-2017 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+#ifndef SYNTHETICDATABASE_H
+#define SYNTHETICDATABASE_H
+
+#include "syntheticfeeds.h"
+
+#include <QList>
+#include <QSqlDatabase>
+
+// Scale of generated database.
+struct SyntheticScale {
+  int m_categories = 20;
+  int m_feeds = 200;
+  int m_messages = 100000;
+  double m_readRatio = 0.7;
+  double m_importantRatio = 0.02;
+  int m_maxAgeDays = 365;
+  int m_contentsLength = 1500;
+};
+
+// Populates database with standard RSS account of given scale.
+// Categories form two levels, feeds and messages are spread evenly among them.
+class SyntheticDatabase {
+  public:
+    explicit SyntheticDatabase(const SyntheticScale& scale, quint32 seed);
+
+    // Reuses account generated by previous run, if there is any, otherwise generates new one.
+    bool prepare(QSqlDatabase db, bool* generated);
+
+    int accountId() const;
+    QList<int> categoryIds() const;
+    QList<int> feedIds() const;
+    const SyntheticScale& scale() const;
+
+    // Generator of data, which is shared with benchmarks.
+    SyntheticFeeds* generator();
+
+  private:
+    bool load(QSqlDatabase db);
+    bool generate(QSqlDatabase db);
+    bool insertMessages(QSqlDatabase db);
+
+    SyntheticScale m_scale;
+    SyntheticFeeds m_generator;
+    int m_accountId;
+    QList<int> m_categoryIds;
+    QList<int> m_feedIds;
+};
+
+#endif // SYNTHETICDATABASE_H
@@ -0,0 +1,211 @@
+// This file is part of RSS Guard.
+
+//
+// Copyright (C) 2011-2017 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+#include "syntheticfeeds.h"
+
+#include "definitions/definitions.h"
+
+#include <QXmlStreamWriter>
+
+namespace {
+  const char* const kWords[] = {
+    "lorem", "ipsum", "dolor", "sit", "amet", "consectetur", "adipiscing", "elit", "sed", "do",
+    "eiusmod", "tempor", "incididunt", "ut", "labore", "et", "dolore", "magna", "aliqua", "enim",
+    "ad", "minim", "veniam", "quis", "nostrud", "exercitation", "ullamco", "laboris", "nisi", "aliquip",
+    "ex", "ea", "commodo", "consequat", "duis", "aute", "irure", "in", "reprehenderit", "voluptate"
+  };
+
+  const int kWordCount = sizeof(kWords) / sizeof(kWords[0]);
+
+  // Items of generated documents are dated relative to fixed date, so documents do not change between runs.
+  const QDateTime kDocumentDate = QDateTime(QDate(2017, 1, 1), QTime(12, 0), Qt::UTC);
+}
+
+SyntheticFeeds::SyntheticFeeds(quint32 seed) : m_state(seed) {}
+
+QByteArray SyntheticFeeds::document(Format format, const QString& base_url, const QString& title,
+                                    int items, int contents_length) {
+  QByteArray data;
+  QXmlStreamWriter writer(&data);
+
+  writer.setAutoFormatting(true);
+  writer.writeStartDocument();
+
+  switch (format) {
+    case Atom:
+      writer.writeDefaultNamespace(QSL("http://www.w3.org/2005/Atom"));
+      writer.writeStartElement(QSL("feed"));
+      writer.writeTextElement(QSL("title"), title);
+      writer.writeTextElement(QSL("id"), base_url);
+      writer.writeTextElement(QSL("updated"), kDocumentDate.toString(Qt::ISODate));
+      writer.writeStartElement(QSL("link"));
+      writer.writeAttribute(QSL("href"), base_url);
+      writer.writeEndElement();
+
+      for (int i = 0; i < items; i++) {
+        const QString url = base_url + QSL("/item-%1").arg(i);
+
+        writer.writeStartElement(QSL("entry"));
+        writer.writeTextElement(QSL("title"), words(4 + bounded(6)));
+        writer.writeTextElement(QSL("id"), url);
+        writer.writeTextElement(QSL("updated"), kDocumentDate.addSecs(-3600 * i).toString(Qt::ISODate));
+        writer.writeStartElement(QSL("link"));
+        writer.writeAttribute(QSL("href"), url);
+        writer.writeEndElement();
+        writer.writeStartElement(QSL("author"));
+        writer.writeTextElement(QSL("name"), QSL("Author %1").arg(bounded(50)));
+        writer.writeEndElement();
+        writer.writeStartElement(QSL("content"));
+        writer.writeAttribute(QSL("type"), QSL("html"));
+        writer.writeCharacters(contents(contents_length));
+        writer.writeEndElement();
+        writer.writeEndElement();
+      }
+
+      writer.writeEndElement();
+      break;
+
+    case Rdf:
+      writer.writeNamespace(QSL("http://www.w3.org/1999/02/22-rdf-syntax-ns#"), QSL("rdf"));
+      writer.writeNamespace(QSL("http://purl.org/dc/elements/1.1/"), QSL("dc"));
+      writer.writeDefaultNamespace(QSL("http://purl.org/rss/1.0/"));
+      writer.writeStartElement(QSL("http://www.w3.org/1999/02/22-rdf-syntax-ns#"), QSL("RDF"));
+      writer.writeStartElement(QSL("channel"));
+      writer.writeAttribute(QSL("http://www.w3.org/1999/02/22-rdf-syntax-ns#"), QSL("about"), base_url);
+      writer.writeTextElement(QSL("title"), title);
+      writer.writeTextElement(QSL("link"), base_url);
+      writer.writeTextElement(QSL("description"), title);
+      writer.writeEndElement();
+
+      for (int i = 0; i < items; i++) {
+        const QString url = base_url + QSL("/item-%1").arg(i);
+
+        writer.writeStartElement(QSL("item"));
+        writer.writeAttribute(QSL("http://www.w3.org/1999/02/22-rdf-syntax-ns#"), QSL("about"), url);
+        writer.writeTextElement(QSL("title"), words(4 + bounded(6)));
+        writer.writeTextElement(QSL("link"), url);
+        writer.writeTextElement(QSL("description"), contents(contents_length));
+        writer.writeTextElement(QSL("http://purl.org/dc/elements/1.1/"), QSL("date"),
+                                kDocumentDate.addSecs(-3600 * i).toString(Qt::ISODate));
+        writer.writeTextElement(QSL("http://purl.org/dc/elements/1.1/"), QSL("creator"),
+                                QSL("Author %1").arg(bounded(50)));
+        writer.writeEndElement();
+      }
+
+      writer.writeEndElement();
+      break;
+
+    case Rss:
+    default:
+      writer.writeStartElement(QSL("rss"));
+      writer.writeAttribute(QSL("version"), QSL("2.0"));
+      writer.writeStartElement(QSL("channel"));
+      writer.writeTextElement(QSL("title"), title);
+      writer.writeTextElement(QSL("link"), base_url);
+      writer.writeTextElement(QSL("description"), title);
+
+      for (int i = 0; i < items; i++) {
+        const QString url = base_url + QSL("/item-%1").arg(i);
+
+        writer.writeStartElement(QSL("item"));
+        writer.writeTextElement(QSL("title"), words(4 + bounded(6)));
+        writer.writeTextElement(QSL("link"), url);
+        writer.writeTextElement(QSL("guid"), url);
+        writer.writeTextElement(QSL("author"), QSL("Author %1").arg(bounded(50)));
+        writer.writeTextElement(QSL("pubDate"), kDocumentDate.addSecs(-3600 * i).toString(Qt::RFC2822Date));
+        writer.writeTextElement(QSL("description"), contents(contents_length));
+        writer.writeEndElement();
+      }
+
+      writer.writeEndElement();
+      writer.writeEndElement();
+      break;
+  }
+
+  writer.writeEndDocument();
+  return data;
+}
+
+QList<Message> SyntheticFeeds::messages(const QString& base_url, int count, int contents_length) {
+  QList<Message> messages;
+
+  messages.reserve(count);
+
+  for (int i = 0; i < count; i++) {
+    Message message;
+
+    message.m_title = words(4 + bounded(6));
+    message.m_url = base_url + QSL("/item-%1").arg(i);
+    message.m_author = QSL("Author %1").arg(bounded(50));
+    message.m_contents = contents(contents_length);
+    message.m_created = kDocumentDate.addSecs(-3600 * i);
+    message.m_createdFromFeed = true;
+    messages.append(message);
+  }
+
+  return messages;
+}
+
+QString SyntheticFeeds::words(int count) {
+  QStringList result;
+
+  for (int i = 0; i < count; i++) {
+    result.append(QL1S(kWords[bounded(kWordCount)]));
+  }
+
+  return result.join(QL1C(' '));
+}
+
+QString SyntheticFeeds::contents(int length) {
+  QString result;
+
+  result.reserve(length + 128);
+
+  while (result.size() < length) {
+    result += QSL("<p>") + words(8 + bounded(24)) + QSL(".</p>");
+  }
+
+  return result;
+}
+
+QDateTime SyntheticFeeds::date(int max_age_days) {
+  return QDateTime::currentDateTimeUtc().addSecs(-bounded(qMax(max_age_days, 1) * 86400));
+}
+
+int SyntheticFeeds::bounded(int max) {
+  return max <= 0 ? 0 : int(next() % quint32(max));
+}
+
+QString SyntheticFeeds::formatName(Format format) {
+  switch (format) {
+    case Atom:
+      return QSL("atom");
+
+    case Rdf:
+      return QSL("rdf");
+
+    case Rss:
+    default:
+      return QSL("rss");
+  }
+}
+
+quint32 SyntheticFeeds::next() {
+  // Simple LCG is enough here, upper bits are used since lower ones have short period.
+  m_state = m_state * 1664525u + 1013904223u;
+  return m_state >> 8;
+}
@@ -0,0 +1,65 @@
+// This file is part of RSS Guard.
+
+//
+// Copyright (C) 2011-2017 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+#ifndef SYNTHETICFEEDS_H
+#define SYNTHETICFEEDS_H
+
+#include "core/message.h"
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QList>
+#include <QString>
+
+// Deterministic generator of synthetic feed data.
+// Same seed always yields same data, so results of separate runs are comparable.
+class SyntheticFeeds {
+  public:
+    enum Format {
+      Rss = 0,
+      Atom = 1,
+      Rdf = 2
+    };
+
+    explicit SyntheticFeeds(quint32 seed);
+
+    // Generates whole feed document, links of its items point under base_url.
+    QByteArray document(Format format, const QString& base_url, const QString& title,
+                        int items, int contents_length);
+
+    // Generates messages as if they were just parsed from feed.
+    QList<Message> messages(const QString& base_url, int count, int contents_length);
+
+    // Random words and HTML paragraphs of approximately given length.
+    QString words(int count);
+    QString contents(int length);
+
+    // Random date from last max_age_days days.
+    QDateTime date(int max_age_days);
+
+    // Random number from interval <0, max).
+    int bounded(int max);
+
+    static QString formatName(Format format);
+
+  private:
+    quint32 next();
+
+    quint32 m_state;
+};
+
+#endif // SYNTHETICFEEDS_H
@@ -0,0 +1,253 @@
+// This file is part of RSS Guard.
+
+//
+// Copyright (C) 2011-2017 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+#include "updateharness.h"
+
+#include "benchmarkrunner.h"
+#include "mockfeedserver.h"
+
+#include "core/feedsmodel.h"
+#include "core/feedupdatestatistics.h"
+#include "definitions/definitions.h"
+#include "miscellaneous/application.h"
+#include "miscellaneous/databasefactory.h"
+#include "miscellaneous/databasequeries.h"
+#include "miscellaneous/feedreader.h"
+#include "services/abstract/serviceroot.h"
+#include "services/owncloud/definitions.h"
+
+#include <QIcon>
+#include <QJsonObject>
+#include <QTimer>
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <psapi.h>
+#elif defined(Q_OS_UNIX)
+#include <sys/resource.h>
+#endif
+
+UpdateHarness::UpdateHarness(MockFeedServer* server, int feeds, int categories, const QStringList& services,
+                             int rounds, QObject* parent)
+  : QObject(parent), m_server(server), m_feeds(feeds), m_categories(categories), m_services(services),
+  m_rounds(qMax(1, rounds)), m_round(0), m_lockAttempts(0), m_roundRequests(0), m_roundFeeds(0), m_running(false) {}
+
+UpdateHarness::~UpdateHarness() {}
+
+void UpdateHarness::start() {
+  QElapsedTimer timer;
+
+  timer.start();
+
+  if (!createAccounts()) {
+    qCritical("Accounts of update harness could not be created.");
+    finish(EXIT_FAILURE);
+    return;
+  }
+
+  // Online accounts without feeds synchronize their feed lists with mock server now.
+  connect(qApp->feedReader(), &FeedReader::feedUpdatesFinished, this, &UpdateHarness::onUpdatesFinished);
+  qApp->feedReader()->feedsModel()->loadActivatedServiceAccounts();
+
+  QJsonObject info;
+
+  info[QSL("event")] = QSL("accounts");
+  info[QSL("services")] = m_services.join(QL1C(','));
+  info[QSL("feeds")] = harnessFeeds().size();
+  info[QSL("requests")] = m_server->requestCount();
+  info[QSL("ms")] = timer.elapsed();
+  BenchmarkRunner::print(info);
+
+  QTimer::singleShot(0, this, &UpdateHarness::startRound);
+}
+
+void UpdateHarness::startRound() {
+  const QList<Feed*> feeds = harnessFeeds();
+
+  if (feeds.isEmpty()) {
+    qCritical("There are no feeds to update.");
+    finish(EXIT_FAILURE);
+    return;
+  }
+
+  qApp->feedReader()->updateStatistics()->clear();
+  m_roundRequests = m_server->requestCount();
+  m_roundFeeds = feeds.size();
+  m_running = true;
+  m_roundTimer.start();
+
+  if (qApp->feedReader()->updateFeeds(feeds)) {
+    m_lockAttempts = 0;
+  }
+  else if (++m_lockAttempts < HEADLESS_LOCK_ATTEMPTS) {
+    m_running = false;
+    QTimer::singleShot(HEADLESS_LOCK_RETRY_INTERVAL, this, &UpdateHarness::startRound);
+  }
+  else {
+    qCritical("Feed update lock is held by another operation.");
+    finish(EXIT_FAILURE);
+  }
+}
+
+qint64 UpdateHarness::peakMemory() {
+#if defined(Q_OS_WIN)
+  PROCESS_MEMORY_COUNTERS counters;
+
+  if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+    return qint64(counters.PeakWorkingSetSize);
+  }
+#elif defined(Q_OS_UNIX)
+  struct rusage usage;
+
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#if defined(Q_OS_MAC)
+    return qint64(usage.ru_maxrss);
+#else
+    // Linux and BSDs report kilobytes.
+    return qint64(usage.ru_maxrss) * 1024;
+#endif
+  }
+#endif
+
+  return -1;
+}
+
+void UpdateHarness::onUpdatesFinished(const FeedDownloadResults& results) {
+  if (!m_running) {
+    return;
+  }
+
+  const qint64 elapsed = m_roundTimer.elapsed();
+  const double seconds = qMax(elapsed, qint64(1)) / 1000.0;
+  QVector<double> latencies;
+  int updated_feeds = 0;
+  int failed_feeds = 0;
+  int obtained_messages = 0;
+  int new_messages = 0;
+  qint64 bytes = 0;
+
+  foreach (const FeedUpdateStatisticsEntry& entry, qApp->feedReader()->updateStatistics()->entries()) {
+    updated_feeds++;
+    failed_feeds += entry.m_last.m_error ? 1 : 0;
+    obtained_messages += entry.m_last.m_obtainedMessages;
+    new_messages += entry.m_last.m_newMessages;
+    bytes += entry.m_last.m_bytesReceived;
+    latencies.append(entry.m_last.totalTime());
+  }
+
+  // Latency of feed covers network, parsing and storing of its messages.
+  QJsonObject result = BenchmarkRunner::timings(latencies);
+
+  result[QSL("benchmark")] = QSL("update_round");
+  result[QSL("round")] = m_round + 1;
+  result[QSL("scheduled_feeds")] = m_roundFeeds;
+  result[QSL("feeds")] = updated_feeds;
+  result[QSL("failed_feeds")] = failed_feeds;
+  result[QSL("unchanged_feeds")] = results.unchangedFeeds();
+  result[QSL("messages")] = obtained_messages;
+  result[QSL("new_messages")] = new_messages;
+  result[QSL("bytes")] = bytes;
+  result[QSL("requests")] = m_server->requestCount() - m_roundRequests;
+  result[QSL("ms")] = elapsed;
+  result[QSL("feeds_per_s")] = updated_feeds / seconds;
+  result[QSL("messages_per_s")] = obtained_messages / seconds;
+
+  // Peak is measured since start of the process, so it never decreases between rounds.
+  result[QSL("peak_rss_bytes")] = peakMemory();
+  BenchmarkRunner::print(result);
+
+  m_running = false;
+
+  if (++m_round < m_rounds) {
+    QTimer::singleShot(0, this, &UpdateHarness::startRound);
+  }
+  else {
+    finish(EXIT_SUCCESS);
+  }
+}
+
+bool UpdateHarness::createAccounts() {
+  QSqlDatabase database = qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings);
+  const QString base_url = m_server->baseUrl();
+  bool ok;
+
+  foreach (const QString& service, m_services) {
+    if (service == QL1S(SERVICE_CODE_STD_RSS)) {
+      const int account_id = DatabaseQueries::createAccount(database, SERVICE_CODE_STD_RSS, &ok);
+      QList<int> category_ids;
+
+      for (int i = 1; ok && i <= m_categories; i++) {
+        category_ids.append(DatabaseQueries::addCategory(database, NO_PARENT_CATEGORY, account_id, QSL("Category %1").arg(i),
+                                                         QString(), QDateTime::currentDateTime(), QIcon(), &ok));
+      }
+
+      for (int i = 1; ok && i <= m_feeds; i++) {
+        const QString url = base_url + m_server->feedPath(i);
+        const StandardFeed::Type type = url.endsWith(QL1S(".atom"))
+                                        ? StandardFeed::Atom10
+                                        : (url.endsWith(QL1S(".rdf")) ? StandardFeed::Rdf : StandardFeed::Rss2X);
+
+        DatabaseQueries::addFeed(database, category_ids.isEmpty() ? NO_PARENT_CATEGORY : category_ids.at((i - 1) % category_ids.size()),
+                                 account_id, QSL("Feed %1").arg(i), QString(), QDateTime::currentDateTime(), QIcon(),
+                                 DEFAULT_FEED_ENCODING, url, false, QString(), QString(), Feed::DontAutoUpdate, 0, type, &ok);
+      }
+
+      m_accountIds.append(account_id);
+    }
+    else if (service == QL1S(SERVICE_CODE_TT_RSS)) {
+      const int account_id = DatabaseQueries::createAccount(database, SERVICE_CODE_TT_RSS, &ok);
+
+      ok = ok && DatabaseQueries::createTtRssAccount(database, account_id, QSL("bench"), QSL("bench"), false, QString(),
+                                                     QString(), base_url + QSL("/tt-rss/"), false);
+      m_accountIds.append(account_id);
+    }
+    else if (service == QL1S(SERVICE_CODE_OWNCLOUD)) {
+      const int account_id = DatabaseQueries::createAccount(database, SERVICE_CODE_OWNCLOUD, &ok);
+
+      ok = ok && DatabaseQueries::createOwnCloudAccount(database, account_id, QSL("bench"), QSL("bench"),
+                                                        base_url + QSL("/nextcloud"), false, OWNCLOUD_UNLIMITED_BATCH_SIZE);
+      m_accountIds.append(account_id);
+    }
+    else {
+      // Inoreader endpoints are fixed and require OAuth, so its mock API is only served.
+      qCritical("Service '%s' cannot be driven by update harness.", qPrintable(service));
+      return false;
+    }
+
+    if (!ok) {
+      return false;
+    }
+  }
+
+  return !m_accountIds.isEmpty();
+}
+
+QList<Feed*> UpdateHarness::harnessFeeds() const {
+  QList<Feed*> feeds;
+
+  foreach (ServiceRoot* root, qApp->feedReader()->feedsModel()->serviceRoots()) {
+    if (m_accountIds.contains(root->accountId())) {
+      feeds.append(root->getSubTreeFeeds());
+    }
+  }
+
+  return feeds;
+}
+
+void UpdateHarness::finish(int exit_code) {
+  qApp->exit(exit_code);
+}
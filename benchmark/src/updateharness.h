@@ -0,0 +1,72 @@
+// This file is part of RSS Guard.
+
+//
+// Copyright (C) 2011-2017 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+#ifndef UPDATEHARNESS_H
+#define UPDATEHARNESS_H
+
+#include <QObject>
+
+#include "core/feeddownloader.h"
+
+#include <QElapsedTimer>
+#include <QStringList>
+
+class Feed;
+class MockFeedServer;
+
+// Drives full update rounds of feeds of service accounts which use mock feed server,
+// e.g. standard feeds or Tiny Tiny RSS and Nextcloud News accounts.
+// Throughput and latency of each round are printed as single JSON line,
+// application quits after the last round.
+class UpdateHarness : public QObject {
+  Q_OBJECT
+
+  public:
+    explicit UpdateHarness(MockFeedServer* server, int feeds, int categories, const QStringList& services,
+                           int rounds, QObject* parent = nullptr);
+    virtual ~UpdateHarness();
+
+    // Creates accounts, loads them and starts first round.
+    void start();
+
+  private slots:
+    void startRound();
+    void onUpdatesFinished(const FeedDownloadResults& results);
+
+  private:
+    bool createAccounts();
+    QList<Feed*> harnessFeeds() const;
+    void finish(int exit_code);
+
+    // Returns peak resident set size of the process in bytes, -1 if it cannot be determined.
+    static qint64 peakMemory();
+
+    MockFeedServer* m_server;
+    int m_feeds;
+    int m_categories;
+    QStringList m_services;
+    int m_rounds;
+    int m_round;
+    int m_lockAttempts;
+    int m_roundRequests;
+    int m_roundFeeds;
+    bool m_running;
+    QList<int> m_accountIds;
+    QElapsedTimer m_roundTimer;
+};
+
+#endif // UPDATEHARNESS_H
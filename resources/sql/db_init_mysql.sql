@@ -113,4 +113,31 @@ CREATE TABLE IF NOT EXISTS Messages (
   custom_hash     TEXT,
   
   FOREIGN KEY (account_id) REFERENCES Accounts (id)
+);
+-- !
+CREATE TABLE IF NOT EXISTS RetentionPolicies (
+  id              INTEGER     AUTO_INCREMENT PRIMARY KEY,
+  account_id      INTEGER     NOT NULL,
+  feed            TEXT,
+  max_age         INTEGER     NOT NULL DEFAULT 0 CHECK (max_age >= 0),
+  max_count       INTEGER     NOT NULL DEFAULT 0 CHECK (max_count >= 0),
+  keep_starred    INTEGER(1)  NOT NULL DEFAULT 1 CHECK (keep_starred >= 0 AND keep_starred <= 1),
+  
+  FOREIGN KEY (account_id) REFERENCES Accounts (id)
+);
+-- !
+CREATE TABLE IF NOT EXISTS FeedFailures (
+  id              INTEGER     AUTO_INCREMENT PRIMARY KEY,
+  account_id      INTEGER     NOT NULL,
+  feed            TEXT        NOT NULL,
+  failures        INTEGER     NOT NULL DEFAULT 0 CHECK (failures >= 0),
+  last_failure    BIGINT      NOT NULL DEFAULT 0,
+  next_attempt    BIGINT      NOT NULL DEFAULT 0
+);
+-- !
+CREATE TABLE IF NOT EXISTS HostCircuits (
+  id              INTEGER     AUTO_INCREMENT PRIMARY KEY,
+  host            TEXT        NOT NULL,
+  failures        INTEGER     NOT NULL DEFAULT 0 CHECK (failures >= 0),
+  open_until      BIGINT      NOT NULL DEFAULT 0
 );
\ No newline at end of file
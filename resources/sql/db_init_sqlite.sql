@@ -107,4 +107,31 @@ CREATE TABLE IF NOT EXISTS Messages (
   custom_hash     TEXT,
   
   FOREIGN KEY (account_id) REFERENCES Accounts (id)
+);
+-- !
+CREATE TABLE IF NOT EXISTS RetentionPolicies (
+  id              INTEGER     PRIMARY KEY,
+  account_id      INTEGER     NOT NULL,
+  feed            TEXT,
+  max_age         INTEGER     NOT NULL CHECK (max_age >= 0) DEFAULT 0,
+  max_count       INTEGER     NOT NULL CHECK (max_count >= 0) DEFAULT 0,
+  keep_starred    INTEGER(1)  NOT NULL CHECK (keep_starred >= 0 AND keep_starred <= 1) DEFAULT 1,
+  
+  FOREIGN KEY (account_id) REFERENCES Accounts (id)
+);
+-- !
+CREATE TABLE IF NOT EXISTS FeedFailures (
+  id              INTEGER     PRIMARY KEY,
+  account_id      INTEGER     NOT NULL,
+  feed            TEXT        NOT NULL,
+  failures        INTEGER     NOT NULL CHECK (failures >= 0) DEFAULT 0,
+  last_failure    INTEGER     NOT NULL DEFAULT 0,
+  next_attempt    INTEGER     NOT NULL DEFAULT 0
+);
+-- !
+CREATE TABLE IF NOT EXISTS HostCircuits (
+  id              INTEGER     PRIMARY KEY,
+  host            TEXT        NOT NULL,
+  failures        INTEGER     NOT NULL CHECK (failures >= 0) DEFAULT 0,
+  open_until      INTEGER     NOT NULL DEFAULT 0
 );
\ No newline at end of file
@@ -0,0 +1,12 @@
+CREATE TABLE IF NOT EXISTS RetentionPolicies (
+  id              INTEGER     AUTO_INCREMENT PRIMARY KEY,
+  account_id      INTEGER     NOT NULL,
+  feed            TEXT,
+  max_age         INTEGER     NOT NULL DEFAULT 0 CHECK (max_age >= 0),
+  max_count       INTEGER     NOT NULL DEFAULT 0 CHECK (max_count >= 0),
+  keep_starred    INTEGER(1)  NOT NULL DEFAULT 1 CHECK (keep_starred >= 0 AND keep_starred <= 1),
+  
+  FOREIGN KEY (account_id) REFERENCES Accounts (id)
+);
+-- !
+UPDATE Information SET inf_value = '11' WHERE inf_key = 'schema_version';
\ No newline at end of file
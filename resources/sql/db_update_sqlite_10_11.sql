@@ -0,0 +1,16 @@
+CREATE TABLE IF NOT EXISTS RetentionPolicies (
+  id              INTEGER     PRIMARY KEY,
+  account_id      INTEGER     NOT NULL,
+  feed            TEXT,
+  max_age         INTEGER     NOT NULL CHECK (max_age >= 0) DEFAULT 0,
+  max_count       INTEGER     NOT NULL CHECK (max_count >= 0) DEFAULT 0,
+  keep_starred    INTEGER(1)  NOT NULL CHECK (keep_starred >= 0 AND keep_starred <= 1) DEFAULT 1,
+  
+  FOREIGN KEY (account_id) REFERENCES Accounts (id)
+);
+-- !
+PRAGMA auto_vacuum = INCREMENTAL;
+-- !
+VACUUM;
+-- !
+UPDATE Information SET inf_value = '11' WHERE inf_key = 'schema_version';
\ No newline at end of file
@@ -0,0 +1,17 @@
+CREATE TABLE IF NOT EXISTS FeedFailures (
+  id              INTEGER     PRIMARY KEY,
+  account_id      INTEGER     NOT NULL,
+  feed            TEXT        NOT NULL,
+  failures        INTEGER     NOT NULL CHECK (failures >= 0) DEFAULT 0,
+  last_failure    INTEGER     NOT NULL DEFAULT 0,
+  next_attempt    INTEGER     NOT NULL DEFAULT 0
+);
+-- !
+CREATE TABLE IF NOT EXISTS HostCircuits (
+  id              INTEGER     PRIMARY KEY,
+  host            TEXT        NOT NULL,
+  failures        INTEGER     NOT NULL CHECK (failures >= 0) DEFAULT 0,
+  open_until      INTEGER     NOT NULL DEFAULT 0
+);
+-- !
+UPDATE Information SET inf_value = '12' WHERE inf_key = 'schema_version';
\ No newline at end of file
@@ -0,0 +1,491 @@
+#################################################################
+#
+# This file is part of RSS Guard.
+#
+# Copyright (C) 2011-2017 by Martin Rotter <rotter.martinos@gmail.com>
+#
+# RSS Guard is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# RSS Guard is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with RSS Guard. If not, see <http:# www.gnu.org/licenses/>.
+#
+#
+#  Sources and build settings shared by RSS Guard application and
+#  by other projects built from the same sources, e.g. benchmarks.
+#  Everything except "main.cpp" is included.
+#
+#################################################################
+
+lessThan(QT_MAJOR_VERSION, 5)|lessThan(QT_MINOR_VERSION, 8) {
+  error(rssguard: At least Qt \"5.8.0\" is required!!!)
+}
+
+APP_NAME                      = "RSS Guard"
+APP_LOW_NAME                  = "rssguard"
+APP_LOW_H_NAME                = ".rssguard"
+APP_AUTHOR                    = "Martin Rotter"
+APP_COPYRIGHT                 = "(C) 2011-2017 $$APP_AUTHOR"
+APP_VERSION                   = "3.5.1"
+APP_LONG_NAME                 = "$$APP_NAME $$APP_VERSION"
+APP_EMAIL                     = "rotter.martinos@gmail.com"
+APP_URL                       = "https://github.com/martinrotter/rssguard"
+APP_URL_ISSUES                = "https://github.com/martinrotter/rssguard/issues"
+APP_URL_ISSUES_NEW            = "https://github.com/martinrotter/rssguard/issues/new"
+APP_URL_WIKI                  = "https://github.com/martinrotter/rssguard/wiki"
+APP_USERAGENT                 = "RSS Guard/$$APP_VERSION (github.com/martinrotter/rssguard)"
+APP_DONATE_URL                = "https://goo.gl/YFVJ0j"
+APP_WIN_ARCH                  = "win64"
+
+isEmpty(USE_WEBENGINE) {
+  USE_WEBENGINE = false
+  message("rssguard: USE_WEBENGINE variable is not set.")
+
+  qtHaveModule(webenginewidgets) {
+    USE_WEBENGINE = true
+    message("rssguard: WebEngine component IS installed, enabling it.")
+  }
+  else {
+    USE_WEBENGINE = false
+    message("rssguard: WebEngine component is probably NOT installed, disabling it.")
+  }
+}
+
+# Custom definitions.
+DEFINES += APP_VERSION='"\\\"$$APP_VERSION\\\""'
+DEFINES += APP_NAME='"\\\"$$APP_NAME\\\""'
+DEFINES += APP_LOW_NAME='"\\\"$$APP_LOW_NAME\\\""'
+DEFINES += APP_LOW_H_NAME='"\\\"$$APP_LOW_H_NAME\\\""'
+DEFINES += APP_LONG_NAME='"\\\"$$APP_LONG_NAME\\\""'
+DEFINES += APP_AUTHOR='"\\\"$$APP_AUTHOR\\\""'
+DEFINES += APP_EMAIL='"\\\"$$APP_EMAIL\\\""'
+DEFINES += APP_URL='"\\\"$$APP_URL\\\""'
+DEFINES += APP_URL_ISSUES='"\\\"$$APP_URL_ISSUES\\\""'
+DEFINES += APP_URL_ISSUES_NEW='"\\\"$$APP_URL_ISSUES_NEW\\\""'
+DEFINES += APP_URL_WIKI='"\\\"$$APP_URL_WIKI\\\""'
+DEFINES += APP_USERAGENT='"\\\"$$APP_USERAGENT\\\""'
+DEFINES += APP_DONATE_URL='"\\\"$$APP_DONATE_URL\\\""'
+DEFINES += APP_SYSTEM_NAME='"\\\"$$QMAKE_HOST.os\\\""'
+DEFINES += APP_SYSTEM_VERSION='"\\\"$$QMAKE_HOST.arch\\\""'
+
+exists($$PWD/.git) {
+  APP_REVISION = $$system(git rev-parse --short HEAD)
+}
+
+isEmpty(APP_REVISION) {
+  APP_REVISION = ""
+}
+
+equals(USE_WEBENGINE, false) {
+  # Add extra revision naming when building without webengine.
+  APP_REVISION = $$sprintf('%1-%2', $$APP_REVISION, nowebengine)
+}
+
+DEFINES += APP_REVISION='"\\\"$$APP_REVISION\\\""'
+
+QT *= core gui widgets sql network xml
+
+CONFIG *= c++11 warn_on
+DEFINES *= QT_USE_QSTRINGBUILDER QT_USE_FAST_CONCATENATION QT_USE_FAST_OPERATOR_PLUS UNICODE _UNICODE
+
+MOC_DIR = $$OUT_PWD/moc
+RCC_DIR = $$OUT_PWD/rcc
+UI_DIR = $$OUT_PWD/ui
+
+equals(USE_WEBENGINE, true) {
+  message(rssguard: Application will be compiled WITH QtWebEngine module.)
+  QT *= webenginewidgets
+  DEFINES *= USE_WEBENGINE
+}
+else {
+  message(rssguard: Application will be compiled without QtWebEngine module. Some features will be disabled.)
+}
+
+RESOURCES += $$PWD/resources/rssguard.qrc
+
+HEADERS +=  $$PWD/src/core/feeddownloader.h \
+            $$PWD/src/core/feedfailuretracker.h \
+            $$PWD/src/core/feedsmodel.h \
+            $$PWD/src/core/feedsproxymodel.h \
+            $$PWD/src/core/feedupdatestatistics.h \
+            $$PWD/src/core/message.h \
+            $$PWD/src/core/messagesmodel.h \
+            $$PWD/src/core/messagesproxymodel.h \
+            $$PWD/src/definitions/definitions.h \
+            $$PWD/src/dynamic-shortcuts/dynamicshortcuts.h \
+            $$PWD/src/dynamic-shortcuts/dynamicshortcutswidget.h \
+            $$PWD/src/dynamic-shortcuts/shortcutbutton.h \
+            $$PWD/src/dynamic-shortcuts/shortcutcatcher.h \
+            $$PWD/src/exceptions/applicationexception.h \
+            $$PWD/src/exceptions/ioexception.h \
+            $$PWD/src/gui/baselineedit.h \
+            $$PWD/src/gui/basetoolbar.h \
+            $$PWD/src/gui/colorlabel.h \
+            $$PWD/src/gui/comboboxwithstatus.h \
+            $$PWD/src/gui/dialogs/formabout.h \
+            $$PWD/src/gui/dialogs/formaddaccount.h \
+            $$PWD/src/gui/dialogs/formbackupdatabasesettings.h \
+            $$PWD/src/gui/dialogs/formdatabasecleanup.h \
+            $$PWD/src/gui/dialogs/formmain.h \
+            $$PWD/src/gui/dialogs/formrestoredatabasesettings.h \
+            $$PWD/src/gui/dialogs/formsettings.h \
+            $$PWD/src/gui/dialogs/formupdate.h \
+            $$PWD/src/gui/dialogs/formupdatestatistics.h \
+            $$PWD/src/gui/edittableview.h \
+            $$PWD/src/gui/feedmessageviewer.h \
+            $$PWD/src/gui/feedstoolbar.h \
+            $$PWD/src/gui/feedsview.h \
+            $$PWD/src/gui/labelwithstatus.h \
+            $$PWD/src/gui/lineeditwithstatus.h \
+            $$PWD/src/gui/messagebox.h \
+            $$PWD/src/gui/messagessearchlineedit.h \
+            $$PWD/src/gui/messagestoolbar.h \
+            $$PWD/src/gui/messagesview.h \
+            $$PWD/src/gui/plaintoolbutton.h \
+            $$PWD/src/gui/retentionpolicyedit.h \
+            $$PWD/src/gui/squeezelabel.h \
+            $$PWD/src/gui/statusbar.h \
+            $$PWD/src/gui/styleditemdelegatewithoutfocus.h \
+            $$PWD/src/gui/systemtrayicon.h \
+            $$PWD/src/gui/tabbar.h \
+            $$PWD/src/gui/tabcontent.h \
+            $$PWD/src/gui/tabwidget.h \
+            $$PWD/src/gui/timespinbox.h \
+            $$PWD/src/gui/toolbareditor.h \
+            $$PWD/src/gui/widgetwithstatus.h \
+            $$PWD/src/miscellaneous/application.h \
+            $$PWD/src/miscellaneous/asynclogger.h \
+            $$PWD/src/miscellaneous/autosaver.h \
+            $$PWD/src/miscellaneous/cancellationtoken.h \
+            $$PWD/src/miscellaneous/databasecleaner.h \
+            $$PWD/src/miscellaneous/databasefactory.h \
+            $$PWD/src/miscellaneous/databasequeries.h \
+            $$PWD/src/miscellaneous/debugging.h \
+            $$PWD/src/miscellaneous/iconfactory.h \
+            $$PWD/src/miscellaneous/iofactory.h \
+            $$PWD/src/miscellaneous/knownmessagesfilter.h \
+            $$PWD/src/miscellaneous/localization.h \
+            $$PWD/src/miscellaneous/mutex.h \
+            $$PWD/src/miscellaneous/settings.h \
+            $$PWD/src/miscellaneous/settingsproperties.h \
+            $$PWD/src/miscellaneous/simplecrypt/simplecrypt.h \
+            $$PWD/src/miscellaneous/skinfactory.h \
+            $$PWD/src/miscellaneous/systemfactory.h \
+            $$PWD/src/miscellaneous/textfactory.h \
+            $$PWD/src/network-web/basenetworkaccessmanager.h \
+            $$PWD/src/network-web/downloader.h \
+            $$PWD/src/network-web/downloadmanager.h \
+            $$PWD/src/network-web/networkfactory.h \
+            $$PWD/src/network-web/silentnetworkaccessmanager.h \
+            $$PWD/src/network-web/webfactory.h \
+            $$PWD/src/qtsingleapplication/qtlocalpeer.h \
+            $$PWD/src/qtsingleapplication/qtlockedfile.h \
+            $$PWD/src/qtsingleapplication/qtsingleapplication.h \
+            $$PWD/src/qtsingleapplication/qtsinglecoreapplication.h \
+            $$PWD/src/services/abstract/accountcheckmodel.h \
+            $$PWD/src/services/abstract/category.h \
+            $$PWD/src/services/abstract/feed.h \
+            $$PWD/src/services/abstract/gui/formfeeddetails.h \
+            $$PWD/src/services/abstract/recyclebin.h \
+            $$PWD/src/services/abstract/rootitem.h \
+            $$PWD/src/services/abstract/serviceentrypoint.h \
+            $$PWD/src/services/abstract/serviceroot.h \
+            $$PWD/src/services/owncloud/definitions.h \
+            $$PWD/src/services/owncloud/gui/formeditowncloudaccount.h \
+            $$PWD/src/services/owncloud/gui/formowncloudfeeddetails.h \
+            $$PWD/src/services/owncloud/network/owncloudnetworkfactory.h \
+            $$PWD/src/services/owncloud/owncloudfeed.h \
+            $$PWD/src/services/owncloud/owncloudserviceentrypoint.h \
+            $$PWD/src/services/owncloud/owncloudserviceroot.h \
+            $$PWD/src/services/standard/gui/formstandardcategorydetails.h \
+            $$PWD/src/services/standard/gui/formstandardfeeddetails.h \
+            $$PWD/src/services/standard/gui/formstandardimportexport.h \
+            $$PWD/src/services/standard/standardcategory.h \
+            $$PWD/src/services/standard/standardfeed.h \
+            $$PWD/src/services/standard/standardfeedsimportexportmodel.h \
+            $$PWD/src/services/standard/standardserviceentrypoint.h \
+            $$PWD/src/services/standard/standardserviceroot.h \
+            $$PWD/src/services/tt-rss/definitions.h \
+            $$PWD/src/services/tt-rss/gui/formttrssfeeddetails.h \
+            $$PWD/src/services/tt-rss/network/ttrssnetworkfactory.h \
+            $$PWD/src/services/tt-rss/ttrssfeed.h \
+            $$PWD/src/services/tt-rss/ttrssserviceentrypoint.h \
+            $$PWD/src/services/tt-rss/ttrssserviceroot.h \
+            $$PWD/src/gui/settings/settingspanel.h \
+            $$PWD/src/gui/settings/settingsgeneral.h \
+            $$PWD/src/gui/settings/settingsdatabase.h \
+            $$PWD/src/gui/settings/settingsshortcuts.h \
+            $$PWD/src/gui/settings/settingsgui.h \
+            $$PWD/src/gui/settings/settingslocalization.h \
+            $$PWD/src/gui/settings/settingsbrowsermail.h \
+            $$PWD/src/gui/settings/settingsfeedsmessages.h \
+            $$PWD/src/gui/settings/settingsdownloads.h \
+            $$PWD/src/miscellaneous/feedreader.h \
+            $$PWD/src/miscellaneous/headlessupdater.h \
+            $$PWD/src/services/standard/atomparser.h \
+            $$PWD/src/services/standard/feedparser.h \
+            $$PWD/src/services/standard/rdfparser.h \
+            $$PWD/src/services/standard/rssparser.h \
+            $$PWD/src/services/abstract/cacheforserviceroot.h \
+            $$PWD/src/services/abstract/syncoperationqueue.h \
+            $$PWD/src/services/tt-rss/gui/formeditttrssaccount.h \
+            $$PWD/src/gui/guiutilities.h \
+            $$PWD/src/core/messagesmodelcache.h \
+            $$PWD/src/core/messagesmodelsqllayer.h \
+            $$PWD/src/gui/treeviewcolumnsmenu.h \
+            $$PWD/src/miscellaneous/externaltool.h
+
+SOURCES +=  $$PWD/src/core/feeddownloader.cpp \
+            $$PWD/src/core/feedfailuretracker.cpp \
+            $$PWD/src/core/feedsmodel.cpp \
+            $$PWD/src/core/feedsproxymodel.cpp \
+            $$PWD/src/core/feedupdatestatistics.cpp \
+            $$PWD/src/core/message.cpp \
+            $$PWD/src/core/messagesmodel.cpp \
+            $$PWD/src/core/messagesproxymodel.cpp \
+            $$PWD/src/dynamic-shortcuts/dynamicshortcuts.cpp \
+            $$PWD/src/dynamic-shortcuts/dynamicshortcutswidget.cpp \
+            $$PWD/src/dynamic-shortcuts/shortcutbutton.cpp \
+            $$PWD/src/dynamic-shortcuts/shortcutcatcher.cpp \
+            $$PWD/src/exceptions/applicationexception.cpp \
+            $$PWD/src/exceptions/ioexception.cpp \
+            $$PWD/src/gui/baselineedit.cpp \
+            $$PWD/src/gui/basetoolbar.cpp \
+            $$PWD/src/gui/colorlabel.cpp \
+            $$PWD/src/gui/comboboxwithstatus.cpp \
+            $$PWD/src/gui/dialogs/formabout.cpp \
+            $$PWD/src/gui/dialogs/formaddaccount.cpp \
+            $$PWD/src/gui/dialogs/formbackupdatabasesettings.cpp \
+            $$PWD/src/gui/dialogs/formdatabasecleanup.cpp \
+            $$PWD/src/gui/dialogs/formmain.cpp \
+            $$PWD/src/gui/dialogs/formrestoredatabasesettings.cpp \
+            $$PWD/src/gui/dialogs/formsettings.cpp \
+            $$PWD/src/gui/dialogs/formupdate.cpp \
+            $$PWD/src/gui/dialogs/formupdatestatistics.cpp \
+            $$PWD/src/gui/edittableview.cpp \
+            $$PWD/src/gui/feedmessageviewer.cpp \
+            $$PWD/src/gui/feedstoolbar.cpp \
+            $$PWD/src/gui/feedsview.cpp \
+            $$PWD/src/gui/labelwithstatus.cpp \
+            $$PWD/src/gui/lineeditwithstatus.cpp \
+            $$PWD/src/gui/messagebox.cpp \
+            $$PWD/src/gui/messagessearchlineedit.cpp \
+            $$PWD/src/gui/messagestoolbar.cpp \
+            $$PWD/src/gui/messagesview.cpp \
+            $$PWD/src/gui/plaintoolbutton.cpp \
+            $$PWD/src/gui/retentionpolicyedit.cpp \
+            $$PWD/src/gui/squeezelabel.cpp \
+            $$PWD/src/gui/statusbar.cpp \
+            $$PWD/src/gui/styleditemdelegatewithoutfocus.cpp \
+            $$PWD/src/gui/systemtrayicon.cpp \
+            $$PWD/src/gui/tabbar.cpp \
+            $$PWD/src/gui/tabcontent.cpp \
+            $$PWD/src/gui/tabwidget.cpp \
+            $$PWD/src/gui/timespinbox.cpp \
+            $$PWD/src/gui/toolbareditor.cpp \
+            $$PWD/src/gui/widgetwithstatus.cpp \
+            $$PWD/src/miscellaneous/application.cpp \
+            $$PWD/src/miscellaneous/asynclogger.cpp \
+            $$PWD/src/miscellaneous/autosaver.cpp \
+            $$PWD/src/miscellaneous/cancellationtoken.cpp \
+            $$PWD/src/miscellaneous/databasecleaner.cpp \
+            $$PWD/src/miscellaneous/databasefactory.cpp \
+            $$PWD/src/miscellaneous/databasequeries.cpp \
+            $$PWD/src/miscellaneous/debugging.cpp \
+            $$PWD/src/miscellaneous/iconfactory.cpp \
+            $$PWD/src/miscellaneous/iofactory.cpp \
+            $$PWD/src/miscellaneous/knownmessagesfilter.cpp \
+            $$PWD/src/miscellaneous/localization.cpp \
+            $$PWD/src/miscellaneous/mutex.cpp \
+            $$PWD/src/miscellaneous/settings.cpp \
+            $$PWD/src/miscellaneous/simplecrypt/simplecrypt.cpp \
+            $$PWD/src/miscellaneous/skinfactory.cpp \
+            $$PWD/src/miscellaneous/systemfactory.cpp \
+            $$PWD/src/miscellaneous/textfactory.cpp \
+            $$PWD/src/network-web/basenetworkaccessmanager.cpp \
+            $$PWD/src/network-web/downloader.cpp \
+            $$PWD/src/network-web/downloadmanager.cpp \
+            $$PWD/src/network-web/networkfactory.cpp \
+            $$PWD/src/network-web/silentnetworkaccessmanager.cpp \
+            $$PWD/src/network-web/webfactory.cpp \
+            $$PWD/src/qtsingleapplication/qtlocalpeer.cpp \
+            $$PWD/src/qtsingleapplication/qtlockedfile.cpp \
+            $$PWD/src/qtsingleapplication/qtsingleapplication.cpp \
+            $$PWD/src/qtsingleapplication/qtsinglecoreapplication.cpp \
+            $$PWD/src/services/abstract/accountcheckmodel.cpp \
+            $$PWD/src/services/abstract/category.cpp \
+            $$PWD/src/services/abstract/feed.cpp \
+            $$PWD/src/services/abstract/gui/formfeeddetails.cpp \
+            $$PWD/src/services/abstract/recyclebin.cpp \
+            $$PWD/src/services/abstract/rootitem.cpp \
+            $$PWD/src/services/abstract/serviceentrypoint.cpp \
+            $$PWD/src/services/abstract/serviceroot.cpp \
+            $$PWD/src/services/owncloud/gui/formeditowncloudaccount.cpp \
+            $$PWD/src/services/owncloud/gui/formowncloudfeeddetails.cpp \
+            $$PWD/src/services/owncloud/network/owncloudnetworkfactory.cpp \
+            $$PWD/src/services/owncloud/owncloudfeed.cpp \
+            $$PWD/src/services/owncloud/owncloudserviceentrypoint.cpp \
+            $$PWD/src/services/owncloud/owncloudserviceroot.cpp \
+            $$PWD/src/services/standard/gui/formstandardcategorydetails.cpp \
+            $$PWD/src/services/standard/gui/formstandardfeeddetails.cpp \
+            $$PWD/src/services/standard/gui/formstandardimportexport.cpp \
+            $$PWD/src/services/standard/standardcategory.cpp \
+            $$PWD/src/services/standard/standardfeed.cpp \
+            $$PWD/src/services/standard/standardfeedsimportexportmodel.cpp \
+            $$PWD/src/services/standard/standardserviceentrypoint.cpp \
+            $$PWD/src/services/standard/standardserviceroot.cpp \
+            $$PWD/src/services/tt-rss/gui/formttrssfeeddetails.cpp \
+            $$PWD/src/services/tt-rss/network/ttrssnetworkfactory.cpp \
+            $$PWD/src/services/tt-rss/ttrssfeed.cpp \
+            $$PWD/src/services/tt-rss/ttrssserviceentrypoint.cpp \
+            $$PWD/src/services/tt-rss/ttrssserviceroot.cpp \
+            $$PWD/src/gui/settings/settingspanel.cpp \
+            $$PWD/src/gui/settings/settingsgeneral.cpp \
+            $$PWD/src/gui/settings/settingsdatabase.cpp \
+            $$PWD/src/gui/settings/settingsshortcuts.cpp \
+            $$PWD/src/gui/settings/settingsgui.cpp \
+            $$PWD/src/gui/settings/settingslocalization.cpp \
+            $$PWD/src/gui/settings/settingsbrowsermail.cpp \
+            $$PWD/src/gui/settings/settingsfeedsmessages.cpp \
+            $$PWD/src/gui/settings/settingsdownloads.cpp \
+            $$PWD/src/miscellaneous/feedreader.cpp \
+            $$PWD/src/miscellaneous/headlessupdater.cpp \
+            $$PWD/src/services/standard/atomparser.cpp \
+            $$PWD/src/services/standard/feedparser.cpp \
+            $$PWD/src/services/standard/rdfparser.cpp \
+            $$PWD/src/services/standard/rssparser.cpp \
+            $$PWD/src/services/abstract/cacheforserviceroot.cpp \
+            $$PWD/src/services/abstract/syncoperationqueue.cpp \
+            $$PWD/src/services/tt-rss/gui/formeditttrssaccount.cpp \
+            $$PWD/src/gui/guiutilities.cpp \
+            $$PWD/src/core/messagesmodelcache.cpp \
+            $$PWD/src/core/messagesmodelsqllayer.cpp \
+            $$PWD/src/gui/treeviewcolumnsmenu.cpp \
+            $$PWD/src/miscellaneous/externaltool.cpp
+
+OBJECTIVE_SOURCES += $$PWD/src/miscellaneous/disablewindowtabbing.mm
+
+FORMS +=    $$PWD/src/gui/toolbareditor.ui \
+            $$PWD/src/network-web/downloaditem.ui \
+            $$PWD/src/network-web/downloadmanager.ui \
+            $$PWD/src/gui/dialogs/formabout.ui \
+            $$PWD/src/gui/dialogs/formaddaccount.ui \
+            $$PWD/src/gui/dialogs/formbackupdatabasesettings.ui \
+            $$PWD/src/gui/dialogs/formdatabasecleanup.ui \
+            $$PWD/src/gui/dialogs/formmain.ui \
+            $$PWD/src/gui/dialogs/formrestoredatabasesettings.ui \
+            $$PWD/src/gui/dialogs/formsettings.ui \
+            $$PWD/src/gui/dialogs/formupdate.ui \
+            $$PWD/src/gui/dialogs/formupdatestatistics.ui \
+            $$PWD/src/services/abstract/gui/formfeeddetails.ui \
+            $$PWD/src/services/owncloud/gui/formeditowncloudaccount.ui \
+            $$PWD/src/services/standard/gui/formstandardcategorydetails.ui \
+            $$PWD/src/services/standard/gui/formstandardimportexport.ui \
+            $$PWD/src/gui/settings/settingsgeneral.ui \
+            $$PWD/src/gui/settings/settingsdatabase.ui \
+            $$PWD/src/gui/settings/settingsshortcuts.ui \
+            $$PWD/src/gui/settings/settingsgui.ui \
+            $$PWD/src/gui/settings/settingslocalization.ui \
+            $$PWD/src/gui/settings/settingsbrowsermail.ui \
+            $$PWD/src/gui/settings/settingsfeedsmessages.ui \
+            $$PWD/src/gui/settings/settingsdownloads.ui \
+            $$PWD/src/services/tt-rss/gui/formeditttrssaccount.ui
+
+equals(USE_WEBENGINE, true) {
+  HEADERS +=    $$PWD/src/gui/locationlineedit.h \
+                $$PWD/src/gui/webviewer.h \
+                $$PWD/src/gui/webbrowser.h \
+                $$PWD/src/gui/discoverfeedsbutton.h \
+                $$PWD/src/network-web/googlesuggest.h \
+                $$PWD/src/network-web/webpage.h \
+                $$PWD/src/network-web/rssguardschemehandler.h \
+                $$PWD/src/services/inoreader/definitions.h \
+                $$PWD/src/services/inoreader/inoreaderentrypoint.h \
+                $$PWD/src/services/inoreader/network/inoreadernetworkfactory.h \
+                $$PWD/src/services/inoreader/inoreaderserviceroot.h \
+                $$PWD/src/services/inoreader/gui/formeditinoreaderaccount.h \
+                $$PWD/src/services/inoreader/inoreaderfeed.h \
+                $$PWD/src/network-web/oauth2service.h \
+                $$PWD/src/gui/dialogs/oauthlogin.h
+
+  SOURCES +=    $$PWD/src/gui/locationlineedit.cpp \
+                $$PWD/src/gui/webviewer.cpp \
+                $$PWD/src/gui/webbrowser.cpp \
+                $$PWD/src/gui/discoverfeedsbutton.cpp \
+                $$PWD/src/network-web/googlesuggest.cpp \
+                $$PWD/src/network-web/webpage.cpp \
+                $$PWD/src/network-web/rssguardschemehandler.cpp \
+                $$PWD/src/services/inoreader/inoreaderentrypoint.cpp \
+                $$PWD/src/services/inoreader/network/inoreadernetworkfactory.cpp \
+                $$PWD/src/services/inoreader/inoreaderserviceroot.cpp \
+                $$PWD/src/services/inoreader/gui/formeditinoreaderaccount.cpp \
+                $$PWD/src/services/inoreader/inoreaderfeed.cpp \
+                $$PWD/src/network-web/oauth2service.cpp \
+                $$PWD/src/gui/dialogs/oauthlogin.cpp
+
+  # Add AdBlock sources.
+  HEADERS +=    $$PWD/src/network-web/adblock/adblockaddsubscriptiondialog.h \
+                $$PWD/src/network-web/adblock/adblockdialog.h \
+                $$PWD/src/network-web/adblock/adblockicon.h \
+                $$PWD/src/network-web/adblock/adblockmanager.h \
+                $$PWD/src/network-web/adblock/adblockmatcher.h \
+                $$PWD/src/network-web/adblock/adblockrule.h \
+                $$PWD/src/network-web/adblock/adblocksearchtree.h \
+                $$PWD/src/network-web/adblock/adblocksubscription.h \
+                $$PWD/src/network-web/adblock/adblocktokenindex.h \
+                $$PWD/src/network-web/adblock/adblocktreewidget.h \
+                $$PWD/src/network-web/adblock/adblockurlinterceptor.h \
+                $$PWD/src/network-web/urlinterceptor.h \
+                $$PWD/src/network-web/networkurlinterceptor.h \
+                $$PWD/src/miscellaneous/simpleregexp.h \
+                $$PWD/src/gui/treewidget.h
+
+  SOURCES +=    $$PWD/src/network-web/adblock/adblockaddsubscriptiondialog.cpp \
+                $$PWD/src/network-web/adblock/adblockdialog.cpp \
+                $$PWD/src/network-web/adblock/adblockicon.cpp \
+                $$PWD/src/network-web/adblock/adblockmanager.cpp \
+                $$PWD/src/network-web/adblock/adblockmatcher.cpp \
+                $$PWD/src/network-web/adblock/adblockrule.cpp \
+                $$PWD/src/network-web/adblock/adblocksearchtree.cpp \
+                $$PWD/src/network-web/adblock/adblocksubscription.cpp \
+                $$PWD/src/network-web/adblock/adblocktokenindex.cpp \
+                $$PWD/src/network-web/adblock/adblocktreewidget.cpp \
+                $$PWD/src/network-web/adblock/adblockurlinterceptor.cpp \
+                $$PWD/src/network-web/networkurlinterceptor.cpp \
+                $$PWD/src/miscellaneous/simpleregexp.cpp \
+                $$PWD/src/gui/treewidget.cpp
+
+  FORMS +=      $$PWD/src/network-web/adblock/adblockaddsubscriptiondialog.ui \
+                $$PWD/src/network-web/adblock/adblockdialog.ui \
+                $$PWD/src/services/inoreader/gui/formeditinoreaderaccount.ui \
+                $$PWD/src/gui/dialogs/oauthlogin.ui
+}
+else {
+  HEADERS +=    $$PWD/src/gui/messagepreviewer.h \
+                $$PWD/src/gui/messagetextbrowser.h \
+                $$PWD/src/gui/newspaperpreviewer.h
+
+  SOURCES +=    $$PWD/src/gui/messagepreviewer.cpp \
+                $$PWD/src/gui/messagetextbrowser.cpp \
+                $$PWD/src/gui/newspaperpreviewer.cpp
+
+  FORMS +=      $$PWD/src/gui/messagepreviewer.ui \
+                $$PWD/src/gui/newspaperpreviewer.ui
+}
+
+INCLUDEPATH +=  $$PWD/. \
+                $$PWD/src \
+                $$PWD/src/gui \
+                $$PWD/src/gui/dialogs \
+                $$PWD/src/dynamic-shortcuts
+
+mac {
+  LIBS += -framework AppKit
+}
@@ -18,22 +18,36 @@
 
 #include "core/feeddownloader.h"
 
+#include "core/feedfailuretracker.h"
 #include "definitions/definitions.h"
+#include "miscellaneous/application.h"
+#include "miscellaneous/cancellationtoken.h"
+#include "miscellaneous/debugging.h"
+#include "miscellaneous/feedreader.h"
 #include "services/abstract/cacheforserviceroot.h"
 #include "services/abstract/feed.h"
 
 #include <QDebug>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QMutexLocker>
 #include <QString>
 #include <QThread>
 #include <QThreadPool>
 
+#include <algorithm>
+#include <cmath>
+
 FeedDownloader::FeedDownloader(QObject* parent)
-  : QObject(parent), m_feeds(QList<Feed*>()), m_mutex(new QMutex()), m_threadPool(new QThreadPool(this)),
+  : QObject(parent), m_feeds(QList<Feed*>()), m_interactiveFeeds(QList<Feed*>()), m_mutex(new QMutex()),
+  m_threadPool(new QThreadPool(this)), m_interactiveThreadPool(new QThreadPool(this)),
+  m_cancellation(new CancellationToken(this)),
   m_results(FeedDownloadResults()), m_feedsUpdated(0),
-  m_feedsUpdating(0), m_feedsOriginalCount(0) {
+  m_feedsUpdating(0), m_feedsOriginalCount(0), m_messagesObtained(0) {
   qRegisterMetaType<FeedDownloadResults>("FeedDownloadResults");
+  qRegisterMetaType<FeedDownloader::Priority>("FeedDownloader::Priority");
   m_threadPool->setMaxThreadCount(FEED_DOWNLOADER_MAX_THREADS);
+  m_interactiveThreadPool->setMaxThreadCount(FEED_DOWNLOADER_INTERACTIVE_THREADS);
 }
 
 FeedDownloader::~FeedDownloader() {
@@ -44,13 +58,78 @@ FeedDownloader::~FeedDownloader() {
 }
 
 bool FeedDownloader::isUpdateRunning() const {
-  return !m_feeds.isEmpty() || m_feedsUpdating > 0;
+  QMutexLocker locker(m_mutex);
+
+  return isUpdateRunningUnlocked();
+}
+
+bool FeedDownloader::isUpdateRunningUnlocked() const {
+  return !m_feeds.isEmpty() || !m_interactiveFeeds.isEmpty() || m_feedsUpdating > 0;
+}
+
+bool FeedDownloader::appendToRunningUpdate(const QList<Feed*>& feeds, Priority priority) {
+  QMutexLocker locker(m_mutex);
+
+  // Running update cannot be finalized while we hold the mutex, so
+  // appended feeds are guaranteed to be processed within it.
+  if (!isUpdateRunningUnlocked() || m_cancellation->isCancelled()) {
+    return false;
+  }
+
+  enqueueFeeds(feeds, priority);
+
+  // Idle worker threads are occupied from the thread of downloader.
+  QMetaObject::invokeMethod(this, "updateQueuedFeeds", Qt::QueuedConnection);
+  return true;
+}
+
+void FeedDownloader::enqueueFeeds(const QList<Feed*>& feeds, Priority priority) {
+  foreach (Feed* feed, feeds) {
+    if (m_feedStartTimes.contains(feed) || m_interactiveFeeds.contains(feed)) {
+      // Feed is already being updated or it is waiting in the faster lane.
+      continue;
+    }
+    else if (priority == Interactive) {
+      // Feeds moved from background lane are already counted.
+      if (!m_feeds.removeOne(feed)) {
+        m_feedsOriginalCount++;
+      }
+
+      m_interactiveFeeds.append(feed);
+    }
+    else if (!m_feeds.contains(feed)) {
+      m_feeds.append(feed);
+      m_feedsOriginalCount++;
+    }
+  }
+}
+
+bool FeedDownloader::startFeedUpdate(Feed* feed, QThreadPool* thread_pool) {
+  feed->setCancellationToken(m_cancellation);
+  connect(feed, &Feed::messagesObtained, this, &FeedDownloader::oneFeedUpdateFinished,
+          (Qt::ConnectionType)(Qt::UniqueConnection | Qt::AutoConnection));
+
+  if (thread_pool->tryStart(feed)) {
+    m_feedStartTimes.insert(feed, m_roundTimer.elapsed());
+    m_feedsUpdating++;
+    return true;
+  }
+  else {
+    // We want to start update of some feeds but all working threads are occupied.
+    return false;
+  }
+}
+
+void FeedDownloader::updateQueuedFeeds() {
+  QMutexLocker locker(m_mutex);
+
+  updateAvailableFeeds();
 }
 
 void FeedDownloader::updateAvailableFeeds() {
   QList<CacheForServiceRoot*> caches;
 
-  foreach (const Feed* feed, m_feeds) {
+  foreach (const Feed* feed, m_interactiveFeeds + m_feeds) {
     CacheForServiceRoot* cache = dynamic_cast<CacheForServiceRoot*>(feed->getParentServiceRoot());
 
     if (cache != nullptr && !caches.contains(cache)) {
@@ -63,22 +142,17 @@ void FeedDownloader::updateAvailableFeeds() {
     cache->saveAllCachedData(false);
   }
 
-  while (!m_feeds.isEmpty()) {
-    connect(m_feeds.first(), &Feed::messagesObtained, this, &FeedDownloader::oneFeedUpdateFinished,
-            (Qt::ConnectionType)(Qt::UniqueConnection | Qt::AutoConnection));
+  // Interactive lane has its own threads, so it never waits for background feeds.
+  while (!m_interactiveFeeds.isEmpty() && startFeedUpdate(m_interactiveFeeds.first(), m_interactiveThreadPool)) {
+    m_interactiveFeeds.removeFirst();
+  }
 
-    if (m_threadPool->tryStart(m_feeds.first())) {
-      m_feeds.removeFirst();
-      m_feedsUpdating++;
-    }
-    else {
-      // We want to start update of some feeds but all working threads are occupied.
-      break;
-    }
+  while (!m_feeds.isEmpty() && startFeedUpdate(m_feeds.first(), m_threadPool)) {
+    m_feeds.removeFirst();
   }
 }
 
-void FeedDownloader::updateFeeds(const QList<Feed*>& feeds) {
+void FeedDownloader::updateFeeds(const QList<Feed*>& feeds, Priority priority) {
   QMutexLocker locker(m_mutex);
 
   if (feeds.isEmpty()) {
@@ -87,10 +161,19 @@ void FeedDownloader::updateFeeds(const QList<Feed*>& feeds) {
   }
   else {
     qDebug().nospace() << "Starting feed updates from worker in thread: \'" << QThread::currentThreadId() << "\'.";
-    m_feeds = feeds;
-    m_feedsOriginalCount = m_feeds.size();
+    m_feeds.clear();
+    m_interactiveFeeds.clear();
+    m_feedsOriginalCount = 0;
     m_results.clear();
     m_feedsUpdated = m_feedsUpdating = 0;
+    m_feedStartTimes.clear();
+    m_cancellation->reset();
+    enqueueFeeds(feeds, priority);
+    m_feedDurations.clear();
+    m_messagesObtained = 0;
+    m_succeededFeeds.clear();
+    m_failedFeeds.clear();
+    m_roundTimer.start();
 
     // Job starts now.
     emit updateStarted();
@@ -100,42 +183,80 @@ void FeedDownloader::updateFeeds(const QList<Feed*>& feeds) {
 }
 
 void FeedDownloader::stopRunningUpdate() {
+  QMutexLocker locker(m_mutex);
+
   m_threadPool->clear();
+  m_interactiveThreadPool->clear();
   m_feeds.clear();
+  m_interactiveFeeds.clear();
+  m_cancellation->cancel();
 }
 
 void FeedDownloader::oneFeedUpdateFinished(const QList<Message>& messages, bool error_during_obtaining) {
-  QMutexLocker locker(m_mutex);
-
-  m_feedsUpdated++;
-  m_feedsUpdating--;
   Feed* feed = qobject_cast<Feed*>(sender());
+  QMutexLocker locker(m_mutex);
 
   disconnect(feed, &Feed::messagesObtained, this, &FeedDownloader::oneFeedUpdateFinished);
 
+  m_feedDurations.append(m_roundTimer.elapsed() - m_feedStartTimes.take(feed));
+  m_messagesObtained += messages.size();
+
   // Now, we check if there are any feeds we would like to update too.
   updateAvailableFeeds();
 
-  // Now make sure, that messages are actually stored to SQL in a locked state.
-  qDebug().nospace() << "Saving messages of feed "
-                     << feed->id() << " in thread: \'"
-                     << QThread::currentThreadId() << "\'.";
-  int updated_messages = feed->updateMessages(messages, error_during_obtaining);
-
-  /*
-     QMetaObject::invokeMethod(feed, "updateMessages", Qt::BlockingQueuedConnection,
-                            Q_RETURN_ARG(int, updated_messages),
-                            Q_ARG(QList<Message>, messages));
-   */
+  // Nothing of the feed is stored if update was stopped.
+  if (!m_cancellation->isCancelled()) {
+    // Storing can take long, so the mutex is released meanwhile and feeds can
+    // be appended to the update. Feed is still counted as updating, so the
+    // update cannot be finalized in the meantime.
+    locker.unlock();
+
+    // Now make sure, that messages are actually stored to SQL in a locked state.
+    qCDebugHot(LOG_FEEDS).nospace() << "Saving messages of feed "
+                       << feed->id() << " in thread: \'"
+                       << QThread::currentThreadId() << "\'.";
+    QElapsedTimer storing_timer;
+
+    storing_timer.start();
+    int updated_messages = feed->updateMessages(messages, error_during_obtaining);
+    FeedUpdateMetrics& metrics = feed->updateMetrics();
+
+    metrics.m_storingTime = storing_timer.elapsed();
+    metrics.m_newMessages = qMax(updated_messages, 0);
+    metrics.m_finished = QDateTime::currentDateTime();
+    qApp->feedReader()->updateStatistics()->record(metrics);
+
+    /*
+       QMetaObject::invokeMethod(feed, "updateMessages", Qt::BlockingQueuedConnection,
+                              Q_RETURN_ARG(int, updated_messages),
+                              Q_ARG(QList<Message>, messages));
+     */
+
+    locker.relock();
+
+    if (metrics.m_error || error_during_obtaining) {
+      m_failedFeeds.append(QPair<Feed*, QNetworkReply::NetworkError>(feed, metrics.m_networkError));
+    }
+    else {
+      m_succeededFeeds.append(feed);
+    }
 
-  if (updated_messages > 0) {
-    m_results.appendUpdatedFeed(QPair<QString, int>(feed->title(), updated_messages));
+    if (updated_messages > 0) {
+      m_results.appendUpdatedFeed(QPair<QString, int>(feed->title(), updated_messages));
+    }
+    else if (metrics.m_unchangedPayload) {
+      m_results.appendUnchangedFeed();
+    }
   }
 
-  qDebug("Made progress in feed updates, total feeds count %d/%d (id of feed is %d).", m_feedsUpdated, m_feedsOriginalCount, feed->id());
+  m_feedsUpdated++;
+  m_feedsUpdating--;
+
+  qCDebugHot(LOG_FEEDS, "Made progress in feed updates, total feeds count %d/%d (id of feed is %d).",
+             m_feedsUpdated, m_feedsOriginalCount, feed->id());
   emit updateProgress(feed, m_feedsUpdated, m_feedsOriginalCount);
 
-  if (m_feeds.isEmpty() && m_feedsUpdating <= 0) {
+  if (m_feeds.isEmpty() && m_interactiveFeeds.isEmpty() && m_feedsUpdating <= 0) {
     finalizeUpdate();
   }
 }
@@ -143,6 +264,11 @@ void FeedDownloader::oneFeedUpdateFinished(const QList<Message>& messages, bool
 void FeedDownloader::finalizeUpdate() {
   qDebug().nospace() << "Finished feed updates in thread: \'" << QThread::currentThreadId() << "\'.";
   m_results.sort();
+  recordFailures();
+
+  if (ScopedTiming::isEnabled() && m_roundTimer.isValid()) {
+    reportThroughput();
+  }
 
   // Update of feeds has finished.
   // NOTE: This means that now "update lock" can be unlocked
@@ -151,7 +277,61 @@ void FeedDownloader::finalizeUpdate() {
   emit updateFinished(m_results);
 }
 
-FeedDownloadResults::FeedDownloadResults() : m_updatedFeeds(QList<QPair<QString, int>>()) {}
+void FeedDownloader::recordFailures() {
+  FeedFailureTracker* tracker = qApp->feedReader()->failureTracker();
+  bool local_outage = m_succeededFeeds.isEmpty() && m_failedFeeds.size() >= FEED_OUTAGE_MIN_FEEDS;
+
+  for (int i = 0; i < m_failedFeeds.size() && local_outage; i++) {
+    local_outage = FeedFailureTracker::isConnectionFailure(m_failedFeeds.at(i).second);
+  }
+
+  if (local_outage) {
+    // When nothing can be reached, it is our network which is down, not the feeds.
+    qWarning("None of %d feeds could be connected to, network is probably down, failures are not recorded.",
+             m_failedFeeds.size());
+  }
+  else {
+    foreach (Feed* feed, m_succeededFeeds) {
+      tracker->recordSuccess(feed);
+    }
+
+    for (int i = 0; i < m_failedFeeds.size(); i++) {
+      tracker->recordFailure(m_failedFeeds.at(i).first, m_failedFeeds.at(i).second);
+    }
+  }
+
+  m_succeededFeeds.clear();
+  m_failedFeeds.clear();
+  tracker->save();
+}
+
+void FeedDownloader::reportThroughput() const {
+  QVector<qint64> durations = m_feedDurations;
+  const double seconds = qMax(m_roundTimer.elapsed(), qint64(1)) / 1000.0;
+  QJsonObject report;
+
+  std::sort(durations.begin(), durations.end());
+
+  // Nearest-rank percentile of per-feed durations (download + parsing + storing).
+  auto percentile = [&durations](double p) {
+    return durations.isEmpty() ? qint64(0) : durations.at(qMax(0, int(std::ceil(p * durations.size())) - 1));
+  };
+
+  report[QSL("timing")] = QSL("FeedDownloader::updateFeeds");
+  report[QSL("feeds")] = m_feedsUpdated;
+  report[QSL("messages")] = m_messagesObtained;
+  report[QSL("ms")] = double(m_roundTimer.elapsed());
+  report[QSL("feeds_per_s")] = m_feedsUpdated / seconds;
+  report[QSL("messages_per_s")] = m_messagesObtained / seconds;
+  report[QSL("p50_ms")] = double(percentile(0.50));
+  report[QSL("p95_ms")] = double(percentile(0.95));
+  report[QSL("p99_ms")] = double(percentile(0.99));
+  report[QSL("max_ms")] = double(percentile(1.0));
+
+  ScopedTiming::report(QJsonDocument(report).toJson(QJsonDocument::Compact));
+}
+
+FeedDownloadResults::FeedDownloadResults() : m_updatedFeeds(QList<QPair<QString, int>>()), m_unchangedFeeds(0) {}
 
 QString FeedDownloadResults::overview(int how_many_feeds) const {
   QStringList result;
@@ -166,6 +346,10 @@ QString FeedDownloadResults::overview(int how_many_feeds) const {
     res_str += QObject::tr("\n\n+ %n other feeds.", 0, m_updatedFeeds.size() - how_many_feeds);
   }
 
+  if (m_unchangedFeeds > 0) {
+    res_str += QObject::tr("\n\n%n feeds were skipped because they did not change.", 0, m_unchangedFeeds);
+  }
+
   return res_str;
 }
 
@@ -173,6 +357,14 @@ void FeedDownloadResults::appendUpdatedFeed(const QPair<QString, int>& feed) {
   m_updatedFeeds.append(feed);
 }
 
+void FeedDownloadResults::appendUnchangedFeed() {
+  m_unchangedFeeds++;
+}
+
+int FeedDownloadResults::unchangedFeeds() const {
+  return m_unchangedFeeds;
+}
+
 void FeedDownloadResults::sort() {
   qSort(m_updatedFeeds.begin(), m_updatedFeeds.end(), FeedDownloadResults::lessThan);
 }
@@ -183,6 +375,7 @@ bool FeedDownloadResults::lessThan(const QPair<QString, int>& lhs, const QPair<Q
 
 void FeedDownloadResults::clear() {
   m_updatedFeeds.clear();
+  m_unchangedFeeds = 0;
 }
 
 QList<QPair<QString, int>> FeedDownloadResults::updatedFeeds() const {
@@ -21,10 +21,15 @@
 
 #include <QObject>
 
+#include <QElapsedTimer>
+#include <QHash>
+#include <QNetworkReply>
 #include <QPair>
+#include <QVector>
 
 #include "core/message.h"
 
+class CancellationToken;
 class Feed;
 class QThreadPool;
 class QMutex;
@@ -37,7 +42,10 @@ class FeedDownloadResults {
     QList<QPair<QString, int>> updatedFeeds() const;
     QString overview(int how_many_feeds) const;
 
+    int unchangedFeeds() const;
+
     void appendUpdatedFeed(const QPair<QString, int>& feed);
+    void appendUnchangedFeed();
     void sort();
     void clear();
 
@@ -47,6 +55,9 @@ class FeedDownloadResults {
 
     // QString represents title if the feed, int represents count of newly downloaded messages.
     QList<QPair<QString, int>> m_updatedFeeds;
+
+    // Count of feeds whose downloaded payload did not change since their last update.
+    int m_unchangedFeeds;
 };
 
 // This class offers means to "update" feeds and "special" categories.
@@ -56,24 +67,41 @@ class FeedDownloader : public QObject {
 
   public:
 
+    // Lanes of feed updates. Interactive feeds are the ones the user asked for
+    // explicitly, they have their own worker threads and jump ahead of
+    // background (scheduled or bulk) feeds.
+    enum Priority {
+      Background = 0,
+      Interactive = 1
+    };
+
     // Constructors and destructors.
     explicit FeedDownloader(QObject* parent = 0);
     virtual ~FeedDownloader();
 
+    // NOTE: This method is thread-safe.
     bool isUpdateRunning() const;
 
+    // Adds given feeds to the running update.
+    // Returns false if no update is running, then new update must be started.
+    // NOTE: This method is thread-safe.
+    bool appendToRunningUpdate(const QList<Feed*>& feeds, Priority priority);
+
   public slots:
 
     // Performs update of all feeds from the "feeds" parameter.
     // New messages are downloaded for each feed and they
     // are stored persistently in the database.
     // Appropriate signals are emitted.
-    void updateFeeds(const QList<Feed*>& feeds);
+    void updateFeeds(const QList<Feed*>& feeds, Priority priority = Background);
 
-    // Stops running update.
+    // Stops running update, network operations of feeds
+    // which are being updated are aborted immediately.
+    // NOTE: This method is thread-safe.
     void stopRunningUpdate();
 
   private slots:
+    void updateQueuedFeeds();
     void oneFeedUpdateFinished(const QList<Message>& messages, bool error_during_obtaining);
 
   signals:
@@ -92,16 +120,38 @@ class FeedDownloader : public QObject {
     void updateProgress(const Feed* feed, int current, int total);
 
   private:
+
+    // Caller must hold the mutex.
+    bool isUpdateRunningUnlocked() const;
+
     void updateAvailableFeeds();
+    bool startFeedUpdate(Feed* feed, QThreadPool* thread_pool);
+    void enqueueFeeds(const QList<Feed*>& feeds, Priority priority);
     void finalizeUpdate();
+    void recordFailures();
+    void reportThroughput() const;
 
     QList<Feed*> m_feeds;
+    QList<Feed*> m_interactiveFeeds;
     QMutex* m_mutex;
     QThreadPool* m_threadPool;
+    QThreadPool* m_interactiveThreadPool;
+    CancellationToken* m_cancellation;
     FeedDownloadResults m_results;
     int m_feedsUpdated;
     int m_feedsUpdating;
     int m_feedsOriginalCount;
+
+    // Throughput statistics of running update round.
+    QElapsedTimer m_roundTimer;
+    QHash<const Feed*, qint64> m_feedStartTimes;
+    QVector<qint64> m_feedDurations;
+    int m_messagesObtained;
+
+    // Outcomes of feeds finished in running update round, they are
+    // passed to failure tracker at once when the round finishes.
+    QList<Feed*> m_succeededFeeds;
+    QList<QPair<Feed*, QNetworkReply::NetworkError>> m_failedFeeds;
 };
 
 #endif // FEEDDOWNLOADER_H
@@ -0,0 +1,238 @@
+// This file is part of RSS Guard.
+
+//
+// Copyright (C) 2011-2017 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#include "core/feedfailuretracker.h"
+
+#include "definitions/definitions.h"
+#include "miscellaneous/application.h"
+#include "services/abstract/feed.h"
+#include "services/abstract/serviceroot.h"
+
+#include <QDateTime>
+#include <QMutexLocker>
+#include <QStringList>
+#include <QThread>
+
+FeedFailureTracker::FeedFailureTracker() : m_loaded(false), m_dirty(false) {}
+
+FeedFailureTracker::~FeedFailureTracker() {}
+
+void FeedFailureTracker::recordSuccess(const Feed* feed) {
+  QMutexLocker locker(&m_mutex);
+
+  ensureLoaded();
+
+  if (m_feeds.remove(feedKey(feed)) > 0) {
+    m_dirty = true;
+  }
+
+  if (m_hosts.remove(feedHost(feed)) > 0) {
+    m_dirty = true;
+  }
+}
+
+void FeedFailureTracker::recordFailure(const Feed* feed, QNetworkReply::NetworkError error) {
+  QMutexLocker locker(&m_mutex);
+  const qint64 now = QDateTime::currentMSecsSinceEpoch();
+  const QString key = feedKey(feed);
+  const QString host = feedHost(feed);
+
+  ensureLoaded();
+
+  FeedFailureState& state = m_feeds[key];
+
+  state.m_accountId = feed->getParentServiceRoot() == nullptr ? -1 : feed->getParentServiceRoot()->accountId();
+  state.m_feedCustomId = feed->customId();
+  state.m_failures++;
+  state.m_lastFailure = now;
+  state.m_nextAttempt = now + backoffDelay(state.m_failures);
+
+  qDebug("Feed '%s' failed %d times in a row, postponing its scheduled updates by %lld seconds.",
+         qPrintable(feed->customId()), state.m_failures, (state.m_nextAttempt - now) / 1000);
+
+  if (!host.isEmpty()) {
+    if (isConnectionFailure(error)) {
+      HostCircuitState& circuit = m_hosts[host];
+
+      circuit.m_host = host;
+      circuit.m_failures++;
+
+      if (circuit.m_failures >= HOST_CIRCUIT_THRESHOLD) {
+        circuit.m_openUntil = now + HOST_CIRCUIT_OPEN_TIME;
+        qWarning("Host '%s' is unreachable, skipping its feeds for %d seconds.",
+                 qPrintable(host), HOST_CIRCUIT_OPEN_TIME / 1000);
+      }
+    }
+    else {
+      // Host did respond, just this feed is broken.
+      m_hosts.remove(host);
+    }
+  }
+
+  m_dirty = true;
+}
+
+bool FeedFailureTracker::isPostponed(const Feed* feed) {
+  QMutexLocker locker(&m_mutex);
+  const qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+  ensureLoaded();
+
+  return m_feeds.value(feedKey(feed)).m_nextAttempt > now || m_hosts.value(feedHost(feed)).m_openUntil > now;
+}
+
+QString FeedFailureTracker::description(const Feed* feed) {
+  QMutexLocker locker(&m_mutex);
+  const qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+  ensureLoaded();
+
+  const FeedFailureState state = m_feeds.value(feedKey(feed));
+  const HostCircuitState circuit = m_hosts.value(feedHost(feed));
+  QStringList lines;
+
+  if (state.m_failures > 0) {
+    lines.append(tr("Failed updates in a row: %1").arg(state.m_failures));
+
+    if (state.m_nextAttempt > now) {
+      lines.append(tr("Next scheduled update: %1").arg(QDateTime::fromMSecsSinceEpoch(state.m_nextAttempt)
+                                                       .toString(Qt::DefaultLocaleShortDate)));
+    }
+  }
+
+  if (circuit.m_openUntil > now) {
+    lines.append(tr("Host %1 is unreachable, its feeds are skipped until %2.")
+                 .arg(circuit.m_host,
+                      QDateTime::fromMSecsSinceEpoch(circuit.m_openUntil).toString(Qt::DefaultLocaleShortDate)));
+  }
+
+  return lines.join(QL1C('\n'));
+}
+
+void FeedFailureTracker::forgetFeed(int account_id, const QString& feed_custom_id) {
+  QMutexLocker locker(&m_mutex);
+
+  // State which is not loaded yet is read from DB later, without removed rows.
+  m_feeds.remove(feedKey(account_id, feed_custom_id));
+}
+
+void FeedFailureTracker::forgetAccount(int account_id) {
+  QMutexLocker locker(&m_mutex);
+  QMutableHashIterator<QString, FeedFailureState> i(m_feeds);
+
+  while (i.hasNext()) {
+    if (i.next().value().m_accountId == account_id) {
+      i.remove();
+    }
+  }
+}
+
+bool FeedFailureTracker::save() {
+  QMutexLocker locker(&m_mutex);
+
+  if (!m_dirty) {
+    return true;
+  }
+
+  QSqlDatabase db = database();
+
+  if (DatabaseQueries::storeFeedFailures(db, m_feeds.values()) &&
+      DatabaseQueries::storeHostCircuits(db, m_hosts.values())) {
+    m_dirty = false;
+    return true;
+  }
+  else {
+    qWarning("Failed to save failures of feeds.");
+    return false;
+  }
+}
+
+bool FeedFailureTracker::isConnectionFailure(QNetworkReply::NetworkError error) {
+  switch (error) {
+    case QNetworkReply::ConnectionRefusedError:
+    case QNetworkReply::RemoteHostClosedError:
+    case QNetworkReply::HostNotFoundError:
+    case QNetworkReply::TimeoutError:
+
+    // NOTE: Downloader aborts timed out requests, so they are reported as canceled.
+    case QNetworkReply::OperationCanceledError:
+    case QNetworkReply::TemporaryNetworkFailureError:
+    case QNetworkReply::NetworkSessionFailedError:
+    case QNetworkReply::ProxyConnectionRefusedError:
+    case QNetworkReply::ProxyConnectionClosedError:
+    case QNetworkReply::ProxyNotFoundError:
+    case QNetworkReply::ProxyTimeoutError:
+    case QNetworkReply::UnknownNetworkError:
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+void FeedFailureTracker::ensureLoaded() {
+  if (m_loaded) {
+    return;
+  }
+
+  QSqlDatabase db = database();
+  bool ok_feeds, ok_hosts;
+  const QList<FeedFailureState> failures = DatabaseQueries::getFeedFailures(db, &ok_feeds);
+  const QList<HostCircuitState> circuits = DatabaseQueries::getHostCircuits(db, &ok_hosts);
+
+  if (!ok_feeds || !ok_hosts) {
+    qWarning("Failed to load failures of feeds, starting with clean state.");
+  }
+
+  foreach (const FeedFailureState& state, failures) {
+    m_feeds.insert(feedKey(state.m_accountId, state.m_feedCustomId), state);
+  }
+
+  foreach (const HostCircuitState& circuit, circuits) {
+    m_hosts.insert(circuit.m_host, circuit);
+  }
+
+  m_loaded = true;
+}
+
+QSqlDatabase FeedFailureTracker::database() {
+  return QThread::currentThread() == qApp->thread() ?
+         qApp->database()->connection(QSL("FeedFailureTracker"), DatabaseFactory::FromSettings) :
+         qApp->database()->connection(QSL("feed_upd"), DatabaseFactory::FromSettings);
+}
+
+QString FeedFailureTracker::feedKey(int account_id, const QString& feed_custom_id) {
+  return QString::number(account_id) + QL1C(':') + feed_custom_id;
+}
+
+QString FeedFailureTracker::feedKey(const Feed* feed) {
+  const ServiceRoot* root = feed->getParentServiceRoot();
+
+  return feedKey(root == nullptr ? -1 : root->accountId(), feed->customId());
+}
+
+QString FeedFailureTracker::feedHost(const Feed* feed) {
+  return feed->updateHost();
+}
+
+qint64 FeedFailureTracker::backoffDelay(int failures) {
+  const qint64 delay = qMin(qint64(FEED_BACKOFF_BASE) << qBound(0, failures - 1, 16), qint64(FEED_BACKOFF_MAX));
+
+  // Equal jitter, so that feeds which failed together are not retried together.
+  return delay / 2 + qint64((double(qrand()) / RAND_MAX) * (delay / 2));
+}
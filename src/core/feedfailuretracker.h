@@ -0,0 +1,85 @@
+// This file is part of RSS Guard.
+
+//
+// Copyright (C) 2011-2017 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef FEEDFAILURETRACKER_H
+#define FEEDFAILURETRACKER_H
+
+#include <QCoreApplication>
+#include <QHash>
+#include <QMutex>
+#include <QNetworkReply>
+#include <QString>
+
+#include "miscellaneous/databasequeries.h"
+
+class Feed;
+
+// Keeps track of consecutive failures of feeds and of their hosts.
+//
+// Each failure of feed postpones its next scheduled update exponentially
+// (with jitter), so that broken feeds are not hammered with each auto-update.
+// Hosts which repeatedly cannot be connected to have their "circuit" opened,
+// then all feeds from such host are skipped for a while.
+// Manually requested updates are never postponed.
+//
+// State is loaded lazily from DB and it is saved after each update round.
+// NOTE: This class is thread-safe.
+class FeedFailureTracker {
+  Q_DECLARE_TR_FUNCTIONS(FeedFailureTracker)
+
+  public:
+    explicit FeedFailureTracker();
+    virtual ~FeedFailureTracker();
+
+    void recordSuccess(const Feed* feed);
+    void recordFailure(const Feed* feed, QNetworkReply::NetworkError error);
+
+    // Returns true if scheduled update of given feed should be skipped now.
+    bool isPostponed(const Feed* feed);
+
+    // Returns human-readable failure state of given feed, empty if feed is healthy.
+    QString description(const Feed* feed);
+
+    // Forgets failures of removed feed or of all feeds of removed account,
+    // their stored rows must be removed by the caller.
+    void forgetFeed(int account_id, const QString& feed_custom_id);
+    void forgetAccount(int account_id);
+
+    // Saves changed state to DB.
+    bool save();
+
+    // Returns true if given error means that remote host could not be reached at all.
+    static bool isConnectionFailure(QNetworkReply::NetworkError error);
+
+  private:
+    void ensureLoaded();
+
+    static QSqlDatabase database();
+    static QString feedKey(int account_id, const QString& feed_custom_id);
+    static QString feedKey(const Feed* feed);
+    static QString feedHost(const Feed* feed);
+    static qint64 backoffDelay(int failures);
+
+    QMutex m_mutex;
+    bool m_loaded;
+    bool m_dirty;
+    QHash<QString, FeedFailureState> m_feeds;
+    QHash<QString, HostCircuitState> m_hosts;
+};
+
+#endif // FEEDFAILURETRACKER_H
@@ -539,7 +539,8 @@ void FeedsModel::loadActivatedServiceAccounts() {
     }
   }
 
-  if (serviceRoots().isEmpty()) {
+  // Headless instance has no main form to show the dialog in.
+  if (serviceRoots().isEmpty() && !qApp->isHeadless()) {
     QTimer::singleShot(3000, []() {
       qApp->mainForm()->showAddAccountDialog();
     });
@@ -0,0 +1,143 @@
+// This file is part of RSS Guard.
+
+//
+// Copyright (C) 2011-2017 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#include "core/feedupdatestatistics.h"
+
+#include "definitions/definitions.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+
+qint64 FeedUpdateMetrics::totalTime() const {
+  return m_obtainingTime + m_storingTime;
+}
+
+qint64 FeedUpdateStatisticsEntry::averageTime() const {
+  return m_updates > 0 ? m_totalTime / m_updates : 0;
+}
+
+FeedUpdateStatistics::FeedUpdateStatistics(QObject* parent) : QObject(parent) {}
+
+FeedUpdateStatistics::~FeedUpdateStatistics() {}
+
+void FeedUpdateStatistics::record(const FeedUpdateMetrics& metrics) {
+  {
+    QMutexLocker locker(&m_mutex);
+    FeedUpdateStatisticsEntry& entry = m_entries[metrics.m_feedId];
+    const qint64 total_time = metrics.totalTime();
+
+    entry.m_last = metrics;
+    entry.m_updates++;
+    entry.m_errors += metrics.m_error ? 1 : 0;
+    entry.m_unchangedSkips += metrics.m_unchangedPayload ? 1 : 0;
+    entry.m_totalBytes += metrics.m_bytesReceived;
+    entry.m_totalTime += total_time;
+    entry.m_maxTime = qMax(entry.m_maxTime, total_time);
+  }
+
+  emit statisticsChanged();
+}
+
+void FeedUpdateStatistics::clear() {
+  {
+    QMutexLocker locker(&m_mutex);
+
+    m_entries.clear();
+  }
+
+  emit statisticsChanged();
+}
+
+QList<FeedUpdateStatisticsEntry> FeedUpdateStatistics::entries() const {
+  QMutexLocker locker(&m_mutex);
+
+  return m_entries.values();
+}
+
+QByteArray FeedUpdateStatistics::toJson() const {
+  QJsonArray feeds;
+
+  foreach (const FeedUpdateStatisticsEntry& entry, entries()) {
+    QJsonObject feed;
+
+    feed[QSL("id")] = entry.m_last.m_feedId;
+    feed[QSL("title")] = entry.m_last.m_feedTitle;
+    feed[QSL("url")] = entry.m_last.m_feedUrl;
+    feed[QSL("updates")] = entry.m_updates;
+    feed[QSL("errors")] = entry.m_errors;
+    feed[QSL("unchanged_skips")] = entry.m_unchangedSkips;
+    feed[QSL("total_bytes")] = double(entry.m_totalBytes);
+    feed[QSL("average_ms")] = double(entry.averageTime());
+    feed[QSL("max_ms")] = double(entry.m_maxTime);
+    feed[QSL("last_finished")] = entry.m_last.m_finished.toString(Qt::ISODate);
+    feed[QSL("last_error")] = entry.m_last.m_error;
+    feed[QSL("last_unchanged")] = entry.m_last.m_unchangedPayload;
+    feed[QSL("last_http_status")] = entry.m_last.m_httpStatusCode;
+    feed[QSL("last_redirects")] = entry.m_last.m_redirectCount;
+    feed[QSL("last_bytes")] = double(entry.m_last.m_bytesReceived);
+    feed[QSL("last_obtained_messages")] = entry.m_last.m_obtainedMessages;
+    feed[QSL("last_new_messages")] = entry.m_last.m_newMessages;
+    feed[QSL("last_obtaining_ms")] = double(entry.m_last.m_obtainingTime);
+    feed[QSL("last_network_ms")] = double(entry.m_last.m_networkTime);
+    feed[QSL("last_decoding_ms")] = double(entry.m_last.m_decodingTime);
+    feed[QSL("last_parsing_ms")] = double(entry.m_last.m_parsingTime);
+    feed[QSL("last_storing_ms")] = double(entry.m_last.m_storingTime);
+    feed[QSL("last_total_ms")] = double(entry.m_last.totalTime());
+    feeds.append(feed);
+  }
+
+  return QJsonDocument(feeds).toJson(QJsonDocument::Indented);
+}
+
+QByteArray FeedUpdateStatistics::toCsv() const {
+  QStringList lines;
+
+  lines << QSL("id,title,url,updates,errors,unchanged_skips,total_bytes,average_ms,max_ms,last_finished,last_error,last_unchanged,"
+               "last_http_status,last_redirects,last_bytes,last_obtained_messages,last_new_messages,"
+               "last_obtaining_ms,last_network_ms,last_decoding_ms,last_parsing_ms,last_storing_ms,last_total_ms");
+
+  // Quote textual fields, embedded quotes are doubled.
+  auto quoted = [](QString text) -> QString {
+    return QL1C('"') + text.replace(QL1C('"'), QSL("\"\"")) + QL1C('"');
+  };
+
+  foreach (const FeedUpdateStatisticsEntry& entry, entries()) {
+    const FeedUpdateMetrics& last = entry.m_last;
+    QStringList fields;
+
+    fields << QString::number(last.m_feedId) << quoted(last.m_feedTitle) << quoted(last.m_feedUrl)
+           << QString::number(entry.m_updates) << QString::number(entry.m_errors)
+           << QString::number(entry.m_unchangedSkips)
+           << QString::number(entry.m_totalBytes) << QString::number(entry.averageTime())
+           << QString::number(entry.m_maxTime) << last.m_finished.toString(Qt::ISODate)
+           << QString::number(last.m_error ? 1 : 0) << QString::number(last.m_unchangedPayload ? 1 : 0)
+           << QString::number(last.m_httpStatusCode)
+           << QString::number(last.m_redirectCount) << QString::number(last.m_bytesReceived)
+           << QString::number(last.m_obtainedMessages) << QString::number(last.m_newMessages)
+           << QString::number(last.m_obtainingTime) << QString::number(last.m_networkTime)
+           << QString::number(last.m_decodingTime) << QString::number(last.m_parsingTime)
+           << QString::number(last.m_storingTime) << QString::number(last.totalTime());
+    lines << fields.join(QL1C(','));
+  }
+
+  // Terminate last line too.
+  lines << QString();
+  return lines.join(QL1C('\n')).toUtf8();
+}
@@ -0,0 +1,95 @@
+// This file is part of RSS Guard.
+
+//
+// Copyright (C) 2011-2017 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef FEEDUPDATESTATISTICS_H
+#define FEEDUPDATESTATISTICS_H
+
+#include <QObject>
+
+#include <QDateTime>
+#include <QHash>
+#include <QMutex>
+#include <QNetworkReply>
+
+// Measurements of single update of single feed.
+// Times are in milliseconds, phases which were not measured stay zero.
+struct FeedUpdateMetrics {
+  int m_feedId = 0;
+  QString m_feedTitle;
+  QString m_feedUrl;
+  QDateTime m_finished;
+  bool m_error = false;
+  QNetworkReply::NetworkError m_networkError = QNetworkReply::NoError;
+  int m_httpStatusCode = 0;
+  int m_redirectCount = 0;
+  qint64 m_bytesReceived = 0;
+  int m_obtainedMessages = 0;
+  int m_newMessages = 0;
+
+  // Downloaded payload was identical to last processed one, so it was not processed.
+  bool m_unchangedPayload = false;
+
+  // Whole obtaining phase, it covers network, decoding and parsing phases.
+  qint64 m_obtainingTime = 0;
+  qint64 m_networkTime = 0;
+  qint64 m_decodingTime = 0;
+  qint64 m_parsingTime = 0;
+  qint64 m_storingTime = 0;
+
+  qint64 totalTime() const;
+};
+
+// Aggregated measurements of all updates of single feed.
+struct FeedUpdateStatisticsEntry {
+  FeedUpdateMetrics m_last;
+  int m_updates = 0;
+  int m_errors = 0;
+  int m_unchangedSkips = 0;
+  qint64 m_totalBytes = 0;
+  qint64 m_totalTime = 0;
+  qint64 m_maxTime = 0;
+
+  qint64 averageTime() const;
+};
+
+// Thread-safe registry of feed update measurements.
+// Feed downloader records into it, GUI reads from it.
+class FeedUpdateStatistics : public QObject {
+  Q_OBJECT
+
+  public:
+    explicit FeedUpdateStatistics(QObject* parent = nullptr);
+    virtual ~FeedUpdateStatistics();
+
+    void record(const FeedUpdateMetrics& metrics);
+    void clear();
+
+    QList<FeedUpdateStatisticsEntry> entries() const;
+
+    QByteArray toJson() const;
+    QByteArray toCsv() const;
+
+  signals:
+    void statisticsChanged();
+
+  private:
+    mutable QMutex m_mutex;
+    QHash<int, FeedUpdateStatisticsEntry> m_entries;
+};
+
+#endif // FEEDUPDATESTATISTICS_H
@@ -63,6 +63,35 @@ QString Enclosures::encodeEnclosuresToString(const QList<Enclosure>& enclosures)
   return enclosures_str.join(QString(ENCLOSURES_OUTER_SEPARATOR));
 }
 
+bool MessageCompression::isCompressed(const QString& data) {
+  return data.startsWith(QL1S(COMPRESSION_PREFIX));
+}
+
+QString MessageCompression::compress(const QString& data) {
+  if (data.size() < COMPRESSION_THRESHOLD || isCompressed(data)) {
+    return data;
+  }
+
+  const QString compressed = QL1S(COMPRESSION_PREFIX) + QString::fromLatin1(qCompress(data.toUtf8()).toBase64());
+
+  return compressed.size() < data.size() ? compressed : data;
+}
+
+QString MessageCompression::decompress(const QString& data) {
+  if (!isCompressed(data)) {
+    return data;
+  }
+
+  const QByteArray uncompressed = qUncompress(QByteArray::fromBase64(data.midRef(int(sizeof(COMPRESSION_PREFIX) - 1)).toLatin1()));
+
+  if (uncompressed.isEmpty()) {
+    qWarning("Stored message data cannot be decompressed, keeping them as they are.");
+    return data;
+  }
+
+  return QString::fromUtf8(uncompressed);
+}
+
 Message::Message() {
   m_title = m_url = m_author = m_contents = m_feedId = m_customId = m_customHash = QSL("");
   m_enclosures = QList<Enclosure>();
@@ -89,8 +118,9 @@ Message Message::fromSqlRecord(const QSqlRecord& record, bool* result) {
   message.m_url = record.value(MSG_DB_URL_INDEX).toString();
   message.m_author = record.value(MSG_DB_AUTHOR_INDEX).toString();
   message.m_created = TextFactory::parseDateTime(record.value(MSG_DB_DCREATED_INDEX).value<qint64>());
-  message.m_contents = record.value(MSG_DB_CONTENTS_INDEX).toString();
-  message.m_enclosures = Enclosures::decodeEnclosuresFromString(record.value(MSG_DB_ENCLOSURES_INDEX).toString());
+  message.m_contents = MessageCompression::decompress(record.value(MSG_DB_CONTENTS_INDEX).toString());
+  message.m_enclosures = Enclosures::decodeEnclosuresFromString(
+    MessageCompression::decompress(record.value(MSG_DB_ENCLOSURES_INDEX).toString()));
   message.m_accountId = record.value(MSG_DB_ACCOUNT_ID_INDEX).toInt();
   message.m_customId = record.value(MSG_DB_CUSTOM_ID_INDEX).toString();
   message.m_customHash = record.value(MSG_DB_CUSTOM_HASH_INDEX).toString();
@@ -42,6 +42,18 @@ class Enclosures {
     static QString encodeEnclosuresToString(const QList<Enclosure>& enclosures);
 };
 
+// Compression of large textual message data stored in DB.
+// Compressed data are marked with prefix, so both forms can be stored side by side.
+class MessageCompression {
+  public:
+    static bool isCompressed(const QString& data);
+
+    // Returns compressed data if it is long enough and compression pays off,
+    // otherwise returns data as they are.
+    static QString compress(const QString& data);
+    static QString decompress(const QString& data);
+};
+
 // Represents single message.
 class Message {
   public:
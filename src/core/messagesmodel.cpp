@@ -23,6 +23,7 @@
 #include "miscellaneous/application.h"
 #include "miscellaneous/databasefactory.h"
 #include "miscellaneous/databasequeries.h"
+#include "miscellaneous/debugging.h"
 #include "miscellaneous/iconfactory.h"
 #include "miscellaneous/textfactory.h"
 #include "services/abstract/recyclebin.h"
@@ -32,7 +33,8 @@
 
 MessagesModel::MessagesModel(QObject* parent)
   : QSqlQueryModel(parent), MessagesModelSqlLayer(),
-  m_cache(new MessagesModelCache(this)), m_messageHighlighter(NoHighlighting), m_customDateFormat(QString()) {
+  m_cache(new MessagesModelCache(this)), m_messageHighlighter(NoHighlighting), m_customDateFormat(QString()),
+  m_selectedItem(nullptr), m_isBinLoaded(false) {
   setupFonts();
   setupIcons();
   setupHeaderData();
@@ -51,17 +53,109 @@ void MessagesModel::setupIcons() {
 }
 
 void MessagesModel::repopulate() {
+  ScopedTiming timing("MessagesModel::repopulate");
+
+  // Changed fields were already written to database, fresh
+  // query therefore contains them and overlay is not needed.
   m_cache->clear();
   setQuery(selectStatement(), m_db);
 
   while (canFetchMore()) {
     fetchMore();
   }
+
+  loadRowStates();
+  timing.setItems(rowCount());
+}
+
+void MessagesModel::loadRowStates() {
+  const int row_count = rowCount();
+
+  m_rowIds.resize(row_count);
+  m_rowFlags.resize(row_count);
+  m_rowsById.clear();
+  m_rowsById.reserve(row_count);
+  m_unreadRows.clear();
+
+  for (int i = 0; i < row_count; i++) {
+    quint8 flags = 0;
+
+    if (QSqlQueryModel::data(index(i, MSG_DB_READ_INDEX)).toInt() == 1) {
+      flags |= RowRead;
+    }
+    else {
+      m_unreadRows.insert(i, true);
+    }
+
+    if (QSqlQueryModel::data(index(i, MSG_DB_IMPORTANT_INDEX)).toInt() == 1) {
+      flags |= RowImportant;
+    }
+
+    if (QSqlQueryModel::data(index(i, MSG_DB_DELETED_INDEX)).toInt() == 1) {
+      flags |= RowDeleted;
+    }
+
+    if (QSqlQueryModel::data(index(i, MSG_DB_PDELETED_INDEX)).toInt() == 1) {
+      flags |= RowPermanentlyDeleted;
+    }
+
+    const int id = QSqlQueryModel::data(index(i, MSG_DB_ID_INDEX)).toInt();
+
+    m_rowIds[i] = id;
+    m_rowFlags[i] = flags;
+    m_rowsById.insert(id, i);
+  }
+}
+
+void MessagesModel::updateRowState(int row_index, int column, const QVariant& value) {
+  if (row_index < 0 || row_index >= m_rowFlags.size()) {
+    return;
+  }
+
+  RowStateFlag flag;
+
+  switch (column) {
+    case MSG_DB_READ_INDEX:
+      flag = RowRead;
+      break;
+
+    case MSG_DB_IMPORTANT_INDEX:
+      flag = RowImportant;
+      break;
+
+    case MSG_DB_DELETED_INDEX:
+      flag = RowDeleted;
+      break;
+
+    case MSG_DB_PDELETED_INDEX:
+      flag = RowPermanentlyDeleted;
+      break;
+
+    default:
+      return;
+  }
+
+  if (value.toInt() == 1) {
+    m_rowFlags[row_index] |= flag;
+  }
+  else {
+    m_rowFlags[row_index] &= ~flag;
+  }
+
+  if (flag == RowRead) {
+    if (value.toInt() == 1) {
+      m_unreadRows.remove(row_index);
+    }
+    else {
+      m_unreadRows.insert(row_index, true);
+    }
+  }
 }
 
 bool MessagesModel::setData(const QModelIndex& index, const QVariant& value, int role) {
   Q_UNUSED(role)
-  m_cache->setData(index, value, record(index.row()));
+  m_cache->setData(index, value);
+  updateRowState(index.row(), index.column(), value);
   return true;
 }
 
@@ -77,6 +171,7 @@ void MessagesModel::setupFonts() {
 
 void MessagesModel::loadMessages(RootItem* item) {
   m_selectedItem = item;
+  m_isBinLoaded = qobject_cast<RecycleBin*>(item) != nullptr;
 
   if (item == nullptr) {
     setFilter(QSL(DEFAULT_SQL_MESSAGES_FILTER));
@@ -97,21 +192,19 @@ void MessagesModel::loadMessages(RootItem* item) {
 }
 
 bool MessagesModel::setMessageImportantById(int id, RootItem::Importance important) {
-  for (int i = 0; i < rowCount(); i++) {
-    int found_id = data(i, MSG_DB_ID_INDEX, Qt::EditRole).toInt();
+  const int row = rowForMessageId(id);
 
-    if (found_id == id) {
-      bool set = setData(index(i, MSG_DB_IMPORTANT_INDEX), important);
+  if (row < 0) {
+    return false;
+  }
 
-      if (set) {
-        emit dataChanged(index(i, 0), index(i, MSG_DB_CUSTOM_HASH_INDEX));
-      }
+  bool set = setData(index(row, MSG_DB_IMPORTANT_INDEX), important);
 
-      return set;
-    }
+  if (set) {
+    emit dataChanged(index(row, 0), index(row, MSG_DB_CUSTOM_HASH_INDEX));
   }
 
-  return false;
+  return set;
 }
 
 void MessagesModel::highlightMessages(MessagesModel::MessageHighlighter highlight) {
@@ -121,11 +214,21 @@ void MessagesModel::highlightMessages(MessagesModel::MessageHighlighter highligh
 }
 
 int MessagesModel::messageId(int row_index) const {
-  return data(row_index, MSG_DB_ID_INDEX, Qt::EditRole).toInt();
+  return m_rowIds.value(row_index);
+}
+
+int MessagesModel::rowForMessageId(int message_id) const {
+  return m_rowsById.value(message_id, -1);
+}
+
+int MessagesModel::nextUnreadRow(int row_index) const {
+  QMap<int, bool>::const_iterator unread = m_unreadRows.lowerBound(row_index);
+
+  return unread == m_unreadRows.constEnd() ? -1 : unread.key();
 }
 
 RootItem::Importance MessagesModel::messageImportance(int row_index) const {
-  return (RootItem::Importance) data(row_index, MSG_DB_IMPORTANT_INDEX, Qt::EditRole).toInt();
+  return rowHasFlag(row_index, RowImportant) ? RootItem::Important : RootItem::NotImportant;
 }
 
 RootItem* MessagesModel::loadedItem() const {
@@ -146,8 +249,27 @@ void MessagesModel::reloadWholeLayout() {
   emit layoutChanged();
 }
 
+Message MessagesModel::messageStateAt(int row_index) const {
+  Message message;
+
+  message.m_id = messageId(row_index);
+  message.m_isRead = rowHasFlag(row_index, RowRead);
+  message.m_isImportant = rowHasFlag(row_index, RowImportant);
+  message.m_accountId = QSqlQueryModel::data(index(row_index, MSG_DB_ACCOUNT_ID_INDEX)).toInt();
+  message.m_customId = QSqlQueryModel::data(index(row_index, MSG_DB_CUSTOM_ID_INDEX)).toString();
+  message.m_customHash = QSqlQueryModel::data(index(row_index, MSG_DB_CUSTOM_HASH_INDEX)).toString();
+  message.m_feedId = QSqlQueryModel::data(index(row_index, MSG_DB_FEED_CUSTOM_ID_INDEX)).toString();
+  return message;
+}
+
 Message MessagesModel::messageAt(int row_index) const {
-  return Message::fromSqlRecord(m_cache->containsData(row_index) ? m_cache->record(row_index) : record(row_index));
+  QSqlRecord rec = record(row_index);
+
+  if (m_cache->containsData(row_index)) {
+    m_cache->applyToRecord(row_index, rec);
+  }
+
+  return Message::fromSqlRecord(rec);
 }
 
 void MessagesModel::setupHeaderData() {
@@ -227,6 +349,10 @@ QVariant MessagesModel::data(const QModelIndex& idx, int role) const {
 
         return author_name.isEmpty() ? QSL("-") : author_name;
       }
+      else if (index_column == MSG_DB_CONTENTS_INDEX) {
+        // Contents might be stored compressed, decompress them so that searching works.
+        return MessageCompression::decompress(QSqlQueryModel::data(idx, role).toString());
+      }
       else if (index_column != MSG_DB_IMPORTANT_INDEX && index_column != MSG_DB_READ_INDEX) {
         return QSqlQueryModel::data(idx, role);
       }
@@ -236,28 +362,13 @@ QVariant MessagesModel::data(const QModelIndex& idx, int role) const {
     }
 
     case Qt::EditRole:
-      return m_cache->containsData(idx.row()) ? m_cache->data(idx) : QSqlQueryModel::data(idx, role);
+      return m_cache->containsData(idx.row(), idx.column()) ? m_cache->data(idx) : QSqlQueryModel::data(idx, role);
 
     case Qt::FontRole: {
-      QModelIndex idx_read = index(idx.row(), MSG_DB_READ_INDEX);
-      QVariant data_read = data(idx_read, Qt::EditRole);
-      const bool is_bin = qobject_cast<RecycleBin*>(loadedItem()) != nullptr;
-      bool is_deleted;
-
-      if (is_bin) {
-        QModelIndex idx_del = index(idx.row(), MSG_DB_PDELETED_INDEX);
-
-        is_deleted = data(idx_del, Qt::EditRole).toBool();
-      }
-      else {
-        QModelIndex idx_del = index(idx.row(), MSG_DB_DELETED_INDEX);
-
-        is_deleted = data(idx_del, Qt::EditRole).toBool();
-      }
+      const int row = idx.row();
+      const bool striked = rowHasFlag(row, m_isBinLoaded ? RowPermanentlyDeleted : RowDeleted);
 
-      const bool striked = is_deleted;
-
-      if (data_read.toBool()) {
+      if (rowHasFlag(row, RowRead)) {
         return striked ? m_normalStrikedFont : m_normalFont;
       }
       else {
@@ -267,19 +378,11 @@ QVariant MessagesModel::data(const QModelIndex& idx, int role) const {
 
     case Qt::ForegroundRole:
       switch (m_messageHighlighter) {
-        case HighlightImportant: {
-          QModelIndex idx_important = index(idx.row(), MSG_DB_IMPORTANT_INDEX);
-          QVariant dta = m_cache->containsData(idx_important.row()) ? m_cache->data(idx_important) : QSqlQueryModel::data(idx_important);
-
-          return dta.toInt() == 1 ? QColor(Qt::blue) : QVariant();
-        }
+        case HighlightImportant:
+          return rowHasFlag(idx.row(), RowImportant) ? QColor(Qt::blue) : QVariant();
 
-        case HighlightUnread: {
-          QModelIndex idx_read = index(idx.row(), MSG_DB_READ_INDEX);
-          QVariant dta = m_cache->containsData(idx_read.row()) ? m_cache->data(idx_read) : QSqlQueryModel::data(idx_read);
-
-          return dta.toInt() == 0 ? QColor(Qt::blue) : QVariant();
-        }
+        case HighlightUnread:
+          return !rowHasFlag(idx.row(), RowRead) ? QColor(Qt::blue) : QVariant();
 
         case NoHighlighting:
         default:
@@ -290,16 +393,10 @@ QVariant MessagesModel::data(const QModelIndex& idx, int role) const {
       const int index_column = idx.column();
 
       if (index_column == MSG_DB_READ_INDEX) {
-        QModelIndex idx_read = index(idx.row(), MSG_DB_READ_INDEX);
-        QVariant dta = m_cache->containsData(idx_read.row()) ? m_cache->data(idx_read) : QSqlQueryModel::data(idx_read);
-
-        return dta.toInt() == 1 ? m_readIcon : m_unreadIcon;
+        return rowHasFlag(idx.row(), RowRead) ? m_readIcon : m_unreadIcon;
       }
       else if (index_column == MSG_DB_IMPORTANT_INDEX) {
-        QModelIndex idx_important = index(idx.row(), MSG_DB_IMPORTANT_INDEX);
-        QVariant dta = m_cache->containsData(idx_important.row()) ? m_cache->data(idx_important) : QSqlQueryModel::data(idx_important);
-
-        return dta.toInt() == 1 ? m_favoriteIcon : QVariant();
+        return rowHasFlag(idx.row(), RowImportant) ? m_favoriteIcon : QVariant();
       }
       else {
         return QVariant();
@@ -343,21 +440,19 @@ bool MessagesModel::setMessageRead(int row_index, RootItem::ReadStatus read) {
 }
 
 bool MessagesModel::setMessageReadById(int id, RootItem::ReadStatus read) {
-  for (int i = 0; i < rowCount(); i++) {
-    int found_id = data(i, MSG_DB_ID_INDEX, Qt::EditRole).toInt();
+  const int row = rowForMessageId(id);
 
-    if (found_id == id) {
-      bool set = setData(index(i, MSG_DB_READ_INDEX), read);
+  if (row < 0) {
+    return false;
+  }
 
-      if (set) {
-        emit dataChanged(index(i, 0), index(i, MSG_DB_CUSTOM_HASH_INDEX));
-      }
+  bool set = setData(index(row, MSG_DB_READ_INDEX), read);
 
-      return set;
-    }
+  if (set) {
+    emit dataChanged(index(row, 0), index(row, MSG_DB_CUSTOM_HASH_INDEX));
   }
 
-  return false;
+  return set;
 }
 
 bool MessagesModel::switchMessageImportance(int row_index) {
@@ -398,19 +493,22 @@ bool MessagesModel::switchBatchMessageImportance(const QModelIndexList& messages
   QStringList message_ids;
 
   QList<QPair<Message, RootItem::Importance>> message_states;
+  const bool needs_messages = m_selectedItem->getParentServiceRoot()->requiresMessagesForStateChanges();
 
   // Obtain IDs of all desired messages.
   foreach (const QModelIndex& message, messages) {
-    const Message msg = messageAt(message.row());
-
-    RootItem::Importance message_importance = messageImportance((message.row()));
-    message_states.append(QPair<Message, RootItem::Importance>(msg, message_importance == RootItem::Important ?
-                                                               RootItem::NotImportant :
-                                                               RootItem::Important));
-    message_ids.append(QString::number(msg.m_id));
-    QModelIndex idx_msg_imp = index(message.row(), MSG_DB_IMPORTANT_INDEX);
+    const int row = message.row();
+    const RootItem::Importance message_importance = messageImportance(row);
+
+    if (needs_messages) {
+      message_states.append(QPair<Message, RootItem::Importance>(messageStateAt(row),
+                                                                 message_importance == RootItem::Important ?
+                                                                 RootItem::NotImportant :
+                                                                 RootItem::Important));
+    }
 
-    setData(idx_msg_imp, message_importance == RootItem::Important ?
+    message_ids.append(QString::number(messageId(row)));
+    setData(index(row, MSG_DB_IMPORTANT_INDEX), message_importance == RootItem::Important ?
             (int) RootItem::NotImportant :
             (int) RootItem::Important);
   }
@@ -433,19 +531,23 @@ bool MessagesModel::setBatchMessagesDeleted(const QModelIndexList& messages) {
   QStringList message_ids;
 
   QList<Message> msgs;
+  const bool needs_messages = m_selectedItem->getParentServiceRoot()->requiresMessagesForStateChanges();
 
   // Obtain IDs of all desired messages.
   foreach (const QModelIndex& message, messages) {
-    const Message msg = messageAt(message.row());
+    const int row = message.row();
+
+    if (needs_messages) {
+      msgs.append(messageStateAt(row));
+    }
 
-    msgs.append(msg);
-    message_ids.append(QString::number(msg.m_id));
+    message_ids.append(QString::number(messageId(row)));
 
-    if (qobject_cast<RecycleBin*>(m_selectedItem) != nullptr) {
-      setData(index(message.row(), MSG_DB_PDELETED_INDEX), 1);
+    if (m_isBinLoaded) {
+      setData(index(row, MSG_DB_PDELETED_INDEX), 1);
     }
     else {
-      setData(index(message.row(), MSG_DB_DELETED_INDEX), 1);
+      setData(index(row, MSG_DB_DELETED_INDEX), 1);
     }
   }
 
@@ -476,14 +578,18 @@ bool MessagesModel::setBatchMessagesRead(const QModelIndexList& messages, RootIt
   QStringList message_ids;
 
   QList<Message> msgs;
+  const bool needs_messages = m_selectedItem->getParentServiceRoot()->requiresMessagesForStateChanges();
 
   // Obtain IDs of all desired messages.
   foreach (const QModelIndex& message, messages) {
-    Message msg = messageAt(message.row());
+    const int row = message.row();
 
-    msgs.append(msg);
-    message_ids.append(QString::number(msg.m_id));
-    setData(index(message.row(), MSG_DB_READ_INDEX), (int) read);
+    if (needs_messages) {
+      msgs.append(messageStateAt(row));
+    }
+
+    message_ids.append(QString::number(messageId(row)));
+    setData(index(row, MSG_DB_READ_INDEX), (int) read);
   }
 
   reloadWholeLayout();
@@ -504,15 +610,19 @@ bool MessagesModel::setBatchMessagesRestored(const QModelIndexList& messages) {
   QStringList message_ids;
 
   QList<Message> msgs;
+  const bool needs_messages = m_selectedItem->getParentServiceRoot()->requiresMessagesForStateChanges();
 
   // Obtain IDs of all desired messages.
   foreach (const QModelIndex& message, messages) {
-    const Message msg = messageAt(message.row());
+    const int row = message.row();
+
+    if (needs_messages) {
+      msgs.append(messageStateAt(row));
+    }
 
-    msgs.append(msg);
-    message_ids.append(QString::number(msg.m_id));
-    setData(index(message.row(), MSG_DB_PDELETED_INDEX), 0);
-    setData(index(message.row(), MSG_DB_DELETED_INDEX), 0);
+    message_ids.append(QString::number(messageId(row)));
+    setData(index(row, MSG_DB_PDELETED_INDEX), 0);
+    setData(index(row, MSG_DB_DELETED_INDEX), 0);
   }
 
   reloadWholeLayout();
@@ -27,7 +27,10 @@
 #include "services/abstract/rootitem.h"
 
 #include <QFont>
+#include <QHash>
 #include <QIcon>
+#include <QMap>
+#include <QVector>
 
 class MessagesModelCache;
 
@@ -61,7 +64,16 @@ class MessagesModel : public QSqlQueryModel, public MessagesModelSqlLayer {
 
     // Returns message at given index.
     Message messageAt(int row_index) const;
+
+    // Returns message at given index with only identification
+    // and state fields filled, contents and enclosures are not loaded.
+    Message messageStateAt(int row_index) const;
     int messageId(int row_index) const;
+    int rowForMessageId(int message_id) const;
+
+    // Returns first row with unread message which is at or after given row,
+    // -1 is returned if there is no such row.
+    int nextUnreadRow(int row_index) const;
     RootItem::Importance messageImportance(int row_index) const;
 
     RootItem* loadedItem() const;
@@ -93,14 +105,40 @@ class MessagesModel : public QSqlQueryModel, public MessagesModelSqlLayer {
     bool setMessageReadById(int id, RootItem::ReadStatus read);
 
   private:
+
+    // Flags describing state of single message row.
+    enum RowStateFlag {
+      RowRead = 1,
+      RowImportant = 2,
+      RowDeleted = 4,
+      RowPermanentlyDeleted = 8
+    };
+
     void setupHeaderData();
     void setupFonts();
     void setupIcons();
 
+    // Loads IDs and state flags of all fetched rows into compact arrays,
+    // so that rendering roles do not need to touch SQL layer.
+    void loadRowStates();
+    void updateRowState(int row_index, int column, const QVariant& value);
+
+    inline bool rowHasFlag(int row_index, RowStateFlag flag) const {
+      return (m_rowFlags.value(row_index) & flag) == flag;
+    }
+
     MessagesModelCache* m_cache;
     MessageHighlighter m_messageHighlighter;
     QString m_customDateFormat;
     RootItem* m_selectedItem;
+    bool m_isBinLoaded;
+
+    QVector<int> m_rowIds;
+    QVector<quint8> m_rowFlags;
+    QHash<int, int> m_rowsById;
+
+    // Ordered set of rows with unread messages.
+    QMap<int, bool> m_unreadRows;
 
     QList<QString> m_headerData;
     QList<QString> m_tooltipData;
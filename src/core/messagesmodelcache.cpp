@@ -20,18 +20,22 @@
 
 #include "miscellaneous/textfactory.h"
 
-MessagesModelCache::MessagesModelCache(QObject* parent) : QObject(parent), m_msgCache(QHash<int, QSqlRecord>()) {}
+MessagesModelCache::MessagesModelCache(QObject* parent) : QObject(parent), m_msgCache(QHash<int, QHash<int, QVariant>>()) {}
 
 MessagesModelCache::~MessagesModelCache() {}
 
-void MessagesModelCache::setData(const QModelIndex& index, const QVariant& value, const QSqlRecord& record) {
-  if (!m_msgCache.contains(index.row())) {
-    m_msgCache[index.row()] = record;
-  }
+void MessagesModelCache::setData(const QModelIndex& index, const QVariant& value) {
+  m_msgCache[index.row()].insert(index.column(), value);
+}
 
-  m_msgCache[index.row()].setValue(index.column(), value);
+QVariant MessagesModelCache::data(const QModelIndex& idx) const {
+  return m_msgCache.value(idx.row()).value(idx.column());
 }
 
-QVariant MessagesModelCache::data(const QModelIndex& idx) {
-  return m_msgCache[idx.row()].value(idx.column());
+void MessagesModelCache::applyToRecord(int row_idx, QSqlRecord& record) const {
+  const QHash<int, QVariant> changes = m_msgCache.value(row_idx);
+
+  for (QHash<int, QVariant>::const_iterator i = changes.constBegin(); i != changes.constEnd(); i++) {
+    record.setValue(i.key(), i.value());
+  }
 }
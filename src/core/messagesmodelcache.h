@@ -23,9 +23,13 @@
 
 #include "core/message.h"
 
+#include <QHash>
 #include <QModelIndex>
+#include <QSqlRecord>
 #include <QVariant>
 
+// Overlay of message fields which were changed in the model
+// but not yet reloaded from database. Only changed columns are stored.
 class MessagesModelCache : public QObject {
   Q_OBJECT
 
@@ -37,20 +41,23 @@ class MessagesModelCache : public QObject {
       return m_msgCache.contains(row_idx);
     }
 
-    inline QSqlRecord record(int row_idx) const {
-      return m_msgCache.value(row_idx);
+    inline bool containsData(int row_idx, int column) const {
+      return m_msgCache.contains(row_idx) && m_msgCache[row_idx].contains(column);
     }
 
     inline void clear() {
       m_msgCache.clear();
     }
 
-    void setData(const QModelIndex& index, const QVariant& value, const QSqlRecord& record);
+    void setData(const QModelIndex& index, const QVariant& value);
 
-    QVariant data(const QModelIndex& idx);
+    QVariant data(const QModelIndex& idx) const;
+
+    // Overwrites fields of given record with changed values of given row.
+    void applyToRecord(int row_idx, QSqlRecord& record) const;
 
   private:
-    QHash<int, QSqlRecord> m_msgCache;
+    QHash<int, QHash<int, QVariant>> m_msgCache;
 };
 
 #endif // MESSAGESMODELCACHE_H
@@ -49,19 +49,23 @@ QModelIndex MessagesProxyModel::getNextPreviousUnreadItemIndex(int default_row)
 }
 
 QModelIndex MessagesProxyModel::getNextUnreadItemIndex(int default_row, int max_row) const {
-  while (default_row <= max_row) {
-    // Get info if the message is read or not.
-    const QModelIndex proxy_index = index(default_row, MSG_DB_READ_INDEX);
-    const bool is_read = m_sourceModel->data(mapToSource(proxy_index).row(),
-                                             MSG_DB_READ_INDEX, Qt::EditRole).toInt() == 1;
+  if (default_row > max_row) {
+    return QModelIndex();
+  }
+
+  // NOTE: Proxy does not reorder rows, it only filters them out,
+  // thus unread rows of source model can be visited in their order.
+  int source_row = m_sourceModel->nextUnreadRow(mapToSource(index(default_row, MSG_DB_READ_INDEX)).row());
+
+  while (source_row >= 0) {
+    const QModelIndex proxy_index = mapFromSource(m_sourceModel->index(source_row, MSG_DB_READ_INDEX));
 
-    if (!is_read) {
+    if (proxy_index.isValid()) {
       // We found unread message, mark it.
-      return proxy_index;
-    }
-    else {
-      default_row++;
+      return proxy_index.row() <= max_row ? proxy_index : QModelIndex();
     }
+
+    source_row = m_sourceModel->nextUnreadRow(source_row + 1);
   }
 
   return QModelIndex();
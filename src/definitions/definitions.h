@@ -37,6 +37,12 @@
 #define ADBLOCK_CUSTOMLIST_NAME               "customlist.txt"
 #define ADBLOCK_LISTS_SUBDIRECTORY            "adblock"
 #define ADBLOCK_EASYLIST_URL                  "https://easylist-downloads.adblockplus.org/easylist.txt"
+#define ADBLOCK_MIN_TOKEN_LENGTH              2
+#define ADBLOCK_COMPILED_SUFFIX               ".compiled"
+#define ADBLOCK_COMPILED_MAGIC                0x52474142
+#define ADBLOCK_COMPILED_VERSION              1
+#define ADBLOCK_CSS_SELECTORS_PER_RULE        1000
+#define ADBLOCK_CSS_CACHE_SIZE                256
 #define DEFAULT_SQL_MESSAGES_FILTER           "0 > 1"
 #define MAX_MULTICOLUMN_SORT_STATES           3
 #define ENCLOSURES_OUTER_SEPARATOR            '#'
@@ -60,8 +66,38 @@
 #define DOWNLOAD_TIMEOUT                      15000
 #define MESSAGES_VIEW_DEFAULT_COL             170
 #define MESSAGES_VIEW_MINIMUM_COL             36
+#define MESSAGES_SQL_ID_CHUNK_SIZE            500
+#define CACHE_JOURNAL_COMPACT_THRESHOLD       1000
+#define RETENTION_STARTUP_DELAY               120000
+#define RETENTION_IDLE_INTERVAL               1800000
+#define RETENTION_CHUNK_INTERVAL              1000
+#define RETENTION_CHUNK_BUDGET                50
+#define RETENTION_CHUNK_SIZE                  200
+#define RETENTION_VACUUM_PAGES                128
+#define COMPRESSION_PREFIX                    "rssguard-zlib:"
+#define COMPRESSION_THRESHOLD                 512
+#define COMPRESSION_MIGRATION_RANGE           500
+#define LOG_RING_BUFFER_SIZE                  4096
+#define LOG_DRAIN_INTERVAL                    50
+#define HEADLESS_LOCK_ATTEMPTS                20
+#define HEADLESS_LOCK_RETRY_INTERVAL          3000
+#define LOG_FILE_MAX_SIZE                     2097152
+#define LOG_FILE_ROTATIONS                    3
+#define SYNC_DEFAULT_BATCH_SIZE               500
+#define SYNC_MAX_THREADS                      3
+#define SYNC_MAX_ATTEMPTS                     3
+#define SYNC_RETRY_DELAY                      1000
+#define NEWSPAPER_MESSAGES_BATCH              10
+#define NEWSPAPER_PRELOAD_DISTANCE            1000
 #define FEEDS_VIEW_COLUMN_COUNT               2
 #define FEED_DOWNLOADER_MAX_THREADS           6
+#define FEED_DOWNLOADER_INTERACTIVE_THREADS   2
+#define FEED_BACKOFF_BASE                     300000
+#define FEED_BACKOFF_MAX                      21600000
+#define FEED_OUTAGE_MIN_FEEDS                 3
+#define HOST_CIRCUIT_THRESHOLD                3
+#define HOST_CIRCUIT_OPEN_TIME                1800000
+#define FEED_IMPORT_MAX_THREADS               8
 #define DEFAULT_DAYS_TO_DELETE_MSG            14
 #define ELLIPSIS_LENGTH                       3
 #define MIN_CATEGORY_NAME_LENGTH              1
@@ -127,7 +163,7 @@
 #define APP_DB_SQLITE_FILE            "database.db"
 
 // Keep this in sync with schema versions declared in SQL initialization code.
-#define APP_DB_SCHEMA_VERSION         "10"
+#define APP_DB_SCHEMA_VERSION         "12"
 #define APP_DB_UPDATE_FILE_PATTERN    "db_update_%1_%2_%3.sql"
 #define APP_DB_COMMENT_SPLIT          "-- !\n"
 #define APP_DB_NAME_PLACEHOLDER       "##"
@@ -137,6 +173,9 @@
 
 #define APP_QUIT_INSTANCE   "-q"
 #define APP_IS_RUNNING      "app_is_running"
+#define CLI_UPDATE_ALL      "--update-all"
+#define CLI_DAEMON          "--daemon"
+#define CLI_INTERVAL        "--interval"
 #define APP_SKIN_USER_FOLDER "skins"
 #define APP_SKIN_DEFAULT    "vergilius"
 #define APP_SKIN_METADATA_FILE "metadata.xml"
@@ -26,6 +26,7 @@
 #include "gui/dialogs/formrestoredatabasesettings.h"
 #include "gui/dialogs/formsettings.h"
 #include "gui/dialogs/formupdate.h"
+#include "gui/dialogs/formupdatestatistics.h"
 #include "gui/feedmessageviewer.h"
 #include "gui/feedstoolbar.h"
 #include "gui/feedsview.h"
@@ -180,6 +181,7 @@ QList<QAction*> FormMain::allActions() const {
   actions << m_ui->m_actionServiceEdit;
   actions << m_ui->m_actionServiceDelete;
   actions << m_ui->m_actionCleanupDatabase;
+  actions << m_ui->m_actionUpdateStatistics;
   actions << m_ui->m_actionAddFeedIntoSelectedAccount;
   actions << m_ui->m_actionAddCategoryIntoSelectedAccount;
   actions << m_ui->m_actionViewSelectedItemsNewspaperMode;
@@ -380,7 +382,7 @@ void FormMain::onFeedUpdatesFinished(const FeedDownloadResults& results) {
 }
 
 void FormMain::onFeedUpdatesStarted() {
-  m_ui->m_actionStopRunningItemsUpdate->setEnabled(true);
+  updateFeedButtonsAvailability();
   statusBar()->showProgressFeeds(0, tr("Feed update started"));
 }
 
@@ -425,7 +427,8 @@ void FormMain::updateFeedButtonsAvailability() {
   m_ui->m_actionMarkSelectedItemsAsRead->setEnabled(anything_selected);
   m_ui->m_actionMarkSelectedItemsAsUnread->setEnabled(anything_selected);
   m_ui->m_actionUpdateAllItems->setEnabled(!critical_action_running);
-  m_ui->m_actionUpdateSelectedItems->setEnabled(!critical_action_running && (feed_selected || category_selected || service_selected));
+  m_ui->m_actionUpdateSelectedItems->setEnabled((!critical_action_running || is_update_running) &&
+                                                (feed_selected || category_selected || service_selected));
   m_ui->m_actionViewSelectedItemsNewspaperMode->setEnabled(anything_selected);
   m_ui->m_actionExpandCollapseItem->setEnabled(anything_selected);
   m_ui->m_actionServiceDelete->setEnabled(service_selected);
@@ -476,6 +479,7 @@ void FormMain::setupIcons() {
   m_ui->m_actionAboutGuard->setIcon(icon_theme_factory->fromTheme(QSL("help-about")));
   m_ui->m_actionCheckForUpdates->setIcon(icon_theme_factory->fromTheme(QSL("system-upgrade")));
   m_ui->m_actionCleanupDatabase->setIcon(icon_theme_factory->fromTheme(QSL("edit-clear")));
+  m_ui->m_actionUpdateStatistics->setIcon(icon_theme_factory->fromTheme(QSL("document-properties")));
   m_ui->m_actionReportBug->setIcon(icon_theme_factory->fromTheme(QSL("call-start")));
   m_ui->m_actionBackupDatabaseSettings->setIcon(icon_theme_factory->fromTheme(QSL("document-export")));
   m_ui->m_actionRestoreDatabaseSettings->setIcon(icon_theme_factory->fromTheme(QSL("document-import")));
@@ -633,6 +637,9 @@ void FormMain::createConnections() {
   });
   connect(m_ui->m_actionDownloadManager, &QAction::triggered, m_ui->m_tabWidget, &TabWidget::showDownloadManager);
   connect(m_ui->m_actionCleanupDatabase, &QAction::triggered, this, &FormMain::showDbCleanupAssistant);
+  connect(m_ui->m_actionUpdateStatistics, &QAction::triggered, [this]() {
+    FormUpdateStatistics(qApp->feedReader()->updateStatistics(), this).exec();
+  });
 
   // Menu "Help" connections.
   connect(m_ui->m_actionAboutGuard, &QAction::triggered, [this]() {
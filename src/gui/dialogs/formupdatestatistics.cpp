@@ -0,0 +1,134 @@
+// This file is part of RSS Guard.
+
+//
+// Copyright (C) 2011-2017 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#include "gui/dialogs/formupdatestatistics.h"
+
+#include "core/feedupdatestatistics.h"
+#include "exceptions/ioexception.h"
+#include "gui/messagebox.h"
+#include "miscellaneous/application.h"
+#include "miscellaneous/iconfactory.h"
+#include "miscellaneous/iofactory.h"
+
+#include <QFileDialog>
+#include <QPushButton>
+
+FormUpdateStatistics::FormUpdateStatistics(FeedUpdateStatistics* statistics, QWidget* parent)
+  : QDialog(parent), m_ui(new Ui::FormUpdateStatistics), m_statistics(statistics) {
+  m_ui->setupUi(this);
+
+  // Set flags and attributes.
+  setWindowFlags(Qt::Dialog | Qt::WindowSystemMenuHint | Qt::WindowTitleHint | Qt::WindowMaximizeButtonHint);
+  setWindowIcon(qApp->icons()->fromTheme(QSL("document-properties")));
+
+  m_ui->m_treeStatistics->setHeaderLabels(QStringList() << tr("Feed") << tr("Updates") << tr("Errors")
+                                          << tr("Unchanged") << tr("HTTP status") << tr("Redirects") << tr("Bytes")
+                                          << tr("New messages") << tr("Network (ms)") << tr("Decoding (ms)")
+                                          << tr("Parsing (ms)") << tr("Storing (ms)") << tr("Total (ms)")
+                                          << tr("Average (ms)") << tr("Maximum (ms)") << tr("Last update"));
+  m_ui->m_treeStatistics->headerItem()->setToolTip(TotalTime, tr("Duration of last update of the feed."));
+  m_ui->m_treeStatistics->headerItem()->setToolTip(AverageTime, tr("Average duration of all updates of the feed."));
+
+  QPushButton* btn_json = m_ui->m_btnBox->addButton(tr("Export to &JSON"), QDialogButtonBox::ActionRole);
+  QPushButton* btn_csv = m_ui->m_btnBox->addButton(tr("Export to &CSV"), QDialogButtonBox::ActionRole);
+  QPushButton* btn_clear = m_ui->m_btnBox->addButton(tr("C&lear"), QDialogButtonBox::ResetRole);
+
+  btn_json->setIcon(qApp->icons()->fromTheme(QSL("document-export")));
+  btn_csv->setIcon(qApp->icons()->fromTheme(QSL("document-export")));
+  btn_clear->setIcon(qApp->icons()->fromTheme(QSL("edit-clear")));
+
+  connect(btn_json, &QPushButton::clicked, this, &FormUpdateStatistics::exportToJson);
+  connect(btn_csv, &QPushButton::clicked, this, &FormUpdateStatistics::exportToCsv);
+  connect(btn_clear, &QPushButton::clicked, m_statistics, &FeedUpdateStatistics::clear);
+  connect(m_statistics, &FeedUpdateStatistics::statisticsChanged, this, &FormUpdateStatistics::loadStatistics);
+
+  loadStatistics();
+  m_ui->m_treeStatistics->sortByColumn(TotalTime, Qt::DescendingOrder);
+}
+
+FormUpdateStatistics::~FormUpdateStatistics() {
+  qDebug("Destroying FormUpdateStatistics instance.");
+}
+
+void FormUpdateStatistics::loadStatistics() {
+  m_ui->m_treeStatistics->setSortingEnabled(false);
+  m_ui->m_treeStatistics->clear();
+
+  foreach (const FeedUpdateStatisticsEntry& entry, m_statistics->entries()) {
+    const FeedUpdateMetrics& last = entry.m_last;
+    QTreeWidgetItem* item = new QTreeWidgetItem(m_ui->m_treeStatistics);
+
+    // Numbers are stored as numbers, so that sorting by them works.
+    item->setText(Title, last.m_feedTitle);
+    item->setToolTip(Title, last.m_feedUrl);
+    item->setData(Updates, Qt::DisplayRole, entry.m_updates);
+    item->setData(Errors, Qt::DisplayRole, entry.m_errors);
+    item->setData(UnchangedSkips, Qt::DisplayRole, entry.m_unchangedSkips);
+    item->setData(HttpStatus, Qt::DisplayRole, last.m_httpStatusCode);
+    item->setData(Redirects, Qt::DisplayRole, last.m_redirectCount);
+    item->setData(Bytes, Qt::DisplayRole, last.m_bytesReceived);
+    item->setData(NewMessages, Qt::DisplayRole, last.m_newMessages);
+    item->setData(NetworkTime, Qt::DisplayRole, last.m_networkTime);
+    item->setData(DecodingTime, Qt::DisplayRole, last.m_decodingTime);
+    item->setData(ParsingTime, Qt::DisplayRole, last.m_parsingTime);
+    item->setData(StoringTime, Qt::DisplayRole, last.m_storingTime);
+    item->setData(TotalTime, Qt::DisplayRole, last.totalTime());
+    item->setData(AverageTime, Qt::DisplayRole, entry.averageTime());
+    item->setData(MaxTime, Qt::DisplayRole, entry.m_maxTime);
+    item->setData(LastUpdate, Qt::DisplayRole, last.m_finished);
+
+    if (last.m_error) {
+      item->setIcon(Title, qApp->icons()->fromTheme(QSL("dialog-error")));
+    }
+  }
+
+  m_ui->m_treeStatistics->setSortingEnabled(true);
+
+  for (int i = 0; i < ColumnCount; i++) {
+    m_ui->m_treeStatistics->resizeColumnToContents(i);
+  }
+}
+
+void FormUpdateStatistics::exportToJson() {
+  exportToFile(tr("JSON files (*.json)"), QSL(".json"), m_statistics->toJson());
+}
+
+void FormUpdateStatistics::exportToCsv() {
+  exportToFile(tr("CSV files (*.csv)"), QSL(".csv"), m_statistics->toCsv());
+}
+
+void FormUpdateStatistics::exportToFile(const QString& filter, const QString& suffix, const QByteArray& data) {
+  QString selected_file = QFileDialog::getSaveFileName(this, tr("Select file for statistics export"),
+                                                       qApp->homeFolder(), filter);
+
+  if (selected_file.isEmpty()) {
+    return;
+  }
+
+  if (!selected_file.endsWith(suffix)) {
+    selected_file += suffix;
+  }
+
+  try {
+    IOFactory::writeTextFile(selected_file, data);
+  }
+  catch (IOException& ex) {
+    MessageBox::show(this, QMessageBox::Critical, tr("Cannot export statistics"),
+                     tr("Statistics could not be written into destination file."), ex.message());
+  }
+}
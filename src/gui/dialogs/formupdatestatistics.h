@@ -0,0 +1,71 @@
+// This file is part of RSS Guard.
+
+//
+// Copyright (C) 2011-2017 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef FORMUPDATESTATISTICS_H
+#define FORMUPDATESTATISTICS_H
+
+#include <QDialog>
+
+#include "ui_formupdatestatistics.h"
+
+class FeedUpdateStatistics;
+
+// Shows per-feed measurements of feed updates.
+class FormUpdateStatistics : public QDialog {
+  Q_OBJECT
+
+  public:
+
+    // Constructors.
+    explicit FormUpdateStatistics(FeedUpdateStatistics* statistics, QWidget* parent = 0);
+    virtual ~FormUpdateStatistics();
+
+  private slots:
+    void loadStatistics();
+    void exportToJson();
+    void exportToCsv();
+
+  private:
+    enum Columns {
+      Title = 0,
+      Updates,
+      Errors,
+      UnchangedSkips,
+      HttpStatus,
+      Redirects,
+      Bytes,
+      NewMessages,
+      NetworkTime,
+      DecodingTime,
+      ParsingTime,
+      StoringTime,
+      TotalTime,
+      AverageTime,
+      MaxTime,
+      LastUpdate,
+      ColumnCount
+    };
+
+    void exportToFile(const QString& filter, const QString& suffix, const QByteArray& data);
+
+  private:
+    QScopedPointer<Ui::FormUpdateStatistics> m_ui;
+    FeedUpdateStatistics* m_statistics;
+};
+
+#endif // FORMUPDATESTATISTICS_H
@@ -201,7 +201,7 @@ void FeedsView::expandCollapseCurrentItem() {
 }
 
 void FeedsView::updateSelectedItems() {
-  qApp->feedReader()->updateFeeds(selectedFeeds());
+  qApp->feedReader()->updateFeeds(selectedFeeds(), FeedDownloader::Interactive);
 }
 
 void FeedsView::clearSelectedFeeds() {
@@ -23,6 +23,7 @@
 #include "gui/messagebox.h"
 #include "gui/styleditemdelegatewithoutfocus.h"
 #include "gui/treeviewcolumnsmenu.h"
+#include "miscellaneous/debugging.h"
 #include "miscellaneous/externaltool.h"
 #include "miscellaneous/feedreader.h"
 #include "miscellaneous/settings.h"
@@ -503,7 +504,10 @@ void MessagesView::selectNextUnreadItem() {
 }
 
 void MessagesView::searchMessages(const QString& pattern) {
+  ScopedTiming timing("MessagesView::searchMessages");
+
   m_proxyModel->setFilterRegExp(pattern);
+  timing.setItems(m_proxyModel->rowCount());
 
   if (selectionModel()->selectedRows().size() == 0) {
     emit currentMessageRemoved();
@@ -18,6 +18,7 @@
 
 #include "gui/newspaperpreviewer.h"
 
+#include "definitions/definitions.h"
 #include "gui/dialogs/formmain.h"
 #include "gui/messagepreviewer.h"
 #include "miscellaneous/application.h"
@@ -28,6 +29,7 @@ NewspaperPreviewer::NewspaperPreviewer(RootItem* root, QList<Message> messages,
   : TabContent(parent), m_ui(new Ui::NewspaperPreviewer), m_root(root), m_messages(messages) {
   m_ui->setupUi(this);
   connect(m_ui->m_btnShowMoreMessages, &QPushButton::clicked, this, &NewspaperPreviewer::showMoreMessages);
+  connect(m_ui->scrollArea->verticalScrollBar(), &QScrollBar::valueChanged, this, &NewspaperPreviewer::onScrolled);
   showMoreMessages();
 }
 
@@ -37,7 +39,7 @@ void NewspaperPreviewer::showMoreMessages() {
   if (!m_root.isNull()) {
     int current_scroll = m_ui->scrollArea->verticalScrollBar()->value();
 
-    for (int i = 0; i < 10 && !m_messages.isEmpty(); i++) {
+    for (int i = 0; i < NEWSPAPER_MESSAGES_BATCH && !m_messages.isEmpty(); i++) {
       Message msg = m_messages.takeFirst();
       MessagePreviewer* prev = new MessagePreviewer(this);
       QMargins margins = prev->layout()->contentsMargins();
@@ -61,3 +63,10 @@ void NewspaperPreviewer::showMoreMessages() {
                          qApp->mainForm(), true);
   }
 }
+
+void NewspaperPreviewer::onScrolled(int value) {
+  // More messages are shown automatically when user nears the end.
+  if (!m_messages.isEmpty() && value >= m_ui->scrollArea->verticalScrollBar()->maximum() - m_ui->scrollArea->height()) {
+    showMoreMessages();
+  }
+}
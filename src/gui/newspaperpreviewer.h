@@ -45,6 +45,7 @@ class NewspaperPreviewer : public TabContent {
 
   private slots:
     void showMoreMessages();
+    void onScrolled(int value);
 
   signals:
     void requestMessageListReload(bool mark_current_as_read);
@@ -0,0 +1,89 @@
+// This file is part of RSS Guard.
+
+//
+// Copyright (C) 2011-2017 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#include "gui/retentionpolicyedit.h"
+
+#include "miscellaneous/application.h"
+#include "miscellaneous/databasefactory.h"
+#include "miscellaneous/databasequeries.h"
+
+#include <QCheckBox>
+#include <QFormLayout>
+#include <QSpinBox>
+
+RetentionPolicyEdit::RetentionPolicyEdit(QWidget* parent)
+  : QGroupBox(parent), m_spinMaxAge(new QSpinBox(this)), m_spinMaxCount(new QSpinBox(this)),
+  m_checkKeepStarred(new QCheckBox(tr("Keep starred messages"), this)) {
+  QFormLayout* layout = new QFormLayout(this);
+
+  setTitle(tr("Override retention policy"));
+  setToolTip(tr("Old messages of this item are purged by rules below instead of the default ones."));
+  setCheckable(true);
+  setChecked(false);
+
+  m_spinMaxAge->setRange(0, 36500);
+  m_spinMaxAge->setSpecialValueText(tr("unlimited"));
+  m_spinMaxCount->setRange(0, 1000000);
+  m_spinMaxCount->setSpecialValueText(tr("unlimited"));
+  m_checkKeepStarred->setChecked(true);
+
+  layout->addRow(tr("Maximal age"), m_spinMaxAge);
+  layout->addRow(tr("Maximal count of messages"), m_spinMaxCount);
+  layout->addRow(m_checkKeepStarred);
+
+  connect(m_spinMaxAge, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this,
+          &RetentionPolicyEdit::updateDaysSuffix);
+  updateDaysSuffix(m_spinMaxAge->value());
+}
+
+RetentionPolicyEdit::~RetentionPolicyEdit() {}
+
+void RetentionPolicyEdit::loadPolicy(int account_id, const QString& feed_custom_id) {
+  QSqlDatabase database = qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings);
+  bool ok;
+  RetentionPolicy policy = DatabaseQueries::getRetentionPolicy(database, account_id, feed_custom_id, &ok);
+
+  setChecked(ok);
+
+  if (ok) {
+    m_spinMaxAge->setValue(policy.m_maxAge);
+    m_spinMaxCount->setValue(policy.m_maxCount);
+    m_checkKeepStarred->setChecked(policy.m_keepStarred);
+  }
+}
+
+bool RetentionPolicyEdit::savePolicy(int account_id, const QString& feed_custom_id) const {
+  QSqlDatabase database = qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings);
+
+  if (!isChecked()) {
+    return DatabaseQueries::deleteRetentionPolicy(database, account_id, feed_custom_id);
+  }
+
+  RetentionPolicy policy;
+
+  policy.m_accountId = account_id;
+  policy.m_feedCustomId = feed_custom_id;
+  policy.m_maxAge = m_spinMaxAge->value();
+  policy.m_maxCount = m_spinMaxCount->value();
+  policy.m_keepStarred = m_checkKeepStarred->isChecked();
+  return DatabaseQueries::storeRetentionPolicy(database, policy);
+}
+
+void RetentionPolicyEdit::updateDaysSuffix(int number) {
+  m_spinMaxAge->setSuffix(tr(" day(s)", 0, number));
+}
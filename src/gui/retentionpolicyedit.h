@@ -0,0 +1,51 @@
+// This file is part of RSS Guard.
+
+//
+// Copyright (C) 2011-2017 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef RETENTIONPOLICYEDIT_H
+#define RETENTIONPOLICYEDIT_H
+
+#include <QGroupBox>
+
+class QCheckBox;
+class QSpinBox;
+
+// Group box for overriding of retention policy of single feed or account.
+// When unchecked, policy of parent account or global one is used.
+class RetentionPolicyEdit : public QGroupBox {
+  Q_OBJECT
+
+  public:
+    explicit RetentionPolicyEdit(QWidget* parent = 0);
+    virtual ~RetentionPolicyEdit();
+
+    // Loads stored policy, empty feed ID means policy of whole account.
+    void loadPolicy(int account_id, const QString& feed_custom_id);
+
+    // Stores the policy or removes it if it is not overridden.
+    bool savePolicy(int account_id, const QString& feed_custom_id) const;
+
+  private slots:
+    void updateDaysSuffix(int number);
+
+  private:
+    QSpinBox* m_spinMaxAge;
+    QSpinBox* m_spinMaxCount;
+    QCheckBox* m_checkKeepStarred;
+};
+
+#endif // RETENTIONPOLICYEDIT_H
@@ -21,7 +21,9 @@
 #include "definitions/definitions.h"
 #include "gui/guiutilities.h"
 #include "miscellaneous/application.h"
+#include "miscellaneous/databasecleaner.h"
 #include "miscellaneous/databasefactory.h"
+#include "miscellaneous/feedreader.h"
 #include "miscellaneous/textfactory.h"
 
 SettingsDatabase::SettingsDatabase(Settings* settings, QWidget* parent)
@@ -39,6 +41,15 @@ SettingsDatabase::SettingsDatabase(Settings* settings, QWidget* parent)
   connect(m_ui->m_checkUseTransactions, &QCheckBox::toggled, this, &SettingsDatabase::dirtifySettings);
   connect(m_ui->m_txtMysqlUsername->lineEdit(), &QLineEdit::textChanged, this, &SettingsDatabase::dirtifySettings);
   connect(m_ui->m_spinMysqlPort, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this, &SettingsDatabase::dirtifySettings);
+  connect(m_ui->m_gbRetention, &QGroupBox::toggled, this, &SettingsDatabase::dirtifySettings);
+  connect(m_ui->m_spinRetentionMaxAge, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this,
+          &SettingsDatabase::dirtifySettings);
+  connect(m_ui->m_spinRetentionMaxAge, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this,
+          &SettingsDatabase::updateRetentionDaysSuffix);
+  connect(m_ui->m_spinRetentionMaxCount, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this,
+          &SettingsDatabase::dirtifySettings);
+  connect(m_ui->m_checkRetentionKeepStarred, &QCheckBox::toggled, this, &SettingsDatabase::dirtifySettings);
+  connect(m_ui->m_checkCompressContents, &QCheckBox::toggled, this, &SettingsDatabase::dirtifySettings);
   connect(m_ui->m_cmbDatabaseDriver, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this,
           &SettingsDatabase::selectSqlBackend);
   connect(m_ui->m_checkMysqlShowPassword, &QCheckBox::toggled, this, &SettingsDatabase::switchMysqlPasswordVisiblity);
@@ -130,6 +141,10 @@ void SettingsDatabase::selectSqlBackend(int index) {
   }
 }
 
+void SettingsDatabase::updateRetentionDaysSuffix(int number) {
+  m_ui->m_spinRetentionMaxAge->setSuffix(tr(" day(s)", 0, number));
+}
+
 void SettingsDatabase::switchMysqlPasswordVisiblity(bool visible) {
   m_ui->m_txtMysqlPassword->lineEdit()->setEchoMode(visible ? QLineEdit::Normal : QLineEdit::Password);
 }
@@ -137,6 +152,14 @@ void SettingsDatabase::switchMysqlPasswordVisiblity(bool visible) {
 void SettingsDatabase::loadSettings() {
   onBeginLoadSettings();
   m_ui->m_checkUseTransactions->setChecked(qApp->settings()->value(GROUP(Database), SETTING(Database::UseTransactions)).toBool());
+
+  // Load retention policy.
+  m_ui->m_gbRetention->setChecked(settings()->value(GROUP(Database), SETTING(Database::RetentionEnabled)).toBool());
+  m_ui->m_spinRetentionMaxAge->setValue(settings()->value(GROUP(Database), SETTING(Database::RetentionMaxAge)).toInt());
+  m_ui->m_spinRetentionMaxCount->setValue(settings()->value(GROUP(Database), SETTING(Database::RetentionMaxCount)).toInt());
+  m_ui->m_checkRetentionKeepStarred->setChecked(settings()->value(GROUP(Database), SETTING(Database::RetentionKeepStarred)).toBool());
+  updateRetentionDaysSuffix(m_ui->m_spinRetentionMaxAge->value());
+  m_ui->m_checkCompressContents->setChecked(settings()->value(GROUP(Database), SETTING(Database::CompressContents)).toBool());
   m_ui->m_lblMysqlTestResult->setStatus(WidgetWithStatus::Information, tr("No connection test triggered so far."),
                                         tr("You did not executed any connection test yet."));
 
@@ -188,6 +211,25 @@ void SettingsDatabase::saveSettings() {
 
   qApp->settings()->setValue(GROUP(Database), Database::UseTransactions, m_ui->m_checkUseTransactions->isChecked());
 
+  // Save retention policy, it is picked up by next retention round.
+  settings()->setValue(GROUP(Database), Database::RetentionEnabled, m_ui->m_gbRetention->isChecked());
+  settings()->setValue(GROUP(Database), Database::RetentionMaxAge, m_ui->m_spinRetentionMaxAge->value());
+  settings()->setValue(GROUP(Database), Database::RetentionMaxCount, m_ui->m_spinRetentionMaxCount->value());
+  settings()->setValue(GROUP(Database), Database::RetentionKeepStarred, m_ui->m_checkRetentionKeepStarred->isChecked());
+
+  // Compress already stored messages when compression gets enabled, start from scratch when it is re-enabled.
+  const bool original_compress = settings()->value(GROUP(Database), SETTING(Database::CompressContents)).toBool();
+  const bool new_compress = m_ui->m_checkCompressContents->isChecked();
+
+  settings()->setValue(GROUP(Database), Database::CompressContents, new_compress);
+
+  if (!new_compress && original_compress) {
+    QMetaObject::invokeMethod(qApp->feedReader()->databaseCleaner(), "stopCompressionMigration");
+  }
+  else if (new_compress && !original_compress) {
+    QMetaObject::invokeMethod(qApp->feedReader()->databaseCleaner(), "startCompressionMigration");
+  }
+
   // Save data storage settings.
   QString original_db_driver = settings()->value(GROUP(Database), SETTING(Database::ActiveDriver)).toString();
   QString selected_db_driver = m_ui->m_cmbDatabaseDriver->itemData(m_ui->m_cmbDatabaseDriver->currentIndex()).toString();
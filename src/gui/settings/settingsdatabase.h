@@ -46,6 +46,7 @@ class SettingsDatabase : public SettingsPanel {
     void onMysqlDatabaseChanged(const QString& new_database);
     void selectSqlBackend(int index);
     void switchMysqlPasswordVisiblity(bool visible);
+    void updateRetentionDaysSuffix(int number);
 
     Ui::SettingsDatabase* m_ui;
 };
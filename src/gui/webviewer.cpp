@@ -29,12 +29,17 @@
 #include "network-web/webfactory.h"
 #include "network-web/webpage.h"
 
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QRegularExpression>
 #include <QWheelEvent>
 
-WebViewer::WebViewer(QWidget* parent) : QWebEngineView(parent) {
+WebViewer::WebViewer(QWidget* parent) : QWebEngineView(parent), m_isNewspaper(false), m_appendingMessages(false) {
   WebPage* page = new WebPage(this);
 
   connect(page, &WebPage::messageStatusChangeRequested, this, &WebViewer::messageStatusChangeRequested);
+  connect(page, &WebPage::scrollPositionChanged, this, &WebViewer::onScrollPositionChanged);
+  connect(page, &WebPage::contentsSizeChanged, this, &WebViewer::onContentsSizeChanged);
   setPage(page);
 }
 
@@ -50,6 +55,15 @@ WebPage* WebViewer::page() const {
   return qobject_cast<WebPage*>(QWebEngineView::page());
 }
 
+QString WebViewer::messageContents() {
+  if (m_messageContents.isEmpty()) {
+    // Document is rebuilt only when it is really needed, not with each appended batch.
+    m_messageContents = prepareDocument();
+  }
+
+  return m_messageContents;
+}
+
 void WebViewer::displayMessage() {
   setHtml(m_messageContents, QUrl::fromUserInput(INTERNAL_URL_MESSAGE));
 }
@@ -86,44 +100,93 @@ bool WebViewer::resetWebPageZoom() {
   }
 }
 
-void WebViewer::loadMessages(const QList<Message>& messages) {
-  Skin skin = qApp->skins()->currentSkin();
+QString WebViewer::prepareMessagesLayout(const QList<Message>& messages, bool lazy_images) {
+  const Skin skin = qApp->skins()->currentSkin();
+  const QString image_height = qApp->settings()->value(GROUP(Messages), SETTING(Messages::MessageHeadImageHeight)).toString();
+  QRegularExpression image_source(QSL("(<img\\b[^>]*?)\\ssrc\\s*="), QRegularExpression::CaseInsensitiveOption);
   QString messages_layout;
-  QString single_message_layout = skin.m_layoutMarkup;
+  int expected_length = 0;
+
+  foreach (const Message& message, messages) {
+    expected_length += skin.m_layoutMarkupTemplate.literalLength() + message.m_contents.size() + message.m_title.size();
+  }
+
+  messages_layout.reserve(expected_length);
 
   foreach (const Message& message, messages) {
     QString enclosures;
     QString enclosure_images;
 
     foreach (const Enclosure& enclosure, message.m_enclosures) {
-      enclosures += skin.m_enclosureMarkup.arg(enclosure.m_url, tr("Attachment"), enclosure.m_mimeType);
+      skin.m_enclosureMarkupTemplate.render(enclosures, QStringList() << enclosure.m_url << tr("Attachment") << enclosure.m_mimeType);
 
       if (enclosure.m_mimeType.startsWith(QSL("image/"))) {
         // Add thumbnail image.
-        enclosure_images += skin.m_enclosureImageMarkup.arg(
-          enclosure.m_url,
-          enclosure.m_mimeType,
-          qApp->settings()->value(GROUP(Messages), SETTING(Messages::MessageHeadImageHeight)).toString());
+        skin.m_enclosureImageMarkupTemplate.render(enclosure_images,
+                                                   QStringList() << enclosure.m_url << enclosure.m_mimeType << image_height);
       }
     }
 
-    messages_layout.append(single_message_layout
-                           .arg(message.m_title,
-                                tr("Written by ") + (message.m_author.isEmpty() ?
-                                                     tr("unknown author") :
-                                                     message.m_author),
-                                message.m_url,
-                                message.m_contents,
-                                message.m_created.toString(Qt::DefaultLocaleShortDate),
-                                enclosures,
-                                message.m_isRead ? "mark-unread" : "mark-read",
-                                message.m_isImportant ? "mark-unstarred" : "mark-starred",
-                                QString::number(message.m_id))
-                           .arg(enclosure_images));
-  }
-
-  m_messageContents = skin.m_layoutMarkupWrapper.arg(messages.size() == 1 ? messages.at(0).m_title : tr("Newspaper view"),
-                                                     messages_layout);
+    QString contents = message.m_contents;
+
+    if (lazy_images) {
+      // Images are loaded by script once they are about to be scrolled into view.
+      contents.replace(image_source, QSL("\\1 data-lazy-src="));
+    }
+
+    skin.m_layoutMarkupTemplate.render(messages_layout,
+                                       QStringList()
+                                       << message.m_title
+                                       << tr("Written by ") + (message.m_author.isEmpty() ? tr("unknown author") : message.m_author)
+                                       << message.m_url
+                                       << contents
+                                       << message.m_created.toString(Qt::DefaultLocaleShortDate)
+                                       << enclosures
+                                       << (message.m_isRead ? QSL("mark-unread") : QSL("mark-read"))
+                                       << (message.m_isImportant ? QSL("mark-unstarred") : QSL("mark-starred"))
+                                       << QString::number(message.m_id)
+                                       << enclosure_images);
+  }
+
+  return messages_layout;
+}
+
+QString WebViewer::prepareDocument() const {
+  QString body = m_messagesLayout;
+
+  if (m_isNewspaper) {
+    body += QSL("<script>"
+                "var rssguardLazyImages = new IntersectionObserver(function(entries) {"
+                "  entries.forEach(function(entry) {"
+                "    if (entry.isIntersecting) {"
+                "      entry.target.src = entry.target.getAttribute('data-lazy-src');"
+                "      entry.target.removeAttribute('data-lazy-src');"
+                "      rssguardLazyImages.unobserve(entry.target);"
+                "    }"
+                "  });"
+                "}, { rootMargin: '%1px' });"
+                "function rssguardObserveLazyImages() {"
+                "  document.querySelectorAll('img[data-lazy-src]').forEach(function(img) { rssguardLazyImages.observe(img); });"
+                "}"
+                "rssguardObserveLazyImages();"
+                "</script>").arg(NEWSPAPER_PRELOAD_DISTANCE);
+  }
+
+  return qApp->skins()->currentSkin().m_layoutMarkupWrapperTemplate.render(QStringList() << m_documentTitle << body);
+}
+
+void WebViewer::loadMessages(const QList<Message>& messages) {
+  m_isNewspaper = messages.size() > 1;
+  m_appendingMessages = false;
+
+  // Newspaper view displays only first batch of messages,
+  // others are appended as user scrolls down.
+  const int batch_size = m_isNewspaper ? NEWSPAPER_MESSAGES_BATCH : messages.size();
+
+  m_pendingMessages = messages.mid(batch_size);
+  m_messagesLayout = prepareMessagesLayout(messages.mid(0, batch_size), m_isNewspaper);
+  m_documentTitle = messages.size() == 1 ? messages.at(0).m_title : tr("Newspaper view");
+  m_messageContents = prepareDocument();
   bool previously_enabled = isEnabled();
 
   setEnabled(false);
@@ -131,6 +194,43 @@ void WebViewer::loadMessages(const QList<Message>& messages) {
   setEnabled(previously_enabled);
 }
 
+void WebViewer::appendNextMessages() {
+  const QList<Message> batch = m_pendingMessages.mid(0, NEWSPAPER_MESSAGES_BATCH);
+  const QString batch_layout = prepareMessagesLayout(batch, true);
+
+  m_pendingMessages.erase(m_pendingMessages.begin(), m_pendingMessages.begin() + batch.size());
+  m_messagesLayout += batch_layout;
+  m_messageContents.clear();
+  m_appendingMessages = true;
+
+  // Markup is passed to the page as JSON string, which is valid JavaScript literal.
+  const QString markup_literal = QString::fromUtf8(QJsonDocument(QJsonArray() << batch_layout).toJson(QJsonDocument::Compact));
+
+  page()->runJavaScript(QSL("document.body.insertAdjacentHTML('beforeend', %1[0]); rssguardObserveLazyImages();").arg(markup_literal));
+}
+
+void WebViewer::onScrollPositionChanged(const QPointF& position) {
+  if (m_pendingMessages.isEmpty() || m_appendingMessages) {
+    return;
+  }
+
+  const qreal visible_height = height() / zoomFactor();
+
+  if (position.y() + visible_height >= page()->contentsSize().height() - NEWSPAPER_PRELOAD_DISTANCE) {
+    appendNextMessages();
+  }
+}
+
+void WebViewer::onContentsSizeChanged(const QSizeF& size) {
+  Q_UNUSED(size)
+
+  if (m_appendingMessages) {
+    // Appended messages are now laid out, next batch can be appended when needed.
+    m_appendingMessages = false;
+    onScrollPositionChanged(page()->scrollPosition());
+  }
+}
+
 void WebViewer::loadMessage(const Message& message) {
   loadMessages(QList<Message>() << message);
 }
@@ -138,6 +238,11 @@ void WebViewer::loadMessage(const Message& message) {
 void WebViewer::clear() {
   bool previously_enabled = isEnabled();
 
+  m_pendingMessages.clear();
+  m_messagesLayout.clear();
+  m_isNewspaper = false;
+  m_appendingMessages = false;
+
   setEnabled(false);
   setHtml("<!DOCTYPE html><html><body</body></html>", QUrl(INTERNAL_URL_BLANK));
   setEnabled(previously_enabled);
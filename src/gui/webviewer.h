@@ -33,12 +33,14 @@ class WebViewer : public QWebEngineView {
     bool canIncreaseZoom();
     bool canDecreaseZoom();
 
-    inline QString messageContents() {
-      return m_messageContents;
-    }
+    // Returns whole document which is displayed, including appended batches of newspaper view.
+    QString messageContents();
 
     WebPage* page() const;
 
+    // Renders given messages with compiled templates of current skin.
+    static QString prepareMessagesLayout(const QList<Message>& messages, bool lazy_images);
+
   public slots:
 
     // Page zoom modifiers.
@@ -60,8 +62,25 @@ class WebViewer : public QWebEngineView {
   signals:
     void messageStatusChangeRequested(int message_id, WebPage::MessageStatusChange change);
 
+  private slots:
+
+    // Appends next batch of messages when user scrolls near the end of newspaper view.
+    void onScrollPositionChanged(const QPointF& position);
+    void onContentsSizeChanged(const QSizeF& size);
+
   private:
+    QString prepareDocument() const;
+    void appendNextMessages();
+
     QString m_messageContents;
+
+    // Newspaper view is loaded in batches, these are
+    // messages which are not yet displayed.
+    QList<Message> m_pendingMessages;
+    QString m_messagesLayout;
+    QString m_documentTitle;
+    bool m_isNewspaper;
+    bool m_appendingMessages;
 };
 
 #endif // WEBVIEWER_H
@@ -28,6 +28,7 @@
 #include "miscellaneous/databasefactory.h"
 #include "miscellaneous/debugging.h"
 #include "miscellaneous/feedreader.h"
+#include "miscellaneous/headlessupdater.h"
 #include "miscellaneous/iconfactory.h"
 #include "network-web/silentnetworkaccessmanager.h"
 #include "network-web/webfactory.h"
@@ -38,6 +39,7 @@
 #endif
 
 #include <QDebug>
+#include <QDir>
 #include <QThread>
 #include <QTimer>
 #include <QTranslator>
@@ -48,15 +50,39 @@ extern void disableWindowTabbing();
 #endif
 
 int main(int argc, char* argv[]) {
+  bool headless = false;
+  bool daemon = false;
+  int interval_minutes = 0;
+
   for (int i = 0; i < argc; i++) {
     const QString str = QString::fromLocal8Bit(argv[i]);
 
     if (str == "-h") {
       qDebug("Usage: rssguard [OPTIONS]\n\n"
              "Option\t\tMeaning\n"
-             "-h\t\tDisplays this help.");
+             "-h\t\tDisplays this help.\n"
+             "%s\tUpdates all feeds without GUI, prints summary and quits.\n"
+             "%s\tRuns without GUI and keeps feeds updated according to their auto-update settings.\n"
+             "%s N\tWith %s, additionally updates all feeds every N minutes.",
+             CLI_UPDATE_ALL, CLI_DAEMON, CLI_INTERVAL, CLI_DAEMON);
       return EXIT_SUCCESS;
     }
+    else if (str == QL1S(CLI_UPDATE_ALL)) {
+      headless = true;
+    }
+    else if (str == QL1S(CLI_DAEMON)) {
+      headless = daemon = true;
+    }
+    else if (str == QL1S(CLI_INTERVAL) && i + 1 < argc) {
+      interval_minutes = QString::fromLocal8Bit(argv[++i]).toInt();
+    }
+  }
+
+  if (headless) {
+    // Headless instance does not need any windowing system.
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+      qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
   }
 
   //: Abbreviation of language, e.g. en.
@@ -74,12 +100,26 @@ int main(int argc, char* argv[]) {
   qInstallMessageHandler(Debugging::debugHandler);
 
   // Instantiate base application object.
-  Application application(APP_LOW_NAME, argc, argv);
+  Application application(APP_LOW_NAME, argc, argv, headless);
+
+  // Settings are available now, so logging can be moved to background thread.
+  QString log_file_path;
 
+  if (qApp->settings()->value(GROUP(General), SETTING(General::LogToFile)).toBool()) {
+    log_file_path = qApp->userDataFolder() + QDir::separator() + QSL(APP_LOW_NAME ".log");
+  }
+
+  Debugging::setLoggingRules(qApp->settings()->value(GROUP(General), SETTING(General::LoggingRules)).toString());
+  Debugging::startAsyncLogging(log_file_path);
+  qAddPostRoutine(Debugging::stopAsyncLogging);
   qDebug("Instantiated Application class.");
 
   // Check if another instance is running.
-  if (application.sendMessage((QStringList() << APP_IS_RUNNING << application.arguments().mid(1)).join(ARGUMENTS_LIST_SEPARATOR))) {
+  if (headless && application.isRunning()) {
+    qCritical("Another instance of the application is already running, headless instance cannot start.");
+    return EXIT_FAILURE;
+  }
+  else if (!headless && application.sendMessage((QStringList() << APP_IS_RUNNING << application.arguments().mid(1)).join(ARGUMENTS_LIST_SEPARATOR))) {
     qWarning("Another instance of the application is already running. Notifying it.");
     return EXIT_FAILURE;
   }
@@ -99,6 +139,14 @@ int main(int argc, char* argv[]) {
   qRegisterMetaType<QList<Message>>("QList<Message>");
   qRegisterMetaType<QList<RootItem*>>("QList<RootItem*>");
 
+  if (headless) {
+    // No widgets, skins or icon themes, only database, feed reader and service accounts.
+    HeadlessUpdater updater(daemon, interval_minutes);
+
+    updater.start();
+    return Application::exec();
+  }
+
   // Add an extra path for non-system icon themes and set current icon theme
   // and skin.
   qApp->icons()->setupSearchPaths();
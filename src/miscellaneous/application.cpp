@@ -52,7 +52,7 @@
 #include <QWebEngineScriptCollection>
 #endif
 
-Application::Application(const QString& id, int& argc, char** argv)
+Application::Application(const QString& id, int& argc, char** argv, bool headless)
   : QtSingleApplication(id, argc, argv),
 
 #if defined(USE_WEBENGINE)
@@ -64,18 +64,20 @@ Application::Application(const QString& id, int& argc, char** argv)
   m_trayIcon(nullptr), m_settings(Settings::setupSettings(this)), m_webFactory(new WebFactory(this)),
   m_system(new SystemFactory(this)), m_skins(new SkinFactory(this)),
   m_localization(new Localization(this)), m_icons(new IconFactory(this)),
-  m_database(new DatabaseFactory(this)), m_downloadManager(nullptr), m_shouldRestart(false) {
+  m_database(new DatabaseFactory(this)), m_downloadManager(nullptr), m_shouldRestart(false), m_headless(headless) {
   connect(this, &Application::aboutToQuit, this, &Application::onAboutToQuit);
   connect(this, &Application::commitDataRequest, this, &Application::onCommitData);
   connect(this, &Application::saveStateRequest, this, &Application::onSaveState);
 
 #if defined(USE_WEBENGINE)
-  connect(QWebEngineProfile::defaultProfile(), &QWebEngineProfile::downloadRequested, this, &Application::downloadRequested);
+  if (!m_headless) {
+    connect(QWebEngineProfile::defaultProfile(), &QWebEngineProfile::downloadRequested, this, &Application::downloadRequested);
 
-  QWebEngineProfile::defaultProfile()->setRequestInterceptor(m_urlInterceptor);
-  m_urlInterceptor->loadSettings();
-  QWebEngineProfile::defaultProfile()->installUrlSchemeHandler(QByteArray(APP_LOW_NAME),
-                                                               new RssGuardSchemeHandler(QWebEngineProfile::defaultProfile()));
+    QWebEngineProfile::defaultProfile()->setRequestInterceptor(m_urlInterceptor);
+    m_urlInterceptor->loadSettings();
+    QWebEngineProfile::defaultProfile()->installUrlSchemeHandler(QByteArray(APP_LOW_NAME),
+                                                                 new RssGuardSchemeHandler(QWebEngineProfile::defaultProfile()));
+  }
 #endif
 }
 
@@ -89,6 +91,10 @@ void Application::showPolls() const {
   }
 }
 
+bool Application::isHeadless() const {
+  return m_headless;
+}
+
 FeedReader* Application::feedReader() {
   return m_feedReader;
 }
@@ -349,7 +355,10 @@ void Application::deleteTrayIcon() {
 void Application::showGuiMessage(const QString& title, const QString& message,
                                  QSystemTrayIcon::MessageIcon message_type, QWidget* parent,
                                  bool show_at_least_msgbox, std::function<void()> functor) {
-  if (SystemTrayIcon::areNotificationsEnabled() && SystemTrayIcon::isSystemTrayActivated()) {
+  if (m_headless) {
+    qDebug("Silencing GUI message in headless mode: '%s'.", qPrintable(message));
+  }
+  else if (SystemTrayIcon::areNotificationsEnabled() && SystemTrayIcon::isSystemTrayActivated()) {
     trayIcon()->showMessage(title, message, message_type, TRAY_ICON_BUBBLE_TIMEOUT, functor);
   }
   else if (show_at_least_msgbox) {
@@ -378,9 +387,16 @@ void Application::onAboutToQuit() {
   eliminateFirstRun(APP_VERSION);
 
 #if defined(USE_WEBENGINE)
-  AdBlockManager::instance()->save();
+  if (!m_headless) {
+    AdBlockManager::instance()->save();
+  }
 #endif
 
+  // Running feed update releases the lock once it is stopped,
+  // it cannot do that while we are blocked waiting for the lock.
+  feedReader()->stopRunningFeedUpdateAndWait();
+  processEvents();
+
   // Make sure that we obtain close lock BEFORE even trying to quit the application.
   const bool locked_safely = feedUpdateLock()->tryLock(4 * CLOSE_LOCK_TIMEOUT);
 
@@ -61,9 +61,12 @@ class Application : public QtSingleApplication {
   public:
 
     // Constructors and destructors.
-    explicit Application(const QString& id, int& argc, char** argv);
+    explicit Application(const QString& id, int& argc, char** argv, bool headless = false);
     virtual ~Application();
 
+    // Headless instance has no widgets and no web engine, it only updates feeds.
+    bool isHeadless() const;
+
     void showPolls() const;
 
     FeedReader* feedReader();
@@ -190,6 +193,7 @@ class Application : public QtSingleApplication {
     DatabaseFactory* m_database;
     DownloadManager* m_downloadManager;
     bool m_shouldRestart;
+    bool m_headless;
 };
 
 #endif // APPLICATION_H
@@ -0,0 +1,209 @@
+// This file is part of RSS Guard.
+
+//
+// Copyright (C) 2011-2017 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#include "miscellaneous/asynclogger.h"
+
+#include "miscellaneous/debugging.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+
+#include <cstdio>
+
+static_assert((LOG_RING_BUFFER_SIZE & (LOG_RING_BUFFER_SIZE - 1)) == 0, "Size of log ring buffer must be power of two.");
+
+AsyncLogger::AsyncLogger(const QString& log_file_path, QObject* parent)
+  : QThread(parent), m_enqueuePosition(0), m_dequeuePosition(0), m_droppedEntries(0), m_stopRequested(0),
+  m_stopped(0), m_logFilePath(log_file_path), m_logFileSize(0) {
+  setObjectName(QSL("AsyncLogger"));
+
+  for (quint32 i = 0; i < LOG_RING_BUFFER_SIZE; i++) {
+    m_slots[i].m_sequence.store(i);
+  }
+}
+
+AsyncLogger::~AsyncLogger() {
+  stop();
+}
+
+bool AsyncLogger::enqueue(Entry& entry) {
+  if (m_stopped.loadAcquire() != 0) {
+    QMutexLocker locker(&m_writeMutex);
+
+    write(entry);
+    flush();
+    return true;
+  }
+
+  quint32 position = m_enqueuePosition.load();
+  Slot* slot;
+
+  forever {
+    slot = &m_slots[position & (LOG_RING_BUFFER_SIZE - 1)];
+    const qint32 difference = qint32(slot->m_sequence.loadAcquire() - position);
+
+    if (difference == 0) {
+      // Slot is free, try to claim it.
+      if (m_enqueuePosition.testAndSetRelaxed(position, position + 1, position)) {
+        break;
+      }
+    }
+    else if (difference < 0) {
+      // Buffer is full, consumer did not free this slot yet.
+      m_droppedEntries.fetchAndAddRelaxed(1);
+      return false;
+    }
+    else {
+      position = m_enqueuePosition.load();
+    }
+  }
+
+  qSwap(slot->m_entry, entry);
+  slot->m_sequence.storeRelease(position + 1);
+  return true;
+}
+
+bool AsyncLogger::dequeue(Entry& entry) {
+  Slot* slot = &m_slots[m_dequeuePosition & (LOG_RING_BUFFER_SIZE - 1)];
+
+  if (slot->m_sequence.loadAcquire() != m_dequeuePosition + 1) {
+    return false;
+  }
+
+  qSwap(entry, slot->m_entry);
+  slot->m_entry.m_message.clear();
+  slot->m_sequence.storeRelease(m_dequeuePosition + LOG_RING_BUFFER_SIZE);
+  m_dequeuePosition++;
+  return true;
+}
+
+void AsyncLogger::stop() {
+  if (isRunning()) {
+    m_stopRequested.storeRelease(1);
+    wait();
+  }
+
+  QMutexLocker locker(&m_writeMutex);
+
+  if (m_stopped.fetchAndStoreOrdered(1) == 0) {
+    // Log file stays open for entries written synchronously from now on.
+    // Producers which did not notice the stop in time might still be publishing
+    // their entries, wait for all claimed slots so that nothing is lost.
+    Entry entry;
+
+    while (m_dequeuePosition != m_enqueuePosition.loadAcquire()) {
+      if (dequeue(entry)) {
+        write(entry);
+      }
+      else {
+        QThread::yieldCurrentThread();
+      }
+    }
+
+    flush();
+  }
+}
+
+void AsyncLogger::run() {
+  if (!m_logFilePath.isEmpty()) {
+    QDir().mkpath(QFileInfo(m_logFilePath).absolutePath());
+    m_logFile.setFileName(m_logFilePath);
+
+    if (!m_logFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+      fprintf(stderr, "[%s] WARNING: Cannot open log file '%s'.\n", APP_LOW_NAME, qPrintable(m_logFilePath));
+    }
+    else {
+      m_logFileSize = m_logFile.size();
+    }
+  }
+
+  Entry entry;
+
+  forever {
+    const bool stopping = m_stopRequested.loadAcquire() != 0;
+    bool wrote_something = false;
+
+    while (dequeue(entry)) {
+      write(entry);
+      wrote_something = true;
+    }
+
+    const int dropped_entries = m_droppedEntries.fetchAndStoreRelaxed(0);
+
+    if (dropped_entries > 0) {
+      Entry dropped;
+
+      dropped.m_timestamp = QDateTime::currentMSecsSinceEpoch();
+      dropped.m_type = QtWarningMsg;
+      dropped.m_message = QString(QSL("%1 log messages were dropped, log buffer was full.")).arg(dropped_entries).toLocal8Bit();
+      write(dropped);
+      wrote_something = true;
+    }
+
+    if (wrote_something) {
+      flush();
+    }
+
+    if (stopping) {
+      // Stop was requested before last draining, so everything is written.
+      break;
+    }
+    else if (!wrote_something) {
+      msleep(LOG_DRAIN_INTERVAL);
+    }
+  }
+}
+
+void AsyncLogger::write(const Entry& entry) {
+  const QByteArray line = Debugging::formatLog(entry.m_message.constData(), entry.m_type, entry.m_category,
+                                               entry.m_file, entry.m_function, entry.m_line, entry.m_timestamp);
+
+  fputs(line.constData(), stderr);
+
+  if (m_logFile.isOpen()) {
+    m_logFileSize += qMax(m_logFile.write(line), qint64(0));
+
+    if (m_logFileSize > LOG_FILE_MAX_SIZE) {
+      rotateLogFile();
+    }
+  }
+}
+
+void AsyncLogger::flush() {
+  fflush(stderr);
+
+  if (m_logFile.isOpen()) {
+    m_logFile.flush();
+  }
+}
+
+void AsyncLogger::rotateLogFile() {
+  m_logFile.close();
+
+  // Shift older files, the oldest one is removed.
+  QFile::remove(m_logFilePath + QL1C('.') + QString::number(LOG_FILE_ROTATIONS));
+
+  for (int i = LOG_FILE_ROTATIONS - 1; i > 0; i--) {
+    QFile::rename(m_logFilePath + QL1C('.') + QString::number(i), m_logFilePath + QL1C('.') + QString::number(i + 1));
+  }
+
+  QFile::rename(m_logFilePath, m_logFilePath + QSL(".1"));
+  m_logFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text);
+  m_logFileSize = 0;
+}
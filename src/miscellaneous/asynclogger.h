@@ -0,0 +1,88 @@
+// This file is part of RSS Guard.
+
+//
+// Copyright (C) 2011-2017 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ASYNCLOGGER_H
+#define ASYNCLOGGER_H
+
+#include <QThread>
+
+#include "definitions/definitions.h"
+
+#include <QAtomicInteger>
+#include <QFile>
+#include <QMutex>
+
+// Writes log messages from background thread.
+// Producers push entries into lock-free bounded ring buffer (multiple
+// producers, single consumer), so they never wait for console or file.
+// When the buffer is full, entries are dropped and their count is reported.
+// After the logger is stopped, entries are written synchronously.
+class AsyncLogger : public QThread {
+  Q_OBJECT
+
+  public:
+    struct Entry {
+      qint64 m_timestamp = 0;
+      QtMsgType m_type = QtDebugMsg;
+
+      // These point to static strings provided by QMessageLogContext.
+      const char* m_category = nullptr;
+      const char* m_file = nullptr;
+      const char* m_function = nullptr;
+      int m_line = -1;
+      QByteArray m_message;
+    };
+
+    explicit AsyncLogger(const QString& log_file_path = QString(), QObject* parent = nullptr);
+    virtual ~AsyncLogger();
+
+    // Thread-safe, returns false if entry was dropped. Entry is written
+    // right away by calling thread if logger is already stopped.
+    bool enqueue(Entry& entry);
+
+    // Writes all pending entries and finishes the thread.
+    // Logger remains usable, entries are then written synchronously.
+    void stop();
+
+  protected:
+    void run();
+
+  private:
+    struct Slot {
+      QAtomicInteger<quint32> m_sequence;
+      Entry m_entry;
+    };
+
+    bool dequeue(Entry& entry);
+    void write(const Entry& entry);
+    void flush();
+    void rotateLogFile();
+
+    Slot m_slots[LOG_RING_BUFFER_SIZE];
+    QAtomicInteger<quint32> m_enqueuePosition;
+    quint32 m_dequeuePosition;
+    QAtomicInt m_droppedEntries;
+    QAtomicInt m_stopRequested;
+    QAtomicInt m_stopped;
+    QMutex m_writeMutex;
+    QString m_logFilePath;
+    QFile m_logFile;
+    qint64 m_logFileSize;
+};
+
+#endif // ASYNCLOGGER_H
@@ -0,0 +1,69 @@
+// This file is part of RSS Guard.
+
+//
+// Copyright (C) 2011-2017 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#include "miscellaneous/cancellationtoken.h"
+
+#include <QMutexLocker>
+#include <QPointer>
+#include <QThreadStorage>
+
+// Guarded pointers are stored, because storage would delete raw pointers on thread exit.
+static QThreadStorage<QPointer<CancellationToken>> s_currentTokens;
+
+CancellationToken::CancellationToken(QObject* parent) : QObject(parent), m_cancelled(0) {}
+
+CancellationToken::~CancellationToken() {}
+
+bool CancellationToken::isCancelled() const {
+  return m_cancelled.load() != 0;
+}
+
+void CancellationToken::reset() {
+  m_cancelled.store(0);
+}
+
+bool CancellationToken::wait(unsigned long msecs) {
+  QMutexLocker locker(&m_waitMutex);
+
+  if (!isCancelled()) {
+    m_waitCondition.wait(&m_waitMutex, msecs);
+  }
+
+  return isCancelled();
+}
+
+CancellationToken* CancellationToken::current() {
+  return s_currentTokens.hasLocalData() ? s_currentTokens.localData().data() : nullptr;
+}
+
+void CancellationToken::setCurrent(CancellationToken* token) {
+  s_currentTokens.setLocalData(QPointer<CancellationToken>(token));
+}
+
+void CancellationToken::cancel() {
+  m_waitMutex.lock();
+  const bool first_cancel = m_cancelled.testAndSetOrdered(0, 1);
+
+  m_waitCondition.wakeAll();
+  m_waitMutex.unlock();
+
+  // Signal is emitted only once per operation.
+  if (first_cancel) {
+    emit cancelled();
+  }
+}
@@ -0,0 +1,66 @@
+// This file is part of RSS Guard.
+
+//
+// Copyright (C) 2011-2017 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef CANCELLATIONTOKEN_H
+#define CANCELLATIONTOKEN_H
+
+#include <QObject>
+
+#include <QAtomicInt>
+#include <QMutex>
+#include <QWaitCondition>
+
+// Cooperative cancellation of long-running operations.
+//
+// Token is shared by all parts of single operation. Its owner cancels it from
+// any thread, workers either poll isCancelled() or react to cancelled() signal.
+// Worker threads can make the token "current", so that deeply nested code,
+// like network operations, observes it without passing it around explicitly.
+class CancellationToken : public QObject {
+  Q_OBJECT
+
+  public:
+    explicit CancellationToken(QObject* parent = nullptr);
+    virtual ~CancellationToken();
+
+    bool isCancelled() const;
+
+    // Makes token usable again for next operation.
+    void reset();
+
+    // Blocks calling thread for given time, waiting ends early when
+    // token is cancelled. Returns true if token is cancelled.
+    bool wait(unsigned long msecs);
+
+    // Token of operation running in calling thread or nullptr.
+    static CancellationToken* current();
+    static void setCurrent(CancellationToken* token);
+
+  public slots:
+    void cancel();
+
+  signals:
+    void cancelled();
+
+  private:
+    QAtomicInt m_cancelled;
+    QMutex m_waitMutex;
+    QWaitCondition m_waitCondition;
+};
+
+#endif // CANCELLATIONTOKEN_H
@@ -20,17 +20,30 @@
 
 #include "miscellaneous/application.h"
 #include "miscellaneous/databasequeries.h"
+#include "miscellaneous/debugging.h"
+#include "miscellaneous/mutex.h"
 
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QThread>
+#include <QTimer>
 
-DatabaseCleaner::DatabaseCleaner(QObject* parent) : QObject(parent) {}
+DatabaseCleaner::DatabaseCleaner(QObject* parent)
+  : QObject(parent), m_retentionTimer(new QTimer(this)), m_retentionRemoved(0),
+  m_compressionTimer(new QTimer(this)), m_compressionCount(0), m_compressionSavedBytes(0) {
+  m_retentionTimer->setSingleShot(true);
+  m_compressionTimer->setSingleShot(true);
+  connect(m_retentionTimer, &QTimer::timeout, this, &DatabaseCleaner::runRetentionChunk);
+  connect(m_compressionTimer, &QTimer::timeout, this, &DatabaseCleaner::runCompressionChunk);
+}
 
 DatabaseCleaner::~DatabaseCleaner() {}
 
 void DatabaseCleaner::purgeDatabaseData(const CleanerOrders& which_data) {
   qDebug().nospace() << "Performing database cleanup in thread: \'" << QThread::currentThreadId() << "\'.";
 
+  ScopedTiming timing("DatabaseCleaner::purgeDatabaseData");
+
   // Inform everyone about the start of the process.
   emit purgeStarted();
   bool result = true;
@@ -96,3 +109,173 @@ bool DatabaseCleaner::purgeOldMessages(const QSqlDatabase& database, int days) {
 bool DatabaseCleaner::purgeRecycleBin(const QSqlDatabase& database) {
   return DatabaseQueries::purgeRecycleBin(database);
 }
+
+void DatabaseCleaner::startRetention() {
+  m_retentionTimer->start(RETENTION_STARTUP_DELAY);
+}
+
+void DatabaseCleaner::runRetentionChunk() {
+  // Never compete with feed updates or other critical operations,
+  // just try again a little bit later.
+  if (!qApp->feedUpdateLock()->tryLock()) {
+    m_retentionTimer->start(RETENTION_CHUNK_INTERVAL);
+    return;
+  }
+
+  QSqlDatabase database = qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings);
+  QElapsedTimer budget;
+  const int removed_before = m_retentionRemoved;
+
+  budget.start();
+
+  if (m_retentionTasks.isEmpty() && !loadRetentionTasks(database)) {
+    qApp->feedUpdateLock()->unlock();
+    m_retentionTimer->start(RETENTION_IDLE_INTERVAL);
+    return;
+  }
+
+  while (!m_retentionTasks.isEmpty() && !budget.hasExpired(RETENTION_CHUNK_BUDGET)) {
+    const RetentionTask& task = m_retentionTasks.first();
+    bool ok;
+    const QStringList ids = DatabaseQueries::getExpiredMessageIds(database, task.m_policy, task.m_accountId,
+                                                                  task.m_feedCustomId, RETENTION_CHUNK_SIZE, &ok);
+
+    if (!ok || ids.isEmpty() || !DatabaseQueries::purgeMessages(database, ids)) {
+      // This feed is done (or failed), continue with next one.
+      m_retentionTasks.removeFirst();
+    }
+    else {
+      m_retentionRemoved += ids.size();
+    }
+  }
+
+  if (m_retentionRemoved > removed_before) {
+    qApp->database()->incrementalVacuumDatabase(database, RETENTION_VACUUM_PAGES);
+  }
+
+  qApp->feedUpdateLock()->unlock();
+
+  if (m_retentionTasks.isEmpty()) {
+    qDebug("Retention round finished, %d messages were removed.", m_retentionRemoved);
+
+    if (m_retentionRemoved > 0) {
+      emit retentionFinished(m_retentionRemoved);
+    }
+
+    m_retentionRemoved = 0;
+    m_retentionTimer->start(RETENTION_IDLE_INTERVAL);
+  }
+  else {
+    m_retentionTimer->start(RETENTION_CHUNK_INTERVAL);
+  }
+}
+
+void DatabaseCleaner::startCompressionMigration() {
+  if (!m_compressionTimer->isActive()) {
+    m_compressionCount = 0;
+    m_compressionSavedBytes = 0;
+    m_compressionTimer->start(RETENTION_CHUNK_INTERVAL);
+  }
+}
+
+void DatabaseCleaner::stopCompressionMigration() {
+  m_compressionTimer->stop();
+
+  // Progress is reset here, so that it cannot be overwritten by chunk which is just running.
+  qApp->settings()->setValue(GROUP(Database), Database::CompressedUpToId, 0);
+}
+
+void DatabaseCleaner::runCompressionChunk() {
+  if (!qApp->settings()->value(GROUP(Database), SETTING(Database::CompressContents)).toBool()) {
+    // Compression was turned off meanwhile.
+    return;
+  }
+
+  if (!qApp->feedUpdateLock()->tryLock()) {
+    m_compressionTimer->start(RETENTION_CHUNK_INTERVAL);
+    return;
+  }
+
+  QSqlDatabase database = qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings);
+  QElapsedTimer budget;
+  bool ok;
+  const int max_id = DatabaseQueries::getMaxMessageId(database, &ok);
+  int next_id = qApp->settings()->value(GROUP(Database), SETTING(Database::CompressedUpToId)).toInt() + 1;
+
+  budget.start();
+
+  while (ok && next_id <= max_id && !budget.hasExpired(RETENTION_CHUNK_BUDGET)) {
+    const int last_id = next_id + COMPRESSION_MIGRATION_RANGE - 1;
+
+    ok = DatabaseQueries::compressMessages(database, next_id, last_id, &m_compressionSavedBytes, &m_compressionCount);
+
+    if (ok) {
+      // Remember progress, so that migration continues where it stopped after restart.
+      qApp->settings()->setValue(GROUP(Database), Database::CompressedUpToId, last_id);
+      next_id = last_id + 1;
+    }
+  }
+
+  if (m_compressionCount > 0 && (!ok || next_id > max_id)) {
+    qApp->database()->incrementalVacuumDatabase(database, RETENTION_VACUUM_PAGES);
+  }
+
+  qApp->feedUpdateLock()->unlock();
+
+  if (!ok) {
+    qWarning("Compression of stored messages failed, it will be retried later.");
+    m_compressionTimer->start(RETENTION_IDLE_INTERVAL);
+  }
+  else if (next_id > max_id) {
+    qDebug("Compression of stored messages finished, %d messages were compressed, %lld bytes were saved.",
+           m_compressionCount, m_compressionSavedBytes);
+    emit compressionFinished(m_compressionCount, m_compressionSavedBytes);
+  }
+  else {
+    m_compressionTimer->start(RETENTION_CHUNK_INTERVAL);
+  }
+}
+
+bool DatabaseCleaner::loadRetentionTasks(const QSqlDatabase& database) {
+  RetentionPolicy default_policy;
+
+  if (qApp->settings()->value(GROUP(Database), SETTING(Database::RetentionEnabled)).toBool()) {
+    default_policy.m_maxAge = qApp->settings()->value(GROUP(Database), SETTING(Database::RetentionMaxAge)).toInt();
+    default_policy.m_maxCount = qApp->settings()->value(GROUP(Database), SETTING(Database::RetentionMaxCount)).toInt();
+    default_policy.m_keepStarred = qApp->settings()->value(GROUP(Database), SETTING(Database::RetentionKeepStarred)).toBool();
+  }
+
+  bool ok;
+  QHash<int, RetentionPolicy> account_policies;
+  QHash<QPair<int, QString>, RetentionPolicy> feed_policies;
+
+  foreach (const RetentionPolicy& policy, DatabaseQueries::getRetentionPolicies(database, &ok)) {
+    if (policy.m_feedCustomId.isEmpty()) {
+      account_policies.insert(policy.m_accountId, policy);
+    }
+    else {
+      feed_policies.insert(QPair<int, QString>(policy.m_accountId, policy.m_feedCustomId), policy);
+    }
+  }
+
+  if (!ok || (!default_policy.isActive() && account_policies.isEmpty() && feed_policies.isEmpty())) {
+    return false;
+  }
+
+  typedef QPair<int, QString> FeedIdentifier;
+
+  // Policy of feed overrides policy of its account which overrides the default one.
+  foreach (const FeedIdentifier& feed, DatabaseQueries::getFeedsOfAllAccounts(database)) {
+    RetentionTask task;
+
+    task.m_accountId = feed.first;
+    task.m_feedCustomId = feed.second;
+    task.m_policy = feed_policies.value(feed, account_policies.value(feed.first, default_policy));
+
+    if (task.m_policy.isActive()) {
+      m_retentionTasks.append(task);
+    }
+  }
+
+  return !m_retentionTasks.isEmpty();
+}
@@ -21,8 +21,12 @@
 
 #include <QObject>
 
+#include "miscellaneous/databasequeries.h"
+
 #include <QSqlDatabase>
 
+class QTimer;
+
 struct CleanerOrders {
   bool m_removeReadMessages;
   bool m_shrinkDatabase;
@@ -46,14 +50,53 @@ class DatabaseCleaner : public QObject {
     void purgeProgress(int progress, const QString& description);
     void purgeFinished(bool result);
 
+    // Emitted when round of automatic retention removed some messages.
+    void retentionFinished(int removed_messages);
+
+    // Emitted when migration of stored messages to compressed form finishes.
+    void compressionFinished(int compressed_messages, qint64 saved_bytes);
+
   public slots:
     void purgeDatabaseData(const CleanerOrders& which_data);
 
+    // Starts periodic enforcing of retention policies.
+    void startRetention();
+
+    // Starts background compression of already stored messages.
+    void startCompressionMigration();
+
+    // Stops compression of stored messages and forgets its progress.
+    void stopCompressionMigration();
+
+  private slots:
+
+    // Processes pending retention work until time budget
+    // of single chunk is exhausted and schedules the next chunk.
+    void runRetentionChunk();
+
+    // Compresses next range of stored messages.
+    void runCompressionChunk();
+
   private:
+    struct RetentionTask {
+      RetentionPolicy m_policy;
+      int m_accountId;
+      QString m_feedCustomId;
+    };
+
+    bool loadRetentionTasks(const QSqlDatabase& database);
+
     bool purgeStarredMessages(const QSqlDatabase& database);
     bool purgeReadMessages(const QSqlDatabase& database);
     bool purgeOldMessages(const QSqlDatabase& database, int days);
     bool purgeRecycleBin(const QSqlDatabase& database);
+
+    QTimer* m_retentionTimer;
+    QList<RetentionTask> m_retentionTasks;
+    int m_retentionRemoved;
+    QTimer* m_compressionTimer;
+    int m_compressionCount;
+    qint64 m_compressionSavedBytes;
 };
 
 #endif // DATABASECLEANER_H
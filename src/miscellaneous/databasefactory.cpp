@@ -322,6 +322,10 @@ QSqlDatabase DatabaseFactory::sqliteInitializeFileBasedDatabase(const QString& c
     query_db.exec(QSL("PRAGMA count_changes = OFF"));
     query_db.exec(QSL("PRAGMA temp_store = MEMORY"));
 
+    // Takes effect only for newly created database, existing
+    // databases are switched by schema update.
+    query_db.exec(QSL("PRAGMA auto_vacuum = INCREMENTAL"));
+
     // Sample query which checks for existence of tables.
     if (!query_db.exec(QSL("SELECT inf_value FROM Information WHERE inf_key = 'schema_version'"))) {
       qWarning("Error occurred. File-based SQLite database is not initialized. Initializing now.");
@@ -581,6 +585,10 @@ DatabaseFactory::UsedDriver DatabaseFactory::activeDatabaseDriver() const {
   return m_activeDatabaseDriver;
 }
 
+KnownMessagesFilter* DatabaseFactory::knownMessages() {
+  return &m_knownMessages;
+}
+
 QSqlDatabase DatabaseFactory::mysqlConnection(const QString& connection_name) {
   if (!m_mysqlDatabaseInitialized) {
     // Return initialized database.
@@ -809,6 +817,27 @@ void DatabaseFactory::saveDatabase() {
   }
 }
 
+bool DatabaseFactory::incrementalVacuumDatabase(QSqlDatabase database, int pages) {
+  // Only file-based SQLite database can shrink incrementally, working in-memory
+  // database does not need it and MySQL reuses freed space on its own.
+  if (m_activeDatabaseDriver != SQLITE) {
+    return true;
+  }
+
+  QSqlQuery query_vacuum(database);
+
+  query_vacuum.setForwardOnly(true);
+
+  if (!query_vacuum.exec(QString(QSL("PRAGMA incremental_vacuum(%1)")).arg(pages))) {
+    return false;
+  }
+
+  // Pages are freed while the statement is being stepped through.
+  while (query_vacuum.next()) {}
+
+  return true;
+}
+
 bool DatabaseFactory::vacuumDatabase() {
   switch (m_activeDatabaseDriver) {
     case SQLITE_MEMORY:
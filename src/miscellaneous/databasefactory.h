@@ -20,6 +20,9 @@
 #define DATABASEFACTORY_H
 
 #include <QObject>
+
+#include "miscellaneous/knownmessagesfilter.h"
+
 #include <QSqlDatabase>
 
 class DatabaseFactory : public QObject {
@@ -88,9 +91,16 @@ class DatabaseFactory : public QObject {
     // Performs cleanup of the database.
     bool vacuumDatabase();
 
+    // Returns up to given count of free pages back to file system
+    // using given connection, which is cheap enough to be done often.
+    bool incrementalVacuumDatabase(QSqlDatabase database, int pages);
+
     // Returns identification of currently active database driver.
     UsedDriver activeDatabaseDriver() const;
 
+    // Returns in-memory index of messages stored in the database.
+    KnownMessagesFilter* knownMessages();
+
     // Copies selected backup database (file) to active database path.
     bool initiateRestoration(const QString& database_backup_file_path);
 
@@ -128,6 +138,8 @@ class DatabaseFactory : public QObject {
     // Holds the type of currently activated database backend.
     UsedDriver m_activeDatabaseDriver;
 
+    KnownMessagesFilter m_knownMessages;
+
     //
     // MYSQL stuff.
     //
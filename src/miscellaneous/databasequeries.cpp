@@ -18,7 +18,10 @@
 
 #include "miscellaneous/databasequeries.h"
 
+#include "core/feedfailuretracker.h"
 #include "miscellaneous/application.h"
+#include "miscellaneous/debugging.h"
+#include "miscellaneous/feedreader.h"
 #include "miscellaneous/iconfactory.h"
 #include "miscellaneous/textfactory.h"
 #include "services/abstract/category.h"
@@ -45,12 +48,41 @@
 #include <QUrl>
 #include <QVariant>
 
-bool DatabaseQueries::markMessagesReadUnread(QSqlDatabase db, const QStringList& ids, RootItem::ReadStatus read) {
+bool DatabaseQueries::execForMessageIds(QSqlDatabase db, const QString& statement, const QStringList& ids) {
   QSqlQuery q(db);
 
   q.setForwardOnly(true);
-  return q.exec(QString(QSL("UPDATE Messages SET is_read = %2 WHERE id IN (%1);"))
-                .arg(ids.join(QSL(", ")), read == RootItem::Read ? QSL("1") : QSL("0")));
+
+  // Large lists of IDs are split into chunks so that single statement
+  // does not exceed limits of SQL server, all chunks share one transaction.
+  const bool own_transaction = ids.size() > MESSAGES_SQL_ID_CHUNK_SIZE && db.transaction();
+
+  for (int i = 0; i < ids.size(); i += MESSAGES_SQL_ID_CHUNK_SIZE) {
+    if (!q.exec(statement.arg(ids.mid(i, MESSAGES_SQL_ID_CHUNK_SIZE).join(QSL(", "))))) {
+      qWarning("Bulk update of messages failed: '%s'.", qPrintable(q.lastError().text()));
+
+      if (own_transaction) {
+        db.rollback();
+      }
+
+      return false;
+    }
+  }
+
+  if (own_transaction && !db.commit()) {
+    qWarning("Transaction commit for bulk update of messages failed: '%s'.", qPrintable(db.lastError().text()));
+    db.rollback();
+    return false;
+  }
+
+  return true;
+}
+
+bool DatabaseQueries::markMessagesReadUnread(QSqlDatabase db, const QStringList& ids, RootItem::ReadStatus read) {
+  ScopedTiming timing("DatabaseQueries::markMessagesReadUnread", ids.size());
+
+  return execForMessageIds(db, QString(QSL("UPDATE Messages SET is_read = %1 WHERE id IN (%2);"))
+                           .arg(read == RootItem::Read ? QSL("1") : QSL("0")), ids);
 }
 
 bool DatabaseQueries::markMessageImportant(QSqlDatabase db, int id, RootItem::Importance importance) {
@@ -103,26 +135,16 @@ bool DatabaseQueries::markAccountReadUnread(QSqlDatabase db, int account_id, Roo
 }
 
 bool DatabaseQueries::switchMessagesImportance(QSqlDatabase db, const QStringList& ids) {
-  QSqlQuery q(db);
-
-  q.setForwardOnly(true);
-  return q.exec(QString(QSL("UPDATE Messages SET is_important = NOT is_important WHERE id IN (%1);")).arg(ids.join(QSL(", "))));
+  return execForMessageIds(db, QSL("UPDATE Messages SET is_important = NOT is_important WHERE id IN (%1);"), ids);
 }
 
 bool DatabaseQueries::permanentlyDeleteMessages(QSqlDatabase db, const QStringList& ids) {
-  QSqlQuery q(db);
-
-  q.setForwardOnly(true);
-  return q.exec(QString(QSL("UPDATE Messages SET is_pdeleted = 1 WHERE id IN (%1);")).arg(ids.join(QSL(", "))));
+  return execForMessageIds(db, QSL("UPDATE Messages SET is_pdeleted = 1 WHERE id IN (%1);"), ids);
 }
 
 bool DatabaseQueries::deleteOrRestoreMessagesToFromBin(QSqlDatabase db, const QStringList& ids, bool deleted) {
-  QSqlQuery q(db);
-
-  q.setForwardOnly(true);
-  return q.exec(QString(QSL("UPDATE Messages SET is_deleted = %2, is_pdeleted = %3 WHERE id IN (%1);")).arg(ids.join(QSL(", ")),
-                                                                                                            QString::number(deleted ? 1 : 0),
-                                                                                                            QString::number(0)));
+  return execForMessageIds(db, QString(QSL("UPDATE Messages SET is_deleted = %1, is_pdeleted = 0 WHERE id IN (%2);"))
+                           .arg(QString::number(deleted ? 1 : 0)), ids);
 }
 
 bool DatabaseQueries::restoreBin(QSqlDatabase db, int account_id) {
@@ -140,7 +162,14 @@ bool DatabaseQueries::purgeImportantMessages(QSqlDatabase db) {
 
   q.setForwardOnly(true);
   q.prepare(QSL("DELETE FROM Messages WHERE is_important = 1;"));
-  return q.exec();
+
+  // Known messages are forgotten only after they are really removed.
+  if (!q.exec()) {
+    return false;
+  }
+
+  qApp->database()->knownMessages()->clear();
+  return true;
 }
 
 bool DatabaseQueries::purgeReadMessages(QSqlDatabase db) {
@@ -155,7 +184,13 @@ bool DatabaseQueries::purgeReadMessages(QSqlDatabase db) {
 
   // Remove only messages which are NOT starred.
   q.bindValue(QSL(":is_important"), 0);
-  return q.exec();
+
+  if (!q.exec()) {
+    return false;
+  }
+
+  qApp->database()->knownMessages()->clear();
+  return true;
 }
 
 bool DatabaseQueries::purgeOldMessages(QSqlDatabase db, int older_than_days) {
@@ -168,7 +203,13 @@ bool DatabaseQueries::purgeOldMessages(QSqlDatabase db, int older_than_days) {
 
   // Remove only messages which are NOT starred.
   q.bindValue(QSL(":is_important"), 0);
-  return q.exec();
+
+  if (!q.exec()) {
+    return false;
+  }
+
+  qApp->database()->knownMessages()->clear();
+  return true;
 }
 
 bool DatabaseQueries::purgeRecycleBin(QSqlDatabase db) {
@@ -180,11 +221,444 @@ bool DatabaseQueries::purgeRecycleBin(QSqlDatabase db) {
 
   // Remove only messages which are NOT starred.
   q.bindValue(QSL(":is_important"), 0);
+
+  if (!q.exec()) {
+    return false;
+  }
+
+  qApp->database()->knownMessages()->clear();
+  return true;
+}
+
+bool DatabaseQueries::purgeMessages(QSqlDatabase db, const QStringList& ids) {
+  // Rows are kept as permanently deleted, so that messages which are still
+  // present in their feeds are recognized and not added again as new ones.
+  return execForMessageIds(db, QSL("UPDATE Messages SET is_pdeleted = 1, contents = '', enclosures = '' "
+                                   "WHERE id IN (%1);"), ids);
+}
+
+QList<RetentionPolicy> DatabaseQueries::getRetentionPolicies(QSqlDatabase db, bool* ok) {
+  QSqlQuery q(db);
+  QList<RetentionPolicy> policies;
+
+  q.setForwardOnly(true);
+
+  if (!q.exec(QSL("SELECT account_id, feed, max_age, max_count, keep_starred FROM RetentionPolicies;"))) {
+    qWarning("Query for obtaining retention policies failed: '%s'.", qPrintable(q.lastError().text()));
+
+    if (ok != nullptr) {
+      *ok = false;
+    }
+
+    return policies;
+  }
+
+  while (q.next()) {
+    RetentionPolicy policy;
+
+    policy.m_accountId = q.value(0).toInt();
+    policy.m_feedCustomId = q.value(1).toString();
+    policy.m_maxAge = q.value(2).toInt();
+    policy.m_maxCount = q.value(3).toInt();
+    policy.m_keepStarred = q.value(4).toBool();
+    policies.append(policy);
+  }
+
+  if (ok != nullptr) {
+    *ok = true;
+  }
+
+  return policies;
+}
+
+RetentionPolicy DatabaseQueries::getRetentionPolicy(QSqlDatabase db, int account_id, const QString& feed_custom_id, bool* ok) {
+  QSqlQuery q(db);
+  RetentionPolicy policy;
+
+  q.setForwardOnly(true);
+
+  if (feed_custom_id.isEmpty()) {
+    q.prepare(QSL("SELECT max_age, max_count, keep_starred FROM RetentionPolicies "
+                  "WHERE account_id = :account_id AND feed IS NULL;"));
+  }
+  else {
+    q.prepare(QSL("SELECT max_age, max_count, keep_starred FROM RetentionPolicies "
+                  "WHERE account_id = :account_id AND feed = :feed;"));
+    q.bindValue(QSL(":feed"), feed_custom_id);
+  }
+
+  q.bindValue(QSL(":account_id"), account_id);
+
+  if (q.exec() && q.next()) {
+    policy.m_accountId = account_id;
+    policy.m_feedCustomId = feed_custom_id;
+    policy.m_maxAge = q.value(0).toInt();
+    policy.m_maxCount = q.value(1).toInt();
+    policy.m_keepStarred = q.value(2).toBool();
+
+    if (ok != nullptr) {
+      *ok = true;
+    }
+  }
+  else if (ok != nullptr) {
+    *ok = false;
+  }
+
+  return policy;
+}
+
+bool DatabaseQueries::storeRetentionPolicy(QSqlDatabase db, const RetentionPolicy& policy) {
+  if (!deleteRetentionPolicy(db, policy.m_accountId, policy.m_feedCustomId)) {
+    return false;
+  }
+
+  QSqlQuery q(db);
+
+  q.setForwardOnly(true);
+  q.prepare(QSL("INSERT INTO RetentionPolicies (account_id, feed, max_age, max_count, keep_starred) "
+                "VALUES (:account_id, :feed, :max_age, :max_count, :keep_starred);"));
+  q.bindValue(QSL(":account_id"), policy.m_accountId);
+  q.bindValue(QSL(":feed"), policy.m_feedCustomId.isEmpty() ? QVariant(QVariant::String) : policy.m_feedCustomId);
+  q.bindValue(QSL(":max_age"), policy.m_maxAge);
+  q.bindValue(QSL(":max_count"), policy.m_maxCount);
+  q.bindValue(QSL(":keep_starred"), policy.m_keepStarred ? 1 : 0);
   return q.exec();
 }
 
+bool DatabaseQueries::deleteRetentionPolicy(QSqlDatabase db, int account_id, const QString& feed_custom_id) {
+  QSqlQuery q(db);
+
+  q.setForwardOnly(true);
+
+  if (feed_custom_id.isEmpty()) {
+    q.prepare(QSL("DELETE FROM RetentionPolicies WHERE account_id = :account_id AND feed IS NULL;"));
+  }
+  else {
+    q.prepare(QSL("DELETE FROM RetentionPolicies WHERE account_id = :account_id AND feed = :feed;"));
+    q.bindValue(QSL(":feed"), feed_custom_id);
+  }
+
+  q.bindValue(QSL(":account_id"), account_id);
+  return q.exec();
+}
+
+QList<FeedFailureState> DatabaseQueries::getFeedFailures(QSqlDatabase db, bool* ok) {
+  QSqlQuery q(db);
+  QList<FeedFailureState> failures;
+
+  q.setForwardOnly(true);
+
+  if (!q.exec(QSL("SELECT account_id, feed, failures, last_failure, next_attempt FROM FeedFailures;"))) {
+    qWarning("Query for obtaining feed failures failed: '%s'.", qPrintable(q.lastError().text()));
+
+    if (ok != nullptr) {
+      *ok = false;
+    }
+
+    return failures;
+  }
+
+  while (q.next()) {
+    FeedFailureState state;
+
+    state.m_accountId = q.value(0).toInt();
+    state.m_feedCustomId = q.value(1).toString();
+    state.m_failures = q.value(2).toInt();
+    state.m_lastFailure = q.value(3).value<qint64>();
+    state.m_nextAttempt = q.value(4).value<qint64>();
+    failures.append(state);
+  }
+
+  if (ok != nullptr) {
+    *ok = true;
+  }
+
+  return failures;
+}
+
+bool DatabaseQueries::storeFeedFailures(QSqlDatabase db, const QList<FeedFailureState>& failures) {
+  QSqlQuery q(db);
+
+  q.setForwardOnly(true);
+
+  if (!db.transaction()) {
+    qWarning("Transaction start for storing of feed failures failed: '%s'.", qPrintable(db.lastError().text()));
+    return false;
+  }
+
+  if (!q.exec(QSL("DELETE FROM FeedFailures;"))) {
+    qWarning("Removing of feed failures failed: '%s'.", qPrintable(q.lastError().text()));
+    db.rollback();
+    return false;
+  }
+
+  q.prepare(QSL("INSERT INTO FeedFailures (account_id, feed, failures, last_failure, next_attempt) "
+                "VALUES (:account_id, :feed, :failures, :last_failure, :next_attempt);"));
+
+  foreach (const FeedFailureState& state, failures) {
+    q.bindValue(QSL(":account_id"), state.m_accountId);
+    q.bindValue(QSL(":feed"), state.m_feedCustomId);
+    q.bindValue(QSL(":failures"), state.m_failures);
+    q.bindValue(QSL(":last_failure"), state.m_lastFailure);
+    q.bindValue(QSL(":next_attempt"), state.m_nextAttempt);
+
+    if (!q.exec()) {
+      qWarning("Storing of feed failures failed: '%s'.", qPrintable(q.lastError().text()));
+      db.rollback();
+      return false;
+    }
+  }
+
+  if (!db.commit()) {
+    db.rollback();
+    return false;
+  }
+
+  return true;
+}
+
+QList<HostCircuitState> DatabaseQueries::getHostCircuits(QSqlDatabase db, bool* ok) {
+  QSqlQuery q(db);
+  QList<HostCircuitState> circuits;
+
+  q.setForwardOnly(true);
+
+  if (!q.exec(QSL("SELECT host, failures, open_until FROM HostCircuits;"))) {
+    qWarning("Query for obtaining host circuits failed: '%s'.", qPrintable(q.lastError().text()));
+
+    if (ok != nullptr) {
+      *ok = false;
+    }
+
+    return circuits;
+  }
+
+  while (q.next()) {
+    HostCircuitState state;
+
+    state.m_host = q.value(0).toString();
+    state.m_failures = q.value(1).toInt();
+    state.m_openUntil = q.value(2).value<qint64>();
+    circuits.append(state);
+  }
+
+  if (ok != nullptr) {
+    *ok = true;
+  }
+
+  return circuits;
+}
+
+bool DatabaseQueries::storeHostCircuits(QSqlDatabase db, const QList<HostCircuitState>& circuits) {
+  QSqlQuery q(db);
+
+  q.setForwardOnly(true);
+
+  if (!db.transaction()) {
+    qWarning("Transaction start for storing of host circuits failed: '%s'.", qPrintable(db.lastError().text()));
+    return false;
+  }
+
+  if (!q.exec(QSL("DELETE FROM HostCircuits;"))) {
+    qWarning("Removing of host circuits failed: '%s'.", qPrintable(q.lastError().text()));
+    db.rollback();
+    return false;
+  }
+
+  q.prepare(QSL("INSERT INTO HostCircuits (host, failures, open_until) VALUES (:host, :failures, :open_until);"));
+
+  foreach (const HostCircuitState& state, circuits) {
+    q.bindValue(QSL(":host"), state.m_host);
+    q.bindValue(QSL(":failures"), state.m_failures);
+    q.bindValue(QSL(":open_until"), state.m_openUntil);
+
+    if (!q.exec()) {
+      qWarning("Storing of host circuits failed: '%s'.", qPrintable(q.lastError().text()));
+      db.rollback();
+      return false;
+    }
+  }
+
+  if (!db.commit()) {
+    db.rollback();
+    return false;
+  }
+
+  return true;
+}
+
+QList<QPair<int, QString>> DatabaseQueries::getFeedsOfAllAccounts(QSqlDatabase db, bool* ok) {
+  QSqlQuery q(db);
+  QList<QPair<int, QString>> feeds;
+
+  q.setForwardOnly(true);
+
+  if (ok != nullptr) {
+    *ok = q.exec(QSL("SELECT account_id, custom_id FROM Feeds;"));
+  }
+  else {
+    q.exec(QSL("SELECT account_id, custom_id FROM Feeds;"));
+  }
+
+  while (q.next()) {
+    feeds.append(QPair<int, QString>(q.value(0).toInt(), q.value(1).toString()));
+  }
+
+  return feeds;
+}
+
+QStringList DatabaseQueries::getExpiredMessageIds(QSqlDatabase db, const RetentionPolicy& policy, int account_id,
+                                                  const QString& feed_custom_id, int limit, bool* ok) {
+  QSqlQuery q(db);
+  QStringList ids;
+  const QString starred_condition = policy.m_keepStarred ? QSL(" AND is_important = 0") : QString();
+
+  q.setForwardOnly(true);
+
+  if (ok != nullptr) {
+    *ok = true;
+  }
+
+  // Messages older than allowed age go first.
+  if (policy.m_maxAge > 0) {
+    q.prepare(QString(QSL("SELECT id FROM Messages WHERE account_id = :account_id AND feed = :feed AND "
+                          "is_pdeleted = 0 AND date_created < :date_created%1 LIMIT %2;")).arg(starred_condition, QString::number(limit)));
+    q.bindValue(QSL(":account_id"), account_id);
+    q.bindValue(QSL(":feed"), feed_custom_id);
+    q.bindValue(QSL(":date_created"), QDateTime::currentDateTimeUtc().addDays(-policy.m_maxAge).toMSecsSinceEpoch());
+
+    if (!q.exec()) {
+      if (ok != nullptr) {
+        *ok = false;
+      }
+
+      return ids;
+    }
+
+    while (q.next()) {
+      ids.append(q.value(0).toString());
+    }
+
+    if (!ids.isEmpty()) {
+      return ids;
+    }
+  }
+
+  // Then messages beyond allowed count, newest messages are kept.
+  if (policy.m_maxCount > 0) {
+    q.prepare(QString(QSL("SELECT id FROM Messages WHERE account_id = :account_id AND feed = :feed AND is_pdeleted = 0%1 "
+                          "ORDER BY date_created DESC LIMIT %2 OFFSET %3;")).arg(starred_condition,
+                                                                                  QString::number(limit),
+                                                                                  QString::number(policy.m_maxCount)));
+    q.bindValue(QSL(":account_id"), account_id);
+    q.bindValue(QSL(":feed"), feed_custom_id);
+
+    if (!q.exec()) {
+      if (ok != nullptr) {
+        *ok = false;
+      }
+
+      return ids;
+    }
+
+    while (q.next()) {
+      ids.append(q.value(0).toString());
+    }
+  }
+
+  return ids;
+}
+
+int DatabaseQueries::getMaxMessageId(QSqlDatabase db, bool* ok) {
+  QSqlQuery q(db);
+
+  q.setForwardOnly(true);
+
+  if (q.exec(QSL("SELECT MAX(id) FROM Messages;")) && q.next()) {
+    if (ok != nullptr) {
+      *ok = true;
+    }
+
+    return q.value(0).toInt();
+  }
+  else {
+    if (ok != nullptr) {
+      *ok = false;
+    }
+
+    return 0;
+  }
+}
+
+bool DatabaseQueries::compressMessages(QSqlDatabase db, int from_id, int to_id, qint64* saved_bytes, int* compressed_count) {
+  QSqlQuery q_select(db);
+  QSqlQuery q_update(db);
+
+  q_select.setForwardOnly(true);
+  q_update.setForwardOnly(true);
+  q_select.prepare(QSL("SELECT id, contents, enclosures FROM Messages WHERE id >= :from_id AND id <= :to_id;"));
+  q_select.bindValue(QSL(":from_id"), from_id);
+  q_select.bindValue(QSL(":to_id"), to_id);
+  q_update.prepare(QSL("UPDATE Messages SET contents = :contents, enclosures = :enclosures WHERE id = :id;"));
+
+  if (!q_select.exec()) {
+    qWarning("Query for messages to compress failed: '%s'.", qPrintable(q_select.lastError().text()));
+    return false;
+  }
+
+  // Compress everything first, so that we do not update rows while iterating them.
+  QList<QPair<int, QPair<QString, QString>>> compressed_rows;
+
+  while (q_select.next()) {
+    const QString contents = q_select.value(1).toString();
+    const QString enclosures = q_select.value(2).toString();
+    const QString compressed_contents = MessageCompression::compress(contents);
+    const QString compressed_enclosures = MessageCompression::compress(enclosures);
+
+    if (compressed_contents != contents || compressed_enclosures != enclosures) {
+      *saved_bytes += contents.toUtf8().size() + enclosures.toUtf8().size() -
+                      compressed_contents.size() - compressed_enclosures.size();
+      compressed_rows.append(QPair<int, QPair<QString, QString>>(q_select.value(0).toInt(),
+                                                                 QPair<QString, QString>(compressed_contents,
+                                                                                         compressed_enclosures)));
+    }
+  }
+
+  q_select.finish();
+
+  if (compressed_rows.isEmpty()) {
+    return true;
+  }
+
+  if (!db.transaction()) {
+    qWarning("Transaction start for compression of messages failed: '%s'.", qPrintable(db.lastError().text()));
+    return false;
+  }
+
+  foreach (const auto& row, compressed_rows) {
+    q_update.bindValue(QSL(":contents"), row.second.first);
+    q_update.bindValue(QSL(":enclosures"), row.second.second);
+    q_update.bindValue(QSL(":id"), row.first);
+
+    if (!q_update.exec()) {
+      qWarning("Compression of message failed: '%s'.", qPrintable(q_update.lastError().text()));
+      db.rollback();
+      return false;
+    }
+  }
+
+  if (!db.commit()) {
+    db.rollback();
+    return false;
+  }
+
+  *compressed_count += compressed_rows.size();
+  return true;
+}
+
 QMap<QString, QPair<int, int>> DatabaseQueries::getMessageCountsForCategory(QSqlDatabase db, const QString& custom_id, int account_id,
                                                                             bool including_total_counts, bool* ok) {
+  ScopedTiming timing("DatabaseQueries::getMessageCountsForCategory");
   QMap<QString, QPair<int, int>> counts;
   QSqlQuery q(db);
 
@@ -234,6 +708,7 @@ QMap<QString, QPair<int, int>> DatabaseQueries::getMessageCountsForCategory(QSql
 
 QMap<QString, QPair<int, int>> DatabaseQueries::getMessageCountsForAccount(QSqlDatabase db, int account_id,
                                                                            bool including_total_counts, bool* ok) {
+  ScopedTiming timing("DatabaseQueries::getMessageCountsForAccount");
   QMap<QString, QPair<int, int>> counts;
   QSqlQuery q(db);
 
@@ -282,6 +757,7 @@ QMap<QString, QPair<int, int>> DatabaseQueries::getMessageCountsForAccount(QSqlD
 
 int DatabaseQueries::getMessageCountsForFeed(QSqlDatabase db, const QString& feed_custom_id,
                                              int account_id, bool including_total_counts, bool* ok) {
+  ScopedTiming timing("DatabaseQueries::getMessageCountsForFeed");
   QSqlQuery q(db);
 
   q.setForwardOnly(true);
@@ -453,6 +929,8 @@ int DatabaseQueries::updateMessages(QSqlDatabase db,
                                     const QString& url,
                                     bool* any_message_changed,
                                     bool* ok) {
+  ScopedTiming timing("DatabaseQueries::updateMessages", messages.size());
+
   if (messages.isEmpty()) {
     *any_message_changed = false;
     *ok = true;
@@ -460,10 +938,22 @@ int DatabaseQueries::updateMessages(QSqlDatabase db,
   }
 
   bool use_transactions = qApp->settings()->value(GROUP(Database), SETTING(Database::UseTransactions)).toBool();
+  const bool compress_contents = qApp->settings()->value(GROUP(Database), SETTING(Database::CompressContents)).toBool();
+  KnownMessagesFilter* known_messages = qApp->database()->knownMessages();
 
   // Does not make any difference, since each feed now has
   // its own "custom ID" (standard feeds have their custom ID equal to primary key ID).
   int updated_messages = 0;
+  int skipped_messages = 0;
+
+  // Messages without custom ID are recognized via in-memory index first,
+  // so that only new or changed messages need to be looked up in DB.
+  foreach (const Message& message, messages) {
+    if (message.m_customId.isEmpty()) {
+      known_messages->ensureLoaded(db, account_id, feed_custom_id);
+      break;
+    }
+  }
 
   // Prepare queries.
   QSqlQuery query_select_with_url(db);
@@ -520,6 +1010,11 @@ int DatabaseQueries::updateMessages(QSqlDatabase db,
       message.m_url = new_message_url;
     }
 
+    if (known_messages->isStoredUnchanged(account_id, feed_custom_id, message)) {
+      skipped_messages++;
+      continue;
+    }
+
     int id_existing_message = -1;
     qint64 date_existing_message;
     bool is_read_existing_message;
@@ -540,7 +1035,7 @@ int DatabaseQueries::updateMessages(QSqlDatabase db,
         date_existing_message = query_select_with_url.value(1).value<qint64>();
         is_read_existing_message = query_select_with_url.value(2).toBool();
         is_important_existing_message = query_select_with_url.value(3).toBool();
-        contents_existing_message = query_select_with_url.value(4).toString();
+        contents_existing_message = MessageCompression::decompress(query_select_with_url.value(4).toString());
       }
       else if (query_select_with_url.lastError().isValid()) {
         qWarning("Failed to check for existing message in DB via URL: '%s'.", qPrintable(query_select_with_url.lastError().text()));
@@ -559,7 +1054,7 @@ int DatabaseQueries::updateMessages(QSqlDatabase db,
         date_existing_message = query_select_with_id.value(1).value<qint64>();
         is_read_existing_message = query_select_with_id.value(2).toBool();
         is_important_existing_message = query_select_with_id.value(3).toBool();
-        contents_existing_message = query_select_with_id.value(4).toString();
+        contents_existing_message = MessageCompression::decompress(query_select_with_id.value(4).toString());
       }
       else if (query_select_with_id.lastError().isValid()) {
         qDebug("Failed to check for existing message in DB via ID: '%s'.", qPrintable(query_select_with_id.lastError().text()));
@@ -568,6 +1063,14 @@ int DatabaseQueries::updateMessages(QSqlDatabase db,
       query_select_with_id.finish();
     }
 
+    QString stored_contents = message.m_contents;
+    QString stored_enclosures = Enclosures::encodeEnclosuresToString(message.m_enclosures);
+
+    if (compress_contents) {
+      stored_contents = MessageCompression::compress(stored_contents);
+      stored_enclosures = MessageCompression::compress(stored_enclosures);
+    }
+
     // Now, check if this message is already in the DB.
     if (id_existing_message >= 0) {
       // Message is already in the DB.
@@ -588,8 +1091,8 @@ int DatabaseQueries::updateMessages(QSqlDatabase db,
         query_update.bindValue(QSL(":url"), message.m_url);
         query_update.bindValue(QSL(":author"), message.m_author);
         query_update.bindValue(QSL(":date_created"), message.m_created.toMSecsSinceEpoch());
-        query_update.bindValue(QSL(":contents"), message.m_contents);
-        query_update.bindValue(QSL(":enclosures"), Enclosures::encodeEnclosuresToString(message.m_enclosures));
+        query_update.bindValue(QSL(":contents"), stored_contents);
+        query_update.bindValue(QSL(":enclosures"), stored_enclosures);
         query_update.bindValue(QSL(":id"), id_existing_message);
         *any_message_changed = true;
 
@@ -600,8 +1103,15 @@ int DatabaseQueries::updateMessages(QSqlDatabase db,
           qWarning("Failed to update message in DB: '%s'.", qPrintable(query_update.lastError().text()));
         }
 
+        if (!query_update.lastError().isValid()) {
+          known_messages->remember(account_id, feed_custom_id, message, message.m_created.toMSecsSinceEpoch(), message.m_contents);
+        }
+
         query_update.finish();
-        qDebug("Updating message '%s' in DB.", qPrintable(message.m_title));
+        qCDebugHot(LOG_DATABASE, "Updating message '%s' in DB.", qPrintable(message.m_title));
+      }
+      else {
+        known_messages->remember(account_id, feed_custom_id, message, date_existing_message, contents_existing_message);
       }
     }
     else {
@@ -613,15 +1123,16 @@ int DatabaseQueries::updateMessages(QSqlDatabase db,
       query_insert.bindValue(QSL(":url"), message.m_url);
       query_insert.bindValue(QSL(":author"), message.m_author);
       query_insert.bindValue(QSL(":date_created"), message.m_created.toMSecsSinceEpoch());
-      query_insert.bindValue(QSL(":contents"), message.m_contents);
-      query_insert.bindValue(QSL(":enclosures"), Enclosures::encodeEnclosuresToString(message.m_enclosures));
+      query_insert.bindValue(QSL(":contents"), stored_contents);
+      query_insert.bindValue(QSL(":enclosures"), stored_enclosures);
       query_insert.bindValue(QSL(":custom_id"), message.m_customId);
       query_insert.bindValue(QSL(":custom_hash"), message.m_customHash);
       query_insert.bindValue(QSL(":account_id"), account_id);
 
       if (query_insert.exec() && query_insert.numRowsAffected() == 1) {
         updated_messages++;
-        qDebug("Added new message '%s' to DB.", qPrintable(message.m_title));
+        known_messages->remember(account_id, feed_custom_id, message, message.m_created.toMSecsSinceEpoch(), message.m_contents);
+        qCDebugHot(LOG_DATABASE, "Added new message '%s' to DB.", qPrintable(message.m_title));
       }
       else if (query_insert.lastError().isValid()) {
         qWarning("Failed to insert message to DB: '%s' - message title is '%s'.",
@@ -645,6 +1156,9 @@ int DatabaseQueries::updateMessages(QSqlDatabase db,
     qCritical("Transaction commit for message downloader failed: '%s'.", qPrintable(db.lastError().text()));
     db.rollback();
 
+    // Index may now contain messages which were rolled back.
+    known_messages->invalidateFeed(account_id, feed_custom_id);
+
     if (ok != nullptr) {
       *ok = false;
       updated_messages = 0;
@@ -656,6 +1170,8 @@ int DatabaseQueries::updateMessages(QSqlDatabase db,
     }
   }
 
+  qCDebugHot(LOG_DATABASE, "%d messages of feed '%s' were skipped as known and unchanged.",
+             skipped_messages, qPrintable(feed_custom_id));
   return updated_messages;
 }
 
@@ -682,24 +1198,32 @@ bool DatabaseQueries::deleteAccount(QSqlDatabase db, int account_id) {
   QStringList queries;
 
   queries << QSL("DELETE FROM Messages WHERE account_id = :account_id;") <<
+    QSL("DELETE FROM FeedFailures WHERE account_id = :account_id;") <<
+    QSL("DELETE FROM RetentionPolicies WHERE account_id = :account_id;") <<
     QSL("DELETE FROM Feeds WHERE account_id = :account_id;") <<
     QSL("DELETE FROM Categories WHERE account_id = :account_id;") <<
     QSL("DELETE FROM Accounts WHERE id = :account_id;");
 
+  bool result = true;
+
   foreach (const QString& q, queries) {
     query.prepare(q);
     query.bindValue(QSL(":account_id"), account_id);
 
     if (!query.exec()) {
       qCritical("Removing of account from DB failed, this is critical: '%s'.", qPrintable(query.lastError().text()));
-      return false;
+      result = false;
+      break;
     }
     else {
       query.finish();
     }
   }
 
-  return true;
+  // Messages might be removed even if some later step failed.
+  qApp->database()->knownMessages()->invalidateAccount(account_id);
+  qApp->feedReader()->failureTracker()->forgetAccount(account_id);
+  return result;
 }
 
 bool DatabaseQueries::deleteAccountData(QSqlDatabase db, int account_id, bool delete_messages_too) {
@@ -711,7 +1235,13 @@ bool DatabaseQueries::deleteAccountData(QSqlDatabase db, int account_id, bool de
   if (delete_messages_too) {
     q.prepare(QSL("DELETE FROM Messages WHERE account_id = :account_id;"));
     q.bindValue(QSL(":account_id"), account_id);
-    result &= q.exec();
+
+    if (q.exec()) {
+      qApp->database()->knownMessages()->invalidateAccount(account_id);
+    }
+    else {
+      result = false;
+    }
   }
 
   q.prepare(QSL("DELETE FROM Feeds WHERE account_id = :account_id;"));
@@ -766,6 +1296,7 @@ bool DatabaseQueries::purgeLeftoverMessages(QSqlDatabase db, int account_id) {
     return false;
   }
   else {
+    qApp->database()->knownMessages()->invalidateAccount(account_id);
     return true;
   }
 }
@@ -1096,6 +1627,28 @@ bool DatabaseQueries::deleteFeed(QSqlDatabase db, int feed_custom_id, int accoun
     return false;
   }
 
+  qApp->database()->knownMessages()->invalidateFeed(account_id, QString::number(feed_custom_id));
+
+  // Remove its failures.
+  q.prepare(QSL("DELETE FROM FeedFailures WHERE feed = :feed AND account_id = :account_id;"));
+  q.bindValue(QSL(":feed"), QString::number(feed_custom_id));
+  q.bindValue(QSL(":account_id"), account_id);
+
+  if (!q.exec()) {
+    return false;
+  }
+
+  qApp->feedReader()->failureTracker()->forgetFeed(account_id, QString::number(feed_custom_id));
+
+  // Remove its retention policy.
+  q.prepare(QSL("DELETE FROM RetentionPolicies WHERE feed = :feed AND account_id = :account_id;"));
+  q.bindValue(QSL(":feed"), QString::number(feed_custom_id));
+  q.bindValue(QSL(":account_id"), account_id);
+
+  if (!q.exec()) {
+    return false;
+  }
+
   // Remove feed itself.
   q.prepare(QSL("DELETE FROM Feeds WHERE custom_id = :feed AND account_id = :account_id;"));
   q.bindValue(QSL(":feed"), feed_custom_id);
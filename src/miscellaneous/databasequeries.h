@@ -26,6 +26,42 @@
 
 #include <QSqlQuery>
 
+// Retention policy of feed, whole account or global default one.
+struct RetentionPolicy {
+  int m_accountId = -1;
+
+  // Custom ID of feed, empty if policy applies to whole account.
+  QString m_feedCustomId;
+
+  // Maximal age in days and maximal count of messages, zero means unlimited.
+  int m_maxAge = 0;
+  int m_maxCount = 0;
+  bool m_keepStarred = true;
+
+  bool isActive() const {
+    return m_maxAge > 0 || m_maxCount > 0;
+  }
+
+};
+
+// Consecutive update failures of feed, its scheduled updates are postponed
+// until next attempt time. Times are milliseconds since epoch.
+struct FeedFailureState {
+  int m_accountId = -1;
+  QString m_feedCustomId;
+  int m_failures = 0;
+  qint64 m_lastFailure = 0;
+  qint64 m_nextAttempt = 0;
+};
+
+// Consecutive connection failures of host, its circuit
+// is open (feeds are skipped) until given time.
+struct HostCircuitState {
+  QString m_host;
+  int m_failures = 0;
+  qint64 m_openUntil = 0;
+};
+
 class DatabaseQueries {
   public:
 
@@ -48,6 +84,30 @@ class DatabaseQueries {
     static bool purgeMessagesFromBin(QSqlDatabase db, bool clear_only_read, int account_id);
     static bool purgeLeftoverMessages(QSqlDatabase db, int account_id);
 
+    // Marks messages as permanently deleted and drops their contents.
+    static bool purgeMessages(QSqlDatabase db, const QStringList& ids);
+
+    // Compression of stored contents of messages.
+    static int getMaxMessageId(QSqlDatabase db, bool* ok = nullptr);
+    static bool compressMessages(QSqlDatabase db, int from_id, int to_id, qint64* saved_bytes, int* compressed_count);
+
+    // Retention policies.
+    static QList<RetentionPolicy> getRetentionPolicies(QSqlDatabase db, bool* ok = nullptr);
+    static RetentionPolicy getRetentionPolicy(QSqlDatabase db, int account_id, const QString& feed_custom_id, bool* ok = nullptr);
+    static bool storeRetentionPolicy(QSqlDatabase db, const RetentionPolicy& policy);
+    static bool deleteRetentionPolicy(QSqlDatabase db, int account_id, const QString& feed_custom_id);
+    static QList<QPair<int, QString>> getFeedsOfAllAccounts(QSqlDatabase db, bool* ok = nullptr);
+
+    // Failures of feeds and hosts, stored lists replace all previously stored data.
+    static QList<FeedFailureState> getFeedFailures(QSqlDatabase db, bool* ok = nullptr);
+    static bool storeFeedFailures(QSqlDatabase db, const QList<FeedFailureState>& failures);
+    static QList<HostCircuitState> getHostCircuits(QSqlDatabase db, bool* ok = nullptr);
+    static bool storeHostCircuits(QSqlDatabase db, const QList<HostCircuitState>& circuits);
+
+    // Returns IDs of at most "limit" messages of given feed which exceed its retention policy.
+    static QStringList getExpiredMessageIds(QSqlDatabase db, const RetentionPolicy& policy, int account_id,
+                                            const QString& feed_custom_id, int limit, bool* ok = nullptr);
+
     // Obtain counts of unread/all messages.
     static QMap<QString, QPair<int, int>> getMessageCountsForCategory(QSqlDatabase db, const QString& custom_id, int account_id,
                                                                       bool including_total_counts, bool* ok = nullptr);
@@ -136,6 +196,11 @@ class DatabaseQueries {
     static Assignment getTtRssFeeds(QSqlDatabase db, int account_id, bool* ok = nullptr);
 
   private:
+
+    // Executes statement for given message IDs, IDs are substituted
+    // as comma-separated list into the only placeholder of the statement.
+    static bool execForMessageIds(QSqlDatabase db, const QString& statement, const QStringList& ids);
+
     explicit DatabaseQueries();
 };
 
@@ -19,7 +19,10 @@
 #include "miscellaneous/debugging.h"
 
 #include "miscellaneous/application.h"
+#include "miscellaneous/asynclogger.h"
 
+#include <QAtomicPointer>
+#include <QDateTime>
 #include <QDir>
 
 #include <chrono>
@@ -27,27 +30,56 @@
 #include <cstdlib>
 #include <ctime>
 
+Q_LOGGING_CATEGORY(LOG_DATABASE, "rssguard.database")
+Q_LOGGING_CATEGORY(LOG_FEEDS, "rssguard.feeds")
+Q_LOGGING_CATEGORY(LOG_PARSER, "rssguard.parser")
+Q_LOGGING_CATEGORY(LOG_TIMINGS, "rssguard.timings", QtWarningMsg)
+
+static QAtomicPointer<AsyncLogger> s_asyncLogger;
+
+// Logger lives until exit, so that messages logged after it is stopped are still
+// written. Pointer to it is cleared before it is destroyed.
+struct AsyncLoggerHolder {
+  explicit AsyncLoggerHolder(const QString& log_file_path) : m_logger(log_file_path) {}
+
+  ~AsyncLoggerHolder() {
+    s_asyncLogger.storeRelease(nullptr);
+  }
+
+  AsyncLogger m_logger;
+};
+
 Debugging::Debugging() {}
 
 void Debugging::performLog(const char* message, QtMsgType type, const char* file, const char* function, int line) {
-  const char* type_string = typeToString(type);
+  fputs(formatLog(message, type, nullptr, file, function, line, QDateTime::currentMSecsSinceEpoch()).constData(), stderr);
 
-  std::time_t t = std::time(nullptr);
+  if (type == QtFatalMsg) {
+    qApp->exit(EXIT_FAILURE);
+  }
+}
+
+QByteArray Debugging::formatLog(const char* message, QtMsgType type, const char* category, const char* file,
+                                const char* function, int line, qint64 timestamp) {
+  const char* type_string = typeToString(type);
+  const std::time_t t = std::time_t(timestamp / 1000);
   char mbstr[32];
 
   std::strftime(mbstr, sizeof(mbstr), "%y/%d/%m %H:%M:%S", std::localtime(&t));
 
-  // Write to console.
+  // Messages of custom categories are prefixed with name of the category.
+  QByteArray text = message;
+
+  if (category != nullptr && qstrcmp(category, "default") != 0) {
+    text.prepend(QByteArray(category) + ": ");
+  }
+
   if (file == 0 || function == 0 || line < 0) {
-    fprintf(stderr, "[%s] %s: %s (%s)\n", APP_LOW_NAME, type_string, message, mbstr);
+    return QByteArray("[") + APP_LOW_NAME + "] " + type_string + ": " + text + " (" + mbstr + ")\n";
   }
   else {
-    fprintf(stderr, "[%s] %s (%s)\n  Type: %s\n  File: %s (line %d)\n  Function: %s\n\n",
-            APP_LOW_NAME, message, mbstr, type_string, file, line, function);
-  }
-
-  if (type == QtFatalMsg) {
-    qApp->exit(EXIT_FAILURE);
+    return QByteArray("[") + APP_LOW_NAME + "] " + text + " (" + mbstr + ")\n  Type: " + type_string +
+           "\n  File: " + file + " (line " + QByteArray::number(line) + ")\n  Function: " + function + "\n\n";
   }
 }
 
@@ -56,6 +88,9 @@ const char* Debugging::typeToString(QtMsgType type) {
     case QtDebugMsg:
       return "DEBUG";
 
+    case QtInfoMsg:
+      return "INFO";
+
     case QtWarningMsg:
       return "WARNING";
 
@@ -70,10 +105,82 @@ const char* Debugging::typeToString(QtMsgType type) {
 
 void Debugging::debugHandler(QtMsgType type, const QMessageLogContext& placement, const QString& message) {
 #ifndef QT_NO_DEBUG_OUTPUT
-  performLog(qPrintable(message), type, placement.file, placement.function, placement.line);
+  AsyncLogger* logger = s_asyncLogger.loadAcquire();
+
+  if (logger != nullptr && type != QtFatalMsg) {
+    AsyncLogger::Entry entry;
+
+    entry.m_timestamp = QDateTime::currentMSecsSinceEpoch();
+    entry.m_type = type;
+    entry.m_category = placement.category;
+    entry.m_file = placement.file;
+    entry.m_function = placement.function;
+    entry.m_line = placement.line;
+    entry.m_message = message.toLocal8Bit();
+    logger->enqueue(entry);
+  }
+  else {
+    if (type == QtFatalMsg) {
+      // Write pending messages first, application is going down.
+      stopAsyncLogging();
+    }
+
+    performLog(qPrintable(message), type, placement.file, placement.function, placement.line);
+  }
 #else
   Q_UNUSED(type)
   Q_UNUSED(placement)
   Q_UNUSED(message)
 #endif
 }
+
+void Debugging::startAsyncLogging(const QString& log_file_path) {
+  if (s_asyncLogger.loadAcquire() == nullptr) {
+    static AsyncLoggerHolder holder(log_file_path);
+
+    holder.m_logger.start(QThread::LowPriority);
+    s_asyncLogger.storeRelease(&holder.m_logger);
+  }
+}
+
+void Debugging::stopAsyncLogging() {
+  AsyncLogger* logger = s_asyncLogger.loadAcquire();
+
+  if (logger != nullptr) {
+    // Logger stays installed, messages logged from now on are written synchronously by it.
+    logger->stop();
+  }
+}
+
+void Debugging::setLoggingRules(const QString& rules) {
+  if (!rules.isEmpty()) {
+    QString normalized_rules = rules;
+
+    QLoggingCategory::setFilterRules(normalized_rules.replace(QL1C(';'), QL1C('\n')));
+  }
+}
+
+ScopedTiming::ScopedTiming(const char* operation, int items) : m_operation(operation), m_items(items) {
+  if (isEnabled()) {
+    m_timer.start();
+  }
+}
+
+ScopedTiming::~ScopedTiming() {
+  if (m_timer.isValid()) {
+    qCInfo(LOG_TIMINGS, "{\"timing\":\"%s\",\"items\":%d,\"ms\":%.3f}",
+           m_operation, m_items, m_timer.nsecsElapsed() / 1000000.0);
+  }
+}
+
+void ScopedTiming::setItems(int items) {
+  m_items = items;
+}
+
+void ScopedTiming::report(const QByteArray& json) {
+  qCInfo(LOG_TIMINGS, "%s", json.constData());
+}
+
+bool ScopedTiming::isEnabled() {
+  return LOG_TIMINGS().isInfoEnabled();
+}
@@ -21,6 +21,23 @@
 
 #include <QtGlobal>
 
+#include <QElapsedTimer>
+#include <QLoggingCategory>
+
+// Logging categories of hot code paths, levels of these
+// can be changed at runtime with filter rules, for example "rssguard.database.debug=false".
+Q_DECLARE_LOGGING_CATEGORY(LOG_DATABASE)
+Q_DECLARE_LOGGING_CATEGORY(LOG_FEEDS)
+Q_DECLARE_LOGGING_CATEGORY(LOG_PARSER)
+Q_DECLARE_LOGGING_CATEGORY(LOG_TIMINGS)
+
+// Debug output of per-item hot paths, it is compiled out completely in release builds.
+#if defined(QT_NO_DEBUG)
+#define qCDebugHot(...) while (false) qCDebug(__VA_ARGS__)
+#else
+#define qCDebugHot(...) qCDebug(__VA_ARGS__)
+#endif
+
 class Debugging {
   public:
 
@@ -28,12 +45,43 @@ class Debugging {
     // NOTE: QT_NO_DEBUG_OUTPUT - disables debug outputs completely!!!
     static void debugHandler(QtMsgType type, const QMessageLogContext& placement, const QString& message);
     static void performLog(const char* message, QtMsgType type, const char* file = 0, const char* function = 0, int line = -1);
+    static QByteArray formatLog(const char* message, QtMsgType type, const char* category, const char* file,
+                                const char* function, int line, qint64 timestamp);
     static const char* typeToString(QtMsgType type);
 
+    // Moves writing of log messages to background thread. Messages
+    // are also appended to given file, if its path is not empty.
+    static void startAsyncLogging(const QString& log_file_path = QString());
+    static void stopAsyncLogging();
+
+    // Sets runtime levels of logging categories.
+    static void setLoggingRules(const QString& rules);
+
   private:
 
     // Constructor.
     explicit Debugging();
 };
 
+// Measures duration of hot operation and logs it as single JSON line. Timings
+// are info messages of LOG_TIMINGS category which is disabled by default,
+// it can be enabled with filter rule "rssguard.timings.info=true".
+class ScopedTiming {
+  public:
+    explicit ScopedTiming(const char* operation, int items = -1);
+    ~ScopedTiming();
+
+    void setItems(int items);
+
+    static bool isEnabled();
+
+    // Logs already formatted JSON object as single line.
+    static void report(const QByteArray& json);
+
+  private:
+    const char* m_operation;
+    int m_items;
+    QElapsedTimer m_timer;
+};
+
 #endif // DEBUGGING_H
@@ -25,8 +25,10 @@
 #endif
 
 #include "core/feeddownloader.h"
+#include "core/feedfailuretracker.h"
 #include "core/feedsmodel.h"
 #include "core/feedsproxymodel.h"
+#include "core/feedupdatestatistics.h"
 #include "core/messagesmodel.h"
 #include "core/messagesproxymodel.h"
 #include "miscellaneous/application.h"
@@ -45,7 +47,8 @@ FeedReader::FeedReader(QObject* parent)
   : QObject(parent), m_feedServices(QList<ServiceEntryPoint*>()),
   m_autoUpdateTimer(new QTimer(this)),
   m_feedDownloaderThread(nullptr), m_feedDownloader(nullptr),
-  m_dbCleanerThread(nullptr), m_dbCleaner(nullptr) {
+  m_dbCleanerThread(nullptr), m_dbCleaner(nullptr), m_updateStatistics(new FeedUpdateStatistics(this)),
+  m_failureTracker(new FeedFailureTracker()) {
   m_feedsModel = new FeedsModel(this);
   m_feedsProxyModel = new FeedsProxyModel(m_feedsModel, this);
   m_messagesModel = new MessagesModel(this);
@@ -55,6 +58,17 @@ FeedReader::FeedReader(QObject* parent)
   updateAutoUpdateStatus();
   asyncCacheSaveFinished();
 
+  // Retention policies are enforced in small chunks on the cleaner thread.
+  connect(databaseCleaner(), &DatabaseCleaner::retentionFinished, this, &FeedReader::retentionFinished);
+  QMetaObject::invokeMethod(m_dbCleaner, "startRetention");
+
+  // Compress messages stored before compression was enabled.
+  connect(databaseCleaner(), &DatabaseCleaner::compressionFinished, this, &FeedReader::compressionFinished);
+
+  if (qApp->settings()->value(GROUP(Database), SETTING(Database::CompressContents)).toBool()) {
+    QMetaObject::invokeMethod(m_dbCleaner, "startCompressionMigration");
+  }
+
   if (qApp->settings()->value(GROUP(Feeds), SETTING(Feeds::FeedsUpdateOnStartup)).toBool()) {
     qDebug("Requesting update for all feeds on application startup.");
     QTimer::singleShot(STARTUP_UPDATE_DELAY, this, SLOT(updateAllFeeds()));
@@ -64,6 +78,7 @@ FeedReader::FeedReader(QObject* parent)
 FeedReader::~FeedReader() {
   qDebug("Destroying FeedReader instance.");
   qDeleteAll(m_feedServices);
+  delete m_failureTracker;
 }
 
 QList<ServiceEntryPoint*> FeedReader::feedServices() {
@@ -80,12 +95,23 @@ QList<ServiceEntryPoint*> FeedReader::feedServices() {
   return m_feedServices;
 }
 
-void FeedReader::updateFeeds(const QList<Feed*>& feeds) {
+bool FeedReader::updateFeeds(const QList<Feed*>& feeds_to_update, FeedDownloader::Priority priority) {
+  // Feeds explicitly requested by the user are always updated.
+  const QList<Feed*> feeds = priority == FeedDownloader::Background ?
+                             withoutPostponedFeeds(feeds_to_update) :
+                             feeds_to_update;
+
+  // Running update holds the lock itself, so it can accept more work.
+  if (m_feedDownloader != nullptr && m_feedDownloader->appendToRunningUpdate(feeds, priority)) {
+    qDebug("Added %d feeds to running update.", feeds.size());
+    return true;
+  }
+
   if (!qApp->feedUpdateLock()->tryLock()) {
     qApp->showGuiMessage(tr("Cannot update all items"),
                          tr("You cannot update all items because another critical operation is ongoing."),
                          QSystemTrayIcon::Warning, qApp->mainFormWidget(), true);
-    return;
+    return false;
   }
 
   if (m_feedDownloader == nullptr) {
@@ -106,7 +132,26 @@ void FeedReader::updateFeeds(const QList<Feed*>& feeds) {
     m_feedDownloaderThread->start();
   }
 
-  QMetaObject::invokeMethod(m_feedDownloader, "updateFeeds", Q_ARG(QList<Feed*>, feeds));
+  QMetaObject::invokeMethod(m_feedDownloader, "updateFeeds", Q_ARG(QList<Feed*>, feeds),
+                            Q_ARG(FeedDownloader::Priority, priority));
+  return true;
+}
+
+QList<Feed*> FeedReader::withoutPostponedFeeds(const QList<Feed*>& feeds) const {
+  QList<Feed*> result;
+
+  // Failing feeds and feeds of unreachable hosts wait for their next attempt.
+  foreach (Feed* feed, feeds) {
+    if (!m_failureTracker->isPostponed(feed)) {
+      result.append(feed);
+    }
+  }
+
+  if (result.size() < feeds.size()) {
+    qDebug("Postponing update of %d failing feeds.", feeds.size() - result.size());
+  }
+
+  return result;
 }
 
 void FeedReader::updateAutoUpdateStatus() {
@@ -142,13 +187,30 @@ int FeedReader::autoUpdateInitialInterval() const {
   return m_globalAutoUpdateInitialInterval;
 }
 
-void FeedReader::updateAllFeeds() {
-  updateFeeds(m_feedsModel->rootItem()->getSubTreeFeeds());
+bool FeedReader::updateAllFeeds() {
+  return updateFeeds(m_feedsModel->rootItem()->getSubTreeFeeds());
 }
 
 void FeedReader::stopRunningFeedUpdate() {
   if (m_feedDownloader != nullptr) {
-    QMetaObject::invokeMethod(m_feedDownloader, "stopRunningUpdate");
+    // Stopping is thread-safe, so running network operations are aborted right now.
+    m_feedDownloader->stopRunningUpdate();
+  }
+}
+
+void FeedReader::stopRunningFeedUpdateAndWait() {
+  if (m_feedDownloader == nullptr) {
+    return;
+  }
+
+  QEventLoop loop(this);
+
+  // Connect before checking, so that finishing of the update cannot be missed.
+  connect(m_feedDownloader, &FeedDownloader::updateFinished, &loop, &QEventLoop::quit);
+  stopRunningFeedUpdate();
+
+  if (m_feedDownloader->isUpdateRunning()) {
+    loop.exec();
   }
 }
 
@@ -173,6 +235,28 @@ DatabaseCleaner* FeedReader::databaseCleaner() {
   return m_dbCleaner;
 }
 
+void FeedReader::retentionFinished(int removed_messages) {
+  qDebug("Retention policies removed %d messages, reloading counts.", removed_messages);
+  m_feedsModel->reloadCountsOfWholeModel();
+}
+
+void FeedReader::compressionFinished(int compressed_messages, qint64 saved_bytes) {
+  if (compressed_messages > 0) {
+    qApp->showGuiMessage(tr("Messages compressed"),
+                         tr("%n messages were compressed, %1 kB of storage was saved.", 0, compressed_messages)
+                         .arg(qMax(saved_bytes, qint64(0)) / 1024),
+                         QSystemTrayIcon::Information);
+  }
+}
+
+FeedUpdateStatistics* FeedReader::updateStatistics() const {
+  return m_updateStatistics;
+}
+
+FeedFailureTracker* FeedReader::failureTracker() const {
+  return m_failureTracker;
+}
+
 FeedDownloader* FeedReader::feedDownloader() const {
   return m_feedDownloader;
 }
@@ -204,8 +288,8 @@ void FeedReader::executeNextAutoUpdate() {
 
   // Pass needed interval data and lets the model decide which feeds
   // should be updated in this pass.
-  QList<Feed*> feeds_for_update = m_feedsModel->feedsForScheduledUpdate(m_globalAutoUpdateEnabled &&
-                                                                        m_globalAutoUpdateRemainingInterval == 0);
+  QList<Feed*> feeds_for_update = withoutPostponedFeeds(m_feedsModel->feedsForScheduledUpdate(m_globalAutoUpdateEnabled &&
+                                                                                              m_globalAutoUpdateRemainingInterval == 0));
   qApp->feedUpdateLock()->unlock();
 
   if (!feeds_for_update.isEmpty()) {
@@ -249,14 +333,7 @@ void FeedReader::quit() {
 
   // Close worker threads.
   if (m_feedDownloaderThread != nullptr && m_feedDownloaderThread->isRunning()) {
-    m_feedDownloader->stopRunningUpdate();
-
-    if (m_feedDownloader->isUpdateRunning()) {
-      QEventLoop loop(this);
-
-      connect(m_feedDownloader, &FeedDownloader::updateFinished, &loop, &QEventLoop::quit);
-      loop.exec();
-    }
+    stopRunningFeedUpdateAndWait();
 
     qDebug("Quitting feed downloader thread.");
     m_feedDownloaderThread->quit();
@@ -30,6 +30,8 @@ class FeedsModel;
 class MessagesModel;
 class MessagesProxyModel;
 class FeedsProxyModel;
+class FeedFailureTracker;
+class FeedUpdateStatistics;
 class ServiceEntryPoint;
 class DatabaseCleaner;
 class QTimer;
@@ -48,17 +50,25 @@ class FeedReader : public QObject {
     // Access to DB cleaner.
     DatabaseCleaner* databaseCleaner();
     FeedDownloader* feedDownloader() const;
+    FeedUpdateStatistics* updateStatistics() const;
+    FeedFailureTracker* failureTracker() const;
     FeedsModel* feedsModel() const;
     MessagesModel* messagesModel() const;
     FeedsProxyModel* feedsProxyModel() const;
     MessagesProxyModel* messagesProxyModel() const;
 
-    // Schedules given feeds for update.
-    void updateFeeds(const QList<Feed*>& feeds);
+    // Schedules given feeds for update. If update is already running,
+    // feeds are added to it, interactive ones jump ahead of the others.
+    // Background updates skip feeds which are backing off after failures.
+    // Returns false if update cannot start because another critical operation holds the lock.
+    bool updateFeeds(const QList<Feed*>& feeds, FeedDownloader::Priority priority = FeedDownloader::Background);
 
     // True if feed update is running right now.
     bool isFeedUpdateRunning() const;
 
+    // Stops running update and waits (processing events) until it finishes.
+    void stopRunningFeedUpdateAndWait();
+
     // Resets global auto-update intervals according to settings
     // and starts/stop the timer as needed.
     void updateAutoUpdateStatus();
@@ -70,7 +80,7 @@ class FeedReader : public QObject {
   public slots:
 
     // Schedules all feeds from all accounts for update.
-    void updateAllFeeds();
+    bool updateAllFeeds();
     void stopRunningFeedUpdate();
     void quit();
 
@@ -80,6 +90,8 @@ class FeedReader : public QObject {
     void executeNextAutoUpdate();
     void checkServicesForAsyncOperations();
     void asyncCacheSaveFinished();
+    void retentionFinished(int removed_messages);
+    void compressionFinished(int compressed_messages, qint64 saved_bytes);
 
   signals:
     void feedUpdatesStarted();
@@ -87,6 +99,10 @@ class FeedReader : public QObject {
     void feedUpdatesProgress(const Feed* feed, int current, int total);
 
   private:
+
+    // Returns given feeds except those which should not be updated by schedule now.
+    QList<Feed*> withoutPostponedFeeds(const QList<Feed*>& feeds) const;
+
     QList<ServiceEntryPoint*> m_feedServices;
 
     FeedsModel* m_feedsModel;
@@ -103,6 +119,8 @@ class FeedReader : public QObject {
     FeedDownloader* m_feedDownloader;
     QThread* m_dbCleanerThread;
     DatabaseCleaner* m_dbCleaner;
+    FeedUpdateStatistics* m_updateStatistics;
+    FeedFailureTracker* m_failureTracker;
 };
 
 #endif // FEEDREADER_H
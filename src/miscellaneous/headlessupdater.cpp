@@ -0,0 +1,137 @@
+// This file is part of RSS Guard.
+
+//
+// Copyright (C) 2011-2017 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#include "miscellaneous/headlessupdater.h"
+
+#include "core/feedsmodel.h"
+#include "core/feedupdatestatistics.h"
+#include "miscellaneous/application.h"
+#include "miscellaneous/feedreader.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTimer>
+
+#include <cstdio>
+#include <cstdlib>
+
+HeadlessUpdater::HeadlessUpdater(bool daemon, int interval_minutes, QObject* parent)
+  : QObject(parent), m_daemon(daemon), m_lockAttempts(0), m_intervalTimer(nullptr) {
+  if (m_daemon && interval_minutes > 0) {
+    m_intervalTimer = new QTimer(this);
+    m_intervalTimer->setInterval(interval_minutes * 60000);
+    connect(m_intervalTimer, &QTimer::timeout, this, &HeadlessUpdater::updateAllFeeds);
+  }
+}
+
+HeadlessUpdater::~HeadlessUpdater() {}
+
+void HeadlessUpdater::start() {
+  FeedReader* reader = qApp->feedReader();
+
+  connect(reader, &FeedReader::feedUpdatesFinished, this, &HeadlessUpdater::onUpdatesFinished);
+  reader->feedsModel()->loadActivatedServiceAccounts();
+
+  if (!m_daemon || m_intervalTimer != nullptr) {
+    // Update everything right now, then repeat with fixed interval, if any.
+    QTimer::singleShot(0, this, &HeadlessUpdater::updateAllFeeds);
+
+    if (m_intervalTimer != nullptr) {
+      m_intervalTimer->start();
+    }
+  }
+  else {
+    qDebug("Headless daemon relies on auto-update settings of feeds.");
+  }
+}
+
+void HeadlessUpdater::updateAllFeeds() {
+  if (qApp->feedReader()->isFeedUpdateRunning()) {
+    qWarning("Previous update round is still running, skipping this one.");
+    return;
+  }
+
+  m_roundStarted = QDateTime::currentDateTime();
+
+  if (qApp->feedReader()->updateAllFeeds()) {
+    m_lockAttempts = 0;
+  }
+  else if (++m_lockAttempts < HEADLESS_LOCK_ATTEMPTS) {
+    // Database maintenance holds the lock only for short chunks, try again soon.
+    qDebug("Feed update lock is held by another operation, retrying update in %d ms.", HEADLESS_LOCK_RETRY_INTERVAL);
+    QTimer::singleShot(HEADLESS_LOCK_RETRY_INTERVAL, this, &HeadlessUpdater::updateAllFeeds);
+  }
+  else {
+    QJsonObject error;
+
+    m_lockAttempts = 0;
+    error[QSL("event")] = QSL("update_failed");
+    error[QSL("finished")] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    error[QSL("error")] = QSL("Feed update lock is held by another operation.");
+
+    fprintf(stdout, "%s\n", QJsonDocument(error).toJson(QJsonDocument::Compact).constData());
+    fflush(stdout);
+
+    if (!m_daemon) {
+      qApp->exit(EXIT_FAILURE);
+    }
+  }
+}
+
+void HeadlessUpdater::onUpdatesFinished(const FeedDownloadResults& results) {
+  QJsonObject summary;
+  QJsonArray updated_feeds;
+  int new_messages = 0;
+  int processed_feeds = 0;
+  int failed_feeds = 0;
+
+  foreach (const auto& feed, results.updatedFeeds()) {
+    QJsonObject updated_feed;
+
+    updated_feed[QSL("title")] = feed.first;
+    updated_feed[QSL("new_messages")] = feed.second;
+    updated_feeds.append(updated_feed);
+    new_messages += feed.second;
+  }
+
+  // Scheduled rounds of daemon are not started by us, count everything since last round.
+  foreach (const FeedUpdateStatisticsEntry& entry, qApp->feedReader()->updateStatistics()->entries()) {
+    if (!m_roundStarted.isValid() || entry.m_last.m_finished >= m_roundStarted) {
+      processed_feeds++;
+      failed_feeds += entry.m_last.m_error ? 1 : 0;
+    }
+  }
+
+  summary[QSL("event")] = QSL("update_finished");
+  summary[QSL("finished")] = QDateTime::currentDateTime().toString(Qt::ISODate);
+  summary[QSL("processed_feeds")] = processed_feeds;
+  summary[QSL("failed_feeds")] = failed_feeds;
+  summary[QSL("unchanged_feeds")] = results.unchangedFeeds();
+  summary[QSL("new_messages")] = new_messages;
+  summary[QSL("updated_feeds")] = updated_feeds;
+
+  fprintf(stdout, "%s\n", QJsonDocument(summary).toJson(QJsonDocument::Compact).constData());
+  fflush(stdout);
+
+  m_roundStarted = QDateTime::currentDateTime();
+
+  if (!m_daemon) {
+    qApp->quit();
+  }
+}
@@ -0,0 +1,56 @@
+// This file is part of RSS Guard.
+
+//
+// Copyright (C) 2011-2017 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HEADLESSUPDATER_H
+#define HEADLESSUPDATER_H
+
+#include <QObject>
+
+#include "core/feeddownloader.h"
+
+#include <QDateTime>
+
+class QTimer;
+
+// Drives feed updates of headless instance, which has no widgets.
+// Summary of each update round is printed to standard output as single JSON line.
+class HeadlessUpdater : public QObject {
+  Q_OBJECT
+
+  public:
+
+    // Instance which is not daemon quits after first update round.
+    // Daemon with zero interval relies on auto-update settings of feeds.
+    explicit HeadlessUpdater(bool daemon, int interval_minutes, QObject* parent = nullptr);
+    virtual ~HeadlessUpdater();
+
+    // Loads service accounts and starts updating.
+    void start();
+
+  private slots:
+    void updateAllFeeds();
+    void onUpdatesFinished(const FeedDownloadResults& results);
+
+  private:
+    bool m_daemon;
+    int m_lockAttempts;
+    QTimer* m_intervalTimer;
+    QDateTime m_roundStarted;
+};
+
+#endif // HEADLESSUPDATER_H
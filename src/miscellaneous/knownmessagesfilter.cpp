@@ -0,0 +1,172 @@
+// This file is part of RSS Guard.
+
+//
+// Copyright (C) 2011-2017 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#include "miscellaneous/knownmessagesfilter.h"
+
+#include "definitions/definitions.h"
+
+#include <QCryptographicHash>
+#include <QMutexLocker>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QVariant>
+
+KnownMessagesFilter::KnownMessagesFilter() {}
+
+KnownMessagesFilter::~KnownMessagesFilter() {}
+
+bool KnownMessagesFilter::ensureLoaded(QSqlDatabase db, int account_id, const QString& feed_custom_id) {
+  const QString feed_key = feedKey(account_id, feed_custom_id);
+
+  {
+    QMutexLocker locker(&m_mutex);
+
+    if (m_feeds.contains(feed_key)) {
+      return true;
+    }
+  }
+
+  QSqlQuery q(db);
+  FeedIndex index;
+
+  q.setForwardOnly(true);
+  q.prepare(QSL("SELECT title, url, author, date_created FROM Messages WHERE feed = :feed AND account_id = :account_id;"));
+  q.bindValue(QSL(":feed"), feed_custom_id);
+  q.bindValue(QSL(":account_id"), account_id);
+
+  if (!q.exec()) {
+    qWarning("Failed to load known messages of feed '%s': '%s'.", qPrintable(feed_custom_id), qPrintable(q.lastError().text()));
+    return false;
+  }
+
+  while (q.next()) {
+    // NULL values never match in DB lookup, so such messages are not "known".
+    if (q.value(0).isNull() || q.value(1).isNull() || q.value(2).isNull()) {
+      continue;
+    }
+
+    const QByteArray message_key = messageKey(q.value(0).toString(), q.value(1).toString(), q.value(2).toString());
+
+    if (index.contains(message_key)) {
+      index[message_key].m_ambiguous = true;
+    }
+    else {
+      index[message_key].m_dateCreated = q.value(3).value<qint64>();
+    }
+  }
+
+  QMutexLocker locker(&m_mutex);
+
+  m_feeds.insert(feed_key, index);
+  return true;
+}
+
+bool KnownMessagesFilter::isStoredUnchanged(int account_id, const QString& feed_custom_id, const Message& message) const {
+  if (!message.m_customId.isEmpty() || message.m_title.isNull() || message.m_url.isNull() || message.m_author.isNull()) {
+    return false;
+  }
+
+  QMutexLocker locker(&m_mutex);
+  const auto feed = m_feeds.constFind(feedKey(account_id, feed_custom_id));
+
+  if (feed == m_feeds.constEnd()) {
+    return false;
+  }
+
+  const auto known = feed->constFind(messageKey(message.m_title, message.m_url, message.m_author));
+
+  if (known == feed->constEnd()) {
+    return false;
+  }
+  else if (!message.m_createdFromFeed) {
+    // Messages without their own date are never updated.
+    return true;
+  }
+  else if (known->m_ambiguous) {
+    return false;
+  }
+  else {
+    // Stored message is updated only if both its date and contents changed.
+    return known->m_dateCreated == message.m_created.toMSecsSinceEpoch() ||
+           (!known->m_contentsFingerprint.isEmpty() && known->m_contentsFingerprint == contentsFingerprint(message.m_contents));
+  }
+}
+
+void KnownMessagesFilter::remember(int account_id, const QString& feed_custom_id, const Message& message,
+                                   qint64 date_created, const QString& contents) {
+  if (!message.m_customId.isEmpty() || message.m_title.isNull() || message.m_url.isNull() || message.m_author.isNull()) {
+    return;
+  }
+
+  const QByteArray fingerprint = contentsFingerprint(contents);
+  QMutexLocker locker(&m_mutex);
+  const auto feed = m_feeds.find(feedKey(account_id, feed_custom_id));
+
+  // Index of feed is either complete or missing, never partial.
+  if (feed != m_feeds.end()) {
+    KnownMessage& known = (*feed)[messageKey(message.m_title, message.m_url, message.m_author)];
+
+    known.m_dateCreated = date_created;
+    known.m_contentsFingerprint = fingerprint;
+  }
+}
+
+void KnownMessagesFilter::invalidateFeed(int account_id, const QString& feed_custom_id) {
+  QMutexLocker locker(&m_mutex);
+
+  m_feeds.remove(feedKey(account_id, feed_custom_id));
+}
+
+void KnownMessagesFilter::invalidateAccount(int account_id) {
+  const QString prefix = feedKey(account_id, QString());
+  QMutexLocker locker(&m_mutex);
+
+  for (auto i = m_feeds.begin(); i != m_feeds.end();) {
+    if (i.key().startsWith(prefix)) {
+      i = m_feeds.erase(i);
+    }
+    else {
+      i++;
+    }
+  }
+}
+
+void KnownMessagesFilter::clear() {
+  QMutexLocker locker(&m_mutex);
+
+  m_feeds.clear();
+}
+
+QString KnownMessagesFilter::feedKey(int account_id, const QString& feed_custom_id) {
+  return QString::number(account_id) + QL1C(':') + feed_custom_id;
+}
+
+QByteArray KnownMessagesFilter::messageKey(const QString& title, const QString& url, const QString& author) {
+  QCryptographicHash hash(QCryptographicHash::Md5);
+
+  hash.addData(title.toUtf8());
+  hash.addData("\0", 1);
+  hash.addData(url.toUtf8());
+  hash.addData("\0", 1);
+  hash.addData(author.toUtf8());
+  return hash.result();
+}
+
+QByteArray KnownMessagesFilter::contentsFingerprint(const QString& contents) {
+  return QCryptographicHash::hash(contents.toUtf8(), QCryptographicHash::Md5);
+}
@@ -0,0 +1,82 @@
+// This file is part of RSS Guard.
+
+//
+// Copyright (C) 2011-2017 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef KNOWNMESSAGESFILTER_H
+#define KNOWNMESSAGESFILTER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QSqlDatabase>
+#include <QString>
+
+#include "core/message.h"
+
+// In-memory index of messages which are stored in DB, one per feed.
+//
+// Messages without custom ID are recognized by their title, URL and author,
+// see DatabaseQueries::updateMessages(). For each such message we remember its
+// creation date and (once known) fingerprint of its contents, which is everything
+// needed to decide that incoming message would not change stored one, so the
+// message does not have to be looked up in DB at all.
+//
+// Index of feed is loaded lazily with its first update and it is invalidated
+// whenever messages are physically removed from DB.
+// NOTE: This class is thread-safe.
+class KnownMessagesFilter {
+  public:
+    explicit KnownMessagesFilter();
+    virtual ~KnownMessagesFilter();
+
+    // Loads index of given feed from DB, if it is not loaded yet.
+    bool ensureLoaded(QSqlDatabase db, int account_id, const QString& feed_custom_id);
+
+    // Returns true if given message provably exists in DB and it
+    // would not be updated by DatabaseQueries::updateMessages().
+    bool isStoredUnchanged(int account_id, const QString& feed_custom_id, const Message& message) const;
+
+    // Records state of message as it is now stored in DB.
+    void remember(int account_id, const QString& feed_custom_id, const Message& message,
+                  qint64 date_created, const QString& contents);
+
+    void invalidateFeed(int account_id, const QString& feed_custom_id);
+    void invalidateAccount(int account_id);
+    void clear();
+
+  private:
+    struct KnownMessage {
+      qint64 m_dateCreated = 0;
+
+      // Empty if contents of stored message are not known yet.
+      QByteArray m_contentsFingerprint;
+
+      // More messages share the same key, they must be looked up in DB.
+      bool m_ambiguous = false;
+    };
+
+    typedef QHash<QByteArray, KnownMessage> FeedIndex;
+
+    static QString feedKey(int account_id, const QString& feed_custom_id);
+    static QByteArray messageKey(const QString& title, const QString& url, const QString& author);
+    static QByteArray contentsFingerprint(const QString& contents);
+
+    mutable QMutex m_mutex;
+    QHash<QString, FeedIndex> m_feeds;
+};
+
+#endif // KNOWNMESSAGESFILTER_H
@@ -71,6 +71,10 @@ DKEY Feeds::ShowOnlyUnreadFeeds = "show_only_unread_feeds";
 
 DVALUE(bool) Feeds::ShowOnlyUnreadFeedsDef = false;
 
+DKEY Feeds::ImportMetadataThreads = "import_metadata_threads";
+
+DVALUE(int) Feeds::ImportMetadataThreadsDef = FEED_IMPORT_MAX_THREADS;
+
 // Messages.
 DKEY Messages::ID = "messages";
 DKEY Messages::MessageHeadImageHeight = "message_head_image_height";
@@ -229,6 +233,14 @@ DKEY General::Language = "language";
 
 DVALUE(QString) General::LanguageDef = QLocale::system().name();
 
+DKEY General::LogToFile = "log_to_file";
+
+DVALUE(bool) General::LogToFileDef = false;
+
+DKEY General::LoggingRules = "logging_rules";
+
+DVALUE(QString) General::LoggingRulesDef = QString();
+
 // Downloads.
 DKEY Downloads::ID = "download_manager";
 DKEY Downloads::AlwaysPromptForFilename = "prompt_for_filename";
@@ -311,6 +323,30 @@ DKEY Database::ActiveDriver = "database_driver";
 
 DVALUE(char*) Database::ActiveDriverDef = APP_DB_SQLITE_DRIVER;
 
+DKEY Database::RetentionEnabled = "retention_enabled";
+
+DVALUE(bool) Database::RetentionEnabledDef = false;
+
+DKEY Database::RetentionMaxAge = "retention_max_age";
+
+DVALUE(int) Database::RetentionMaxAgeDef = 0;
+
+DKEY Database::RetentionMaxCount = "retention_max_count";
+
+DVALUE(int) Database::RetentionMaxCountDef = 0;
+
+DKEY Database::RetentionKeepStarred = "retention_keep_starred";
+
+DVALUE(bool) Database::RetentionKeepStarredDef = true;
+
+DKEY Database::CompressContents = "compress_contents";
+
+DVALUE(bool) Database::CompressContentsDef = false;
+
+DKEY Database::CompressedUpToId = "compressed_up_to_id";
+
+DVALUE(int) Database::CompressedUpToIdDef = 0;
+
 // Keyboard.
 DKEY Keyboard::ID = "keyboard";
 
@@ -90,6 +90,10 @@ namespace Feeds {
   KEY ShowOnlyUnreadFeeds;
 
   VALUE(bool) ShowOnlyUnreadFeedsDef;
+
+  KEY ImportMetadataThreads;
+
+  VALUE(int) ImportMetadataThreadsDef;
 }
 
 // Messages.
@@ -252,6 +256,14 @@ namespace General {
   KEY Language;
 
   VALUE(QString) LanguageDef;
+
+  KEY LogToFile;
+
+  VALUE(bool) LogToFileDef;
+
+  KEY LoggingRules;
+
+  VALUE(QString) LoggingRulesDef;
 }
 
 // Downloads.
@@ -340,6 +352,30 @@ namespace Database {
   KEY ActiveDriver;
 
   VALUE(char*) ActiveDriverDef;
+
+  KEY RetentionEnabled;
+
+  VALUE(bool) RetentionEnabledDef;
+
+  KEY RetentionMaxAge;
+
+  VALUE(int) RetentionMaxAgeDef;
+
+  KEY RetentionMaxCount;
+
+  VALUE(int) RetentionMaxCountDef;
+
+  KEY RetentionKeepStarred;
+
+  VALUE(bool) RetentionKeepStarredDef;
+
+  KEY CompressContents;
+
+  VALUE(bool) CompressContentsDef;
+
+  KEY CompressedUpToId;
+
+  VALUE(int) CompressedUpToIdDef;
 }
 
 // Keyboard.
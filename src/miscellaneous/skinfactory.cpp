@@ -25,6 +25,66 @@
 #include <QDomElement>
 #include <QStyleFactory>
 
+SkinTemplate::SkinTemplate(const QString& markup, int placeholder_count) : m_literalLength(0) {
+  QString literal;
+  int i = 0;
+
+  while (i < markup.size()) {
+    const QChar chr = markup.at(i);
+
+    if (chr == QL1C('%') && i + 1 < markup.size() && markup.at(i + 1).isDigit()) {
+      // Placeholder number has at most two digits.
+      int number = markup.at(i + 1).digitValue();
+      int length = 2;
+
+      if (i + 2 < markup.size() && markup.at(i + 2).isDigit()) {
+        number = number * 10 + markup.at(i + 2).digitValue();
+        length = 3;
+      }
+
+      if (number >= 1 && number <= placeholder_count) {
+        m_literals.append(literal);
+        m_placeholders.append(number - 1);
+        m_literalLength += literal.size();
+        literal.clear();
+        i += length;
+        continue;
+      }
+    }
+
+    literal.append(chr);
+    i++;
+  }
+
+  m_literals.append(literal);
+  m_literalLength += literal.size();
+}
+
+void SkinTemplate::render(QString& output, const QStringList& values) const {
+  for (int i = 0; i < m_placeholders.size(); i++) {
+    output.append(m_literals.at(i));
+
+    if (m_placeholders.at(i) < values.size()) {
+      output.append(values.at(m_placeholders.at(i)));
+    }
+  }
+
+  output.append(m_literals.last());
+}
+
+QString SkinTemplate::render(const QStringList& values) const {
+  QString output;
+  int values_length = 0;
+
+  foreach (const QString& value, values) {
+    values_length += value.size();
+  }
+
+  output.reserve(m_literalLength + values_length);
+  render(output, values);
+  return output;
+}
+
 SkinFactory::SkinFactory(QObject* parent) : QObject(parent) {}
 
 SkinFactory::~SkinFactory() {}
@@ -43,6 +103,7 @@ void SkinFactory::loadCurrentSkin() {
 
     if (skin_parsed) {
       loadSkinFromData(skin_data);
+      compileSkinTemplates(skin_data);
 
       // Set this 'Skin' object as active one.
       m_currentSkin = skin_data;
@@ -65,6 +126,13 @@ void SkinFactory::loadSkinFromData(const Skin& skin) {
   qApp->setStyle(qApp->settings()->value(GROUP(GUI), SETTING(GUI::Style)).toString());
 }
 
+void SkinFactory::compileSkinTemplates(Skin& skin) const {
+  skin.m_layoutMarkupWrapperTemplate = SkinTemplate(skin.m_layoutMarkupWrapper, 2);
+  skin.m_enclosureImageMarkupTemplate = SkinTemplate(skin.m_enclosureImageMarkup, 3);
+  skin.m_layoutMarkupTemplate = SkinTemplate(skin.m_layoutMarkup, 10);
+  skin.m_enclosureMarkupTemplate = SkinTemplate(skin.m_enclosureMarkup, 3);
+}
+
 void SkinFactory::setCurrentSkinName(const QString& skin_name) {
   qApp->settings()->setValue(GROUP(GUI), GUI::Skin, skin_name);
 }
@@ -83,7 +151,7 @@ QString SkinFactory::adBlockedPage(const QString& subscription, const QString& r
                                                            .arg(subscription,
                                                                 rule));
 
-  return currentSkin().m_layoutMarkupWrapper.arg(tr("This page was blocked by AdBlock"), adblocked);
+  return currentSkin().m_layoutMarkupWrapperTemplate.render(QStringList() << tr("This page was blocked by AdBlock") << adblocked);
 }
 
 Skin SkinFactory::skinInfo(const QString& skin_name, bool* ok) const {
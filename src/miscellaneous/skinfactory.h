@@ -24,6 +24,29 @@
 #include <QMetaType>
 #include <QStringList>
 
+// Skin markup compiled into literal segments and "%N" placeholders,
+// so that it can be rendered in single pass. Placeholders are parsed
+// in the same way as QString::arg() does it, values substituted into
+// placeholders are never searched for other placeholders.
+class SkinTemplate {
+  public:
+    explicit SkinTemplate(const QString& markup = QString(), int placeholder_count = 0);
+
+    // Appends markup with placeholders replaced by given values.
+    void render(QString& output, const QStringList& values) const;
+    QString render(const QStringList& values) const;
+
+    // Total length of literal parts of the markup.
+    inline int literalLength() const {
+      return m_literalLength;
+    }
+
+  private:
+    QStringList m_literals;
+    QList<int> m_placeholders;
+    int m_literalLength;
+};
+
 struct Skin {
   QString m_baseName;
   QString m_visibleName;
@@ -36,6 +59,12 @@ struct Skin {
   QString m_enclosureImageMarkup;
   QString m_layoutMarkup;
   QString m_enclosureMarkup;
+
+  // Compiled markups, these are filled for active skin only.
+  SkinTemplate m_layoutMarkupWrapperTemplate;
+  SkinTemplate m_enclosureImageMarkupTemplate;
+  SkinTemplate m_layoutMarkupTemplate;
+  SkinTemplate m_enclosureMarkupTemplate;
 };
 
 Q_DECLARE_METATYPE(Skin)
@@ -80,6 +109,9 @@ class SkinFactory : public QObject {
     // Loads the skin from give skin_data.
     void loadSkinFromData(const Skin& skin);
 
+    // Compiles markups of the skin into templates.
+    void compileSkinTemplates(Skin& skin) const;
+
     // Holds name of the current skin.
     Skin m_currentSkin;
 };
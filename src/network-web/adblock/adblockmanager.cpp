@@ -99,7 +99,7 @@ bool AdBlockManager::block(QWebEngineUrlRequestInfo& request) {
   }
 
   bool res = false;
-  const AdBlockRule* blockedRule = m_matcher->match(request, urlDomain, urlString);
+  const AdBlockRule* blockedRule = m_matcher->match(AdBlockRequest(request), urlDomain, urlString);
 
   if (blockedRule) {
     if (request.resourceType() == QWebEngineUrlRequestInfo::ResourceTypeMainFrame) {
@@ -203,6 +203,7 @@ bool AdBlockManager::removeSubscription(AdBlockSubscription* subscription) {
   }
 
   QFile(subscription->filePath()).remove();
+  QFile(subscription->filePath() + QL1S(ADBLOCK_COMPILED_SUFFIX)).remove();
   m_subscriptions.removeOne(subscription);
   m_matcher->update();
   delete subscription;
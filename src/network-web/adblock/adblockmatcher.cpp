@@ -24,6 +24,10 @@
 
 #include "definitions/definitions.h"
 
+#include <QStringList>
+
+#include <algorithm>
+
 AdBlockMatcher::AdBlockMatcher(AdBlockManager* manager)
   : QObject(manager), m_manager(manager) {}
 
@@ -31,10 +35,11 @@ AdBlockMatcher::~AdBlockMatcher() {
   clear();
 }
 
-const AdBlockRule* AdBlockMatcher::match(const QWebEngineUrlRequestInfo& request, const QString& urlDomain,
+const AdBlockRule* AdBlockMatcher::match(const AdBlockRequest& request, const QString& urlDomain,
                                          const QString& urlString) const {
   // Exception rules.
-  if (m_networkExceptionTree.find(request, urlDomain, urlString)) {
+  if (m_networkExceptionTree.find(request, urlDomain, urlString) ||
+      m_networkExceptionIndex.find(request, urlDomain, urlString)) {
     return 0;
   }
 
@@ -53,6 +58,10 @@ const AdBlockRule* AdBlockMatcher::match(const QWebEngineUrlRequestInfo& request
     return rule;
   }
 
+  if (const AdBlockRule* rule = m_networkBlockIndex.find(request, urlDomain, urlString)) {
+    return rule;
+  }
+
   count = m_networkBlockRules.count();
 
   for (int i = 0; i < count; ++i) {
@@ -99,42 +108,76 @@ QString AdBlockMatcher::elementHidingRules() const {
 }
 
 QString AdBlockMatcher::elementHidingRulesForDomain(const QString& domain) const {
-  QString rules;
-  int addedRulesCount = 0;
-  int count = m_domainRestrictedCssRules.count();
+  const auto cached = m_domainCssCache.constFind(domain);
 
-  for (int i = 0; i < count; ++i) {
-    const AdBlockRule* rule = m_domainRestrictedCssRules.at(i);
+  if (cached != m_domainCssCache.constEnd()) {
+    return cached.value();
+  }
 
-    if (!rule->matchDomain(domain)) {
-      continue;
-    }
+  QVector<const AdBlockRule*> candidates = m_domainExcludingCssRules;
+  QString suffix = domain;
 
-    if (Q_UNLIKELY(addedRulesCount == 1000)) {
-      rules.append(rule->cssSelector());
-      rules.append(QSL("{display:none !important;}\n"));
-      addedRulesCount = 0;
+  // Rule allowed for some domain applies to that domain and all its subdomains,
+  // hence only buckets of the host and its parent domains are relevant.
+  while (!suffix.isEmpty()) {
+    const auto bucket = m_domainCssRules.constFind(suffix);
+
+    if (bucket != m_domainCssRules.constEnd()) {
+      candidates += bucket.value();
     }
-    else {
-      rules.append(rule->cssSelector() + QLatin1Char(','));
-      addedRulesCount++;
+
+    const int dot = suffix.indexOf(QL1C('.'));
+
+    suffix = dot < 0 ? QString() : suffix.mid(dot + 1);
+  }
+
+  std::sort(candidates.begin(), candidates.end());
+  candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+  QStringList selectors;
+
+  foreach (const AdBlockRule* rule, candidates) {
+    if (rule->matchDomain(domain)) {
+      selectors.append(rule->cssSelector());
     }
   }
 
-  if (addedRulesCount != 0) {
-    rules = rules.left(rules.size() - 1);
-    rules.append(QSL("{display:none !important;}\n"));
+  QString rules;
+
+  for (int i = 0; i < selectors.size(); i += ADBLOCK_CSS_SELECTORS_PER_RULE) {
+    rules += QStringList(selectors.mid(i, ADBLOCK_CSS_SELECTORS_PER_RULE)).join(QL1C(',')) +
+             QSL("{display:none !important;}\n");
+  }
+
+  if (m_domainCssCache.size() >= ADBLOCK_CSS_CACHE_SIZE) {
+    m_domainCssCache.clear();
   }
 
+  m_domainCssCache.insert(domain, rules);
   return rules;
 }
 
+void AdBlockMatcher::indexDomainRestrictedCssRule(const AdBlockRule* rule) {
+  if (rule->m_allowedDomains.isEmpty()) {
+    m_domainExcludingCssRules.append(rule);
+  }
+  else {
+    foreach (const QString& allowed_domain, rule->m_allowedDomains) {
+      m_domainCssRules[allowed_domain].append(rule);
+    }
+  }
+}
+
 void AdBlockMatcher::update() {
+  update(m_manager->subscriptions());
+}
+
+void AdBlockMatcher::update(const QList<AdBlockSubscription*>& subscriptions) {
   clear();
   QHash<QString, const AdBlockRule*> cssRulesHash;
   QVector<const AdBlockRule*> exceptionCssRules;
 
-  foreach (AdBlockSubscription* subscription, m_manager->subscriptions()) {
+  foreach (AdBlockSubscription* subscription, subscriptions) {
     foreach (const AdBlockRule* rule, subscription->allRules()) {
       // Don't add internally disabled rules to cache.
       if (rule->isInternalDisabled()) {
@@ -162,12 +205,12 @@ void AdBlockMatcher::update() {
         m_elemhideRules.append(rule);
       }
       else if (rule->isException()) {
-        if (!m_networkExceptionTree.add(rule)) {
+        if (!m_networkExceptionTree.add(rule) && !m_networkExceptionIndex.add(rule)) {
           m_networkExceptionRules.append(rule);
         }
       }
       else {
-        if (!m_networkBlockTree.add(rule)) {
+        if (!m_networkBlockTree.add(rule) && !m_networkBlockIndex.add(rule)) {
           m_networkBlockRules.append(rule);
         }
       }
@@ -202,7 +245,7 @@ void AdBlockMatcher::update() {
     const AdBlockRule* rule = it.value();
 
     if (rule->isDomainRestricted()) {
-      m_domainRestrictedCssRules.append(rule);
+      indexDomainRestrictedCssRule(rule);
     }
     else if (Q_UNLIKELY(hidingRulesCount == 1000)) {
       m_elementHidingRules.append(rule->cssSelector());
@@ -225,8 +268,12 @@ void AdBlockMatcher::clear() {
   m_networkExceptionTree.clear();
   m_networkExceptionRules.clear();
   m_networkBlockTree.clear();
+  m_networkBlockIndex.clear();
+  m_networkExceptionIndex.clear();
   m_networkBlockRules.clear();
-  m_domainRestrictedCssRules.clear();
+  m_domainCssRules.clear();
+  m_domainExcludingCssRules.clear();
+  m_domainCssCache.clear();
   m_elementHidingRules.clear();
   m_documentRules.clear();
   m_elemhideRules.clear();
@@ -23,12 +23,15 @@
 #include <QUrl>
 
 #include "network-web/adblock/adblocksearchtree.h"
+#include "network-web/adblock/adblocktokenindex.h"
 
+#include <QHash>
 #include <QObject>
 #include <QVector>
 
-class QWebEngineUrlRequestInfo;
+struct AdBlockRequest;
 class AdBlockManager;
+class AdBlockSubscription;
 
 class AdBlockMatcher : public QObject {
   Q_OBJECT
@@ -37,7 +40,7 @@ class AdBlockMatcher : public QObject {
     explicit AdBlockMatcher(AdBlockManager* manager);
     virtual ~AdBlockMatcher();
 
-    const AdBlockRule* match(const QWebEngineUrlRequestInfo& request, const QString& urlDomain, const QString& urlString) const;
+    const AdBlockRule* match(const AdBlockRequest& request, const QString& urlDomain, const QString& urlString) const;
 
     bool adBlockDisabledForUrl(const QUrl& url) const;
     bool elemHideDisabledForUrl(const QUrl& url) const;
@@ -45,23 +48,35 @@ class AdBlockMatcher : public QObject {
     QString elementHidingRules() const;
     QString elementHidingRulesForDomain(const QString& domain) const;
 
+    // Rebuilds matcher from rules of given subscriptions.
+    void update(const QList<AdBlockSubscription*>& subscriptions);
+
   public slots:
     void update();
     void clear();
 
   private:
+    void indexDomainRestrictedCssRule(const AdBlockRule* rule);
+
     AdBlockManager* m_manager;
 
     QVector<AdBlockRule*> m_createdRules;
     QVector<const AdBlockRule*> m_networkExceptionRules;
     QVector<const AdBlockRule*> m_networkBlockRules;
-    QVector<const AdBlockRule*> m_domainRestrictedCssRules;
     QVector<const AdBlockRule*> m_documentRules;
     QVector<const AdBlockRule*> m_elemhideRules;
 
+    // Domain-restricted CSS rules keyed by their allowed domains. Rules
+    // which only exclude some domains apply everywhere else, so they are kept apart.
+    QHash<QString, QVector<const AdBlockRule*>> m_domainCssRules;
+    QVector<const AdBlockRule*> m_domainExcludingCssRules;
+    mutable QHash<QString, QString> m_domainCssCache;
+
     QString m_elementHidingRules;
     AdBlockSearchTree m_networkBlockTree;
     AdBlockSearchTree m_networkExceptionTree;
+    AdBlockTokenIndex m_networkBlockIndex;
+    AdBlockTokenIndex m_networkExceptionIndex;
 };
 
 #endif // ADBLOCKMATCHER_H
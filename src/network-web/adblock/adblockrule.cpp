@@ -52,12 +52,20 @@
 #include "miscellaneous/simpleregexp.h"
 #include "network-web/adblock/adblocksubscription.h"
 
+#include <QDataStream>
 #include <QString>
 #include <QStringList>
 #include <QUrl>
 #include <QWebEnginePage>
 #include <QWebEngineUrlRequestInfo>
 
+AdBlockRequest::AdBlockRequest(const QWebEngineUrlRequestInfo& info)
+  : m_requestUrl(info.requestUrl()), m_firstPartyUrl(info.firstPartyUrl()), m_resourceType(info.resourceType()) {}
+
+AdBlockRequest::AdBlockRequest(const QUrl& request_url, const QUrl& first_party_url,
+                               QWebEngineUrlRequestInfo::ResourceType resource_type)
+  : m_requestUrl(request_url), m_firstPartyUrl(first_party_url), m_resourceType(resource_type) {}
+
 static QString toSecondLevelDomain(const QUrl& url) {
   const QString topLevelDomain = url.topLevelDomain();
   const QString urlHost = url.host();
@@ -104,6 +112,7 @@ AdBlockRule* AdBlockRule::copy() const {
   rule->m_isInternalDisabled = m_isInternalDisabled;
   rule->m_allowedDomains = m_allowedDomains;
   rule->m_blockedDomains = m_blockedDomains;
+  rule->m_tokens = m_tokens;
 
   if (m_regExp) {
     rule->m_regExp = new RegExp;
@@ -187,7 +196,7 @@ bool AdBlockRule::urlMatch(const QUrl& url) const {
   }
 }
 
-bool AdBlockRule::networkMatch(const QWebEngineUrlRequestInfo& request, const QString& domain, const QString& encodedUrl) const {
+bool AdBlockRule::networkMatch(const AdBlockRequest& request, const QString& domain, const QString& encodedUrl) const {
   if (m_type == CssRule || !m_isEnabled || m_isInternalDisabled) {
     return false;
   }
@@ -196,7 +205,7 @@ bool AdBlockRule::networkMatch(const QWebEngineUrlRequestInfo& request, const QS
 
   if (matched) {
     // Check domain restrictions.
-    if (hasOption(DomainRestrictedOption) && !matchDomain(request.firstPartyUrl().host())) {
+    if (hasOption(DomainRestrictedOption) && !matchDomain(request.m_firstPartyUrl.host())) {
       return false;
     }
 
@@ -286,60 +295,115 @@ bool AdBlockRule::matchDomain(const QString& domain) const {
   return false;
 }
 
-bool AdBlockRule::matchThirdParty(const QWebEngineUrlRequestInfo& request) const {
+bool AdBlockRule::matchThirdParty(const AdBlockRequest& request) const {
   // Third-party matching should be performed on second-level domains.
-  const QString firstPartyHost = toSecondLevelDomain(request.firstPartyUrl());
-  const QString host = toSecondLevelDomain(request.requestUrl());
+  const QString firstPartyHost = toSecondLevelDomain(request.m_firstPartyUrl);
+  const QString host = toSecondLevelDomain(request.m_requestUrl);
   bool match = firstPartyHost != host;
 
   return hasException(ThirdPartyOption) ? !match : match;
 }
 
-bool AdBlockRule::matchObject(const QWebEngineUrlRequestInfo& request) const {
-  bool match = request.resourceType() == QWebEngineUrlRequestInfo::ResourceTypeObject;
+bool AdBlockRule::matchObject(const AdBlockRequest& request) const {
+  bool match = request.m_resourceType == QWebEngineUrlRequestInfo::ResourceTypeObject;
 
   return hasException(ObjectOption) ? !match : match;
 }
 
-bool AdBlockRule::matchSubdocument(const QWebEngineUrlRequestInfo& request) const {
-  bool match = request.resourceType() == QWebEngineUrlRequestInfo::ResourceTypeSubFrame;
+bool AdBlockRule::matchSubdocument(const AdBlockRequest& request) const {
+  bool match = request.m_resourceType == QWebEngineUrlRequestInfo::ResourceTypeSubFrame;
 
   return hasException(SubdocumentOption) ? !match : match;
 }
 
-bool AdBlockRule::matchXmlHttpRequest(const QWebEngineUrlRequestInfo& request) const {
-  bool match = request.resourceType() == QWebEngineUrlRequestInfo::ResourceTypeXhr;
+bool AdBlockRule::matchXmlHttpRequest(const AdBlockRequest& request) const {
+  bool match = request.m_resourceType == QWebEngineUrlRequestInfo::ResourceTypeXhr;
 
   return hasException(XMLHttpRequestOption) ? !match : match;
 }
 
-bool AdBlockRule::matchImage(const QWebEngineUrlRequestInfo& request) const {
-  bool match = request.resourceType() == QWebEngineUrlRequestInfo::ResourceTypeImage;
+bool AdBlockRule::matchImage(const AdBlockRequest& request) const {
+  bool match = request.m_resourceType == QWebEngineUrlRequestInfo::ResourceTypeImage;
 
   return hasException(ImageOption) ? !match : match;
 }
 
-bool AdBlockRule::matchScript(const QWebEngineUrlRequestInfo& request) const {
-  bool match = request.resourceType() == QWebEngineUrlRequestInfo::ResourceTypeScript;
+bool AdBlockRule::matchScript(const AdBlockRequest& request) const {
+  bool match = request.m_resourceType == QWebEngineUrlRequestInfo::ResourceTypeScript;
 
   return hasException(ScriptOption) ? !match : match;
 }
 
-bool AdBlockRule::matchStyleSheet(const QWebEngineUrlRequestInfo& request) const {
-  bool match = request.resourceType() == QWebEngineUrlRequestInfo::ResourceTypeStylesheet;
+bool AdBlockRule::matchStyleSheet(const AdBlockRequest& request) const {
+  bool match = request.m_resourceType == QWebEngineUrlRequestInfo::ResourceTypeStylesheet;
 
   return hasException(StyleSheetOption) ? !match : match;
 }
 
-bool AdBlockRule::matchObjectSubrequest(const QWebEngineUrlRequestInfo& request) const {
-  bool match = request.resourceType() == QWebEngineUrlRequestInfo::ResourceTypeSubResource;
+bool AdBlockRule::matchObjectSubrequest(const AdBlockRequest& request) const {
+  bool match = request.m_resourceType == QWebEngineUrlRequestInfo::ResourceTypeSubResource;
 
   return hasException(ObjectSubrequestOption) ? !match : match;
 }
 
+void AdBlockRule::saveToStream(QDataStream& out) const {
+  out << m_filter << m_matchString << qint32(m_type) << qint32(m_options) << qint32(m_exceptions)
+      << qint32(m_caseSensitivity) << m_isEnabled << m_isException << m_isInternalDisabled
+      << m_allowedDomains << m_blockedDomains << m_tokens << (m_regExp != 0);
+
+  if (m_regExp) {
+    QStringList matchers;
+
+    foreach (const QStringMatcher& matcher, m_regExp->matchers) {
+      matchers.append(matcher.pattern());
+    }
+
+    out << m_regExp->regExp.pattern() << matchers;
+  }
+}
+
+bool AdBlockRule::loadFromStream(QDataStream& in) {
+  qint32 type, options, exceptions, case_sensitivity;
+  bool has_regexp;
+
+  in >> m_filter >> m_matchString >> type >> options >> exceptions >> case_sensitivity >> m_isEnabled
+     >> m_isException >> m_isInternalDisabled >> m_allowedDomains >> m_blockedDomains >> m_tokens >> has_regexp;
+
+  if (in.status() != QDataStream::Ok || type < CssRule || type > Invalid) {
+    return false;
+  }
+
+  m_type = RuleType(type);
+  m_options = RuleOptions(options);
+  m_exceptions = RuleOptions(exceptions);
+  m_caseSensitivity = Qt::CaseSensitivity(case_sensitivity);
+
+  delete m_regExp;
+  m_regExp = 0;
+
+  if (has_regexp) {
+    QString pattern;
+    QStringList matchers;
+
+    in >> pattern >> matchers;
+
+    if (in.status() != QDataStream::Ok) {
+      return false;
+    }
+
+    m_regExp = new RegExp;
+    m_regExp->regExp = SimpleRegExp(pattern, m_caseSensitivity);
+    m_regExp->matchers = createStringMatchers(matchers);
+  }
+
+  return true;
+}
+
 void AdBlockRule::parseFilter() {
   QString parsedLine = m_filter;
 
+  m_tokens.clear();
+
   // Empty rule or just comment.
   if (m_filter.trimmed().isEmpty() || m_filter.startsWith(QL1C('!'))) {
     // We want to differentiate rule disabled by user and rule disabled in subscription file
@@ -475,6 +539,8 @@ void AdBlockRule::parseFilter() {
     parsedLine = parsedLine.left(parsedLine.size() - 1);
   }
 
+  m_tokens = parseTokens(parsedLine);
+
   // We can use fast string matching for domain here.
   if (filterIsOnlyDomain(parsedLine)) {
     parsedLine = parsedLine.mid(2);
@@ -722,6 +788,48 @@ QStringList AdBlockRule::parseRegExpFilter(const QString& filter) const {
   return list;
 }
 
+static bool tokenCharacter(const QChar& c) {
+  const ushort u = c.unicode();
+
+  return (u >= 'a' && u <= 'z') || (u >= 'A' && u <= 'Z') || (u >= '0' && u <= '9') || u == '%' || u > 127;
+}
+
+// Extract tokens usable for indexing of the rule.
+// Token is a run of alphanumeric characters which is delimited
+// on both sides by character which cannot be part of the same run in matched URL,
+// thus it is guaranteed to appear as standalone token in each URL matched by this rule.
+// Runs touching wildcard or implicitly wildcarded edges of filter are not usable.
+QStringList AdBlockRule::parseTokens(const QString& filter) const {
+  QStringList tokens;
+  const int len = filter.size();
+  int i = 0;
+
+  while (i < len) {
+    if (!tokenCharacter(filter.at(i))) {
+      ++i;
+      continue;
+    }
+
+    const int start = i;
+    bool ascii = true;
+
+    while (i < len && tokenCharacter(filter.at(i))) {
+      ascii = ascii && filter.at(i).unicode() <= 127;
+      ++i;
+    }
+
+    if (!ascii || i - start < ADBLOCK_MIN_TOKEN_LENGTH || start == 0 || i == len ||
+        filter.at(start - 1) == QL1C('*') || filter.at(i) == QL1C('*')) {
+      continue;
+    }
+
+    tokens.append(filter.mid(start, i - start).toLower());
+  }
+
+  tokens.removeDuplicates();
+  return tokens;
+}
+
 bool AdBlockRule::hasOption(const AdBlockRule::RuleOption& opt) const {
   return (m_options & opt);
 }
@@ -51,13 +51,26 @@
 #include <QObject>
 #include <QStringList>
 #include <QStringMatcher>
+#include <QUrl>
+#include <QWebEngineUrlRequestInfo>
 
 #include "miscellaneous/simpleregexp.h"
 
-class QUrl;
-class QWebEngineUrlRequestInfo;
+class QDataStream;
 class AdBlockSubscription;
 
+// Properties of network request which are needed to match it against rules,
+// so that rules can be matched without live request from WebEngine.
+struct AdBlockRequest {
+  explicit AdBlockRequest(const QWebEngineUrlRequestInfo& info);
+  explicit AdBlockRequest(const QUrl& request_url, const QUrl& first_party_url,
+                          QWebEngineUrlRequestInfo::ResourceType resource_type);
+
+  QUrl m_requestUrl;
+  QUrl m_firstPartyUrl;
+  QWebEngineUrlRequestInfo::ResourceType m_resourceType;
+};
+
 class AdBlockRule {
   Q_DISABLE_COPY(AdBlockRule)
 
@@ -90,17 +103,21 @@ class AdBlockRule {
     bool isInternalDisabled() const;
 
     bool urlMatch(const QUrl& url) const;
-    bool networkMatch(const QWebEngineUrlRequestInfo& request, const QString& domain, const QString& encodedUrl) const;
+    bool networkMatch(const AdBlockRequest& request, const QString& domain, const QString& encodedUrl) const;
 
     bool matchDomain(const QString& domain) const;
-    bool matchThirdParty(const QWebEngineUrlRequestInfo& request) const;
-    bool matchObject(const QWebEngineUrlRequestInfo& request) const;
-    bool matchSubdocument(const QWebEngineUrlRequestInfo& request) const;
-    bool matchXmlHttpRequest(const QWebEngineUrlRequestInfo& request) const;
-    bool matchImage(const QWebEngineUrlRequestInfo& request) const;
-    bool matchScript(const QWebEngineUrlRequestInfo& request) const;
-    bool matchStyleSheet(const QWebEngineUrlRequestInfo& request) const;
-    bool matchObjectSubrequest(const QWebEngineUrlRequestInfo& request) const;
+    bool matchThirdParty(const AdBlockRequest& request) const;
+    bool matchObject(const AdBlockRequest& request) const;
+    bool matchSubdocument(const AdBlockRequest& request) const;
+    bool matchXmlHttpRequest(const AdBlockRequest& request) const;
+    bool matchImage(const AdBlockRequest& request) const;
+    bool matchScript(const AdBlockRequest& request) const;
+    bool matchStyleSheet(const AdBlockRequest& request) const;
+    bool matchObjectSubrequest(const AdBlockRequest& request) const;
+
+    // Stores already parsed rule, so that it can be restored without parsing its filter.
+    void saveToStream(QDataStream& out) const;
+    bool loadFromStream(QDataStream& in);
 
   protected:
     bool matchDomain(const QString& pattern, const QString& domain) const;
@@ -147,6 +164,7 @@ class AdBlockRule {
     bool filterIsOnlyEndsMatch(const QString& filter) const;
     QString createRegExpFromFilter(const QString& filter) const;
     QList<QStringMatcher> createStringMatchers(const QStringList& filters) const;
+    QStringList parseTokens(const QString& filter) const;
 
     AdBlockSubscription* m_subscription;
     RuleType m_type;
@@ -167,6 +185,9 @@ class AdBlockRule {
     bool m_isInternalDisabled;
     QStringList m_allowedDomains;
     QStringList m_blockedDomains;
+
+    // Lowercase substrings which must appear as whole tokens in every matching URL.
+    QStringList m_tokens;
     struct RegExp {
       SimpleRegExp regExp;
 
@@ -178,6 +199,7 @@ class AdBlockRule {
 
     friend class AdBlockMatcher;
     friend class AdBlockSearchTree;
+    friend class AdBlockTokenIndex;
     friend class AdBlockSubscription;
 };
 
@@ -20,7 +20,6 @@
 #include "network-web/adblock/adblockrule.h"
 #include "network-web/adblock/adblocksearchtree.h"
 
-#include <QWebEngineUrlRequestInfo>
 
 AdBlockSearchTree::AdBlockSearchTree() : m_root(new Node) {}
 
@@ -65,7 +64,7 @@ bool AdBlockSearchTree::add(const AdBlockRule* rule) {
   return true;
 }
 
-const AdBlockRule* AdBlockSearchTree::find(const QWebEngineUrlRequestInfo& request, const QString& domain, const QString& urlString) const {
+const AdBlockRule* AdBlockSearchTree::find(const AdBlockRequest& request, const QString& domain, const QString& urlString) const {
   int len = urlString.size();
 
   if (len <= 0) {
@@ -85,7 +84,7 @@ const AdBlockRule* AdBlockSearchTree::find(const QWebEngineUrlRequestInfo& reque
   return 0;
 }
 
-const AdBlockRule* AdBlockSearchTree::prefixSearch(const QWebEngineUrlRequestInfo& request, const QString& domain, const QString& urlString,
+const AdBlockRule* AdBlockSearchTree::prefixSearch(const AdBlockRequest& request, const QString& domain, const QString& urlString,
                                                    const QChar* string, int len) const {
   if (len <= 0) {
     return 0;
@@ -23,7 +23,7 @@
 #include <QChar>
 #include <QHash>
 
-class QWebEngineUrlRequestInfo;
+struct AdBlockRequest;
 class AdBlockRule;
 
 class AdBlockSearchTree {
@@ -34,7 +34,7 @@ class AdBlockSearchTree {
     void clear();
 
     bool add(const AdBlockRule* rule);
-    const AdBlockRule* find(const QWebEngineUrlRequestInfo& request, const QString& domain, const QString& urlString) const;
+    const AdBlockRule* find(const AdBlockRequest& request, const QString& domain, const QString& urlString) const;
 
   private:
     struct Node {
@@ -46,7 +46,7 @@ class AdBlockSearchTree {
       Node() : c(0), rule(0) { }
 
     };
-    const AdBlockRule* prefixSearch(const QWebEngineUrlRequestInfo& request, const QString& domain,
+    const AdBlockRule* prefixSearch(const AdBlockRequest& request, const QString& domain,
                                     const QString& urlString, const QChar* string, int len) const;
 
     void deleteNode(Node* node);
@@ -55,12 +55,40 @@
 #include "network-web/adblock/adblocksearchtree.h"
 #include "network-web/silentnetworkaccessmanager.h"
 
+#include <QCryptographicHash>
+#include <QDataStream>
 #include <QDir>
 #include <QFile>
 #include <QNetworkReply>
+#include <QRunnable>
 #include <QSaveFile>
+#include <QThreadPool>
 #include <QTimer>
 
+// Writes already compiled rules to disk.
+class AdBlockCompiledRulesWriter : public QRunnable {
+  public:
+    explicit AdBlockCompiledRulesWriter(const QString& file_path, const QByteArray& data)
+      : m_filePath(file_path), m_data(data) {}
+
+    void run() {
+      QSaveFile file(m_filePath);
+
+      if (!file.open(QFile::WriteOnly)) {
+        qWarning("Unable to open compiled AdBlock file '%s' for writing.", qPrintable(m_filePath));
+        return;
+      }
+
+      if (file.write(m_data) != m_data.size() || !file.commit()) {
+        qWarning("Failed to write compiled AdBlock file '%s'.", qPrintable(m_filePath));
+      }
+    }
+
+  private:
+    QString m_filePath;
+    QByteArray m_data;
+};
+
 AdBlockSubscription::AdBlockSubscription(const QString& title, QObject* parent)
   : QObject(parent), m_reply(0), m_title(title), m_updated(false) {}
 
@@ -98,7 +126,21 @@ void AdBlockSubscription::loadSubscription(const QStringList& disabledRules) {
     return;
   }
 
-  QTextStream textStream(&file);
+  const QByteArray data = file.readAll();
+  const QByteArray checksum = QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+
+  file.close();
+
+  // Unchanged list is loaded from its compiled form, no parsing needed.
+  if (!m_title.isEmpty() && loadCompiledRules(checksum, disabledRules)) {
+    if (m_rules.isEmpty() && !m_updated) {
+      QTimer::singleShot(0, this, SLOT(updateSubscription()));
+    }
+
+    return;
+  }
+
+  QTextStream textStream(data);
 
   textStream.setCodec("UTF-8");
 
@@ -113,11 +155,18 @@ void AdBlockSubscription::loadSubscription(const QStringList& disabledRules) {
     return;
   }
 
+  QByteArray compiled_rules;
+  QDataStream compiled_stream(&compiled_rules, QIODevice::WriteOnly);
+
+  compiled_stream.setVersion(QDataStream::Qt_5_6);
   m_rules.clear();
 
   while (!textStream.atEnd()) {
     AdBlockRule* rule = new AdBlockRule(textStream.readLine(), this);
 
+    // Rule is compiled as it was parsed, before it is disabled by user.
+    rule->saveToStream(compiled_stream);
+
     if (disabledRules.contains(rule->filter())) {
       rule->setEnabled(false);
     }
@@ -125,12 +174,79 @@ void AdBlockSubscription::loadSubscription(const QStringList& disabledRules) {
     m_rules.append(rule);
   }
 
+  saveCompiledRules(checksum, m_rules.size(), compiled_rules);
+
   // Initial update.
   if (m_rules.isEmpty() && !m_updated) {
     QTimer::singleShot(0, this, SLOT(updateSubscription()));
   }
 }
 
+QString AdBlockSubscription::compiledFilePath() const {
+  return m_filePath + QL1S(ADBLOCK_COMPILED_SUFFIX);
+}
+
+bool AdBlockSubscription::loadCompiledRules(const QByteArray& checksum, const QStringList& disabledRules) {
+  QFile file(compiledFilePath());
+
+  if (!file.open(QFile::ReadOnly) || file.size() <= 0) {
+    return false;
+  }
+
+  const qint64 size = file.size();
+  uchar* mapped = file.map(0, size);
+  QByteArray contents = mapped != nullptr ?
+                        QByteArray::fromRawData(reinterpret_cast<const char*>(mapped), int(size)) :
+                        file.readAll();
+  QDataStream in(contents);
+  quint32 magic, version;
+  QByteArray stored_checksum;
+  qint32 count;
+
+  in.setVersion(QDataStream::Qt_5_6);
+  in >> magic >> version >> stored_checksum >> count;
+
+  if (in.status() != QDataStream::Ok || magic != ADBLOCK_COMPILED_MAGIC ||
+      version != ADBLOCK_COMPILED_VERSION || stored_checksum != checksum || count < 0) {
+    return false;
+  }
+
+  QVector<AdBlockRule*> rules;
+
+  rules.reserve(count);
+
+  for (int i = 0; i < count; i++) {
+    AdBlockRule* rule = new AdBlockRule(QString(), this);
+
+    if (!rule->loadFromStream(in)) {
+      qWarning("Compiled AdBlock file '%s' is corrupted.", qPrintable(compiledFilePath()));
+      delete rule;
+      qDeleteAll(rules);
+      return false;
+    }
+
+    if (disabledRules.contains(rule->filter())) {
+      rule->setEnabled(false);
+    }
+
+    rules.append(rule);
+  }
+
+  m_rules = rules;
+  return true;
+}
+
+void AdBlockSubscription::saveCompiledRules(const QByteArray& checksum, int count, const QByteArray& compiled_rules) const {
+  QByteArray header;
+  QDataStream out(&header, QIODevice::WriteOnly);
+
+  out.setVersion(QDataStream::Qt_5_6);
+  out << quint32(ADBLOCK_COMPILED_MAGIC) << quint32(ADBLOCK_COMPILED_VERSION) << checksum << qint32(count);
+
+  // Only writing is done in background, rules are not parsed again.
+  QThreadPool::globalInstance()->start(new AdBlockCompiledRulesWriter(compiledFilePath(), header + compiled_rules));
+}
+
 void AdBlockSubscription::saveSubscription() {}
 
 void AdBlockSubscription::updateSubscription() {
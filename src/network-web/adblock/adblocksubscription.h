@@ -99,6 +99,13 @@ class AdBlockSubscription : public QObject {
 
   protected:
     virtual bool saveDownloadedData(const QByteArray& data);
+
+    // Compiled form of the list is stored next to it and it is
+    // valid only as long as checksum of the list file matches.
+    QString compiledFilePath() const;
+    bool loadCompiledRules(const QByteArray& checksum, const QStringList& disabledRules);
+    void saveCompiledRules(const QByteArray& checksum, int count, const QByteArray& compiled_rules) const;
+
     QNetworkReply* m_reply;
 
     QVector<AdBlockRule*> m_rules;
@@ -0,0 +1,128 @@
+// This file is part of RSS Guard.
+
+//
+// Copyright (C) 2011-2017 by Martin Rotter <rotter.martinos@gmail.com>
+// Copyright (C) 2010-2014 by David Rosca <nowrep@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#include "network-web/adblock/adblocktokenindex.h"
+
+#include "definitions/definitions.h"
+#include "network-web/adblock/adblockrule.h"
+
+#include <QStringList>
+
+#include <algorithm>
+
+// Tokens present in nearly every URL, they would not narrow the search at all.
+static bool isBadToken(const QString& token) {
+  return token == QL1S("http") || token == QL1S("https") || token == QL1S("www") ||
+         token == QL1S("com") || token == QL1S("js") || token == QL1S("html");
+}
+
+static inline bool urlTokenCharacter(ushort u) {
+  return (u >= 'a' && u <= 'z') || (u >= '0' && u <= '9') || u == '%';
+}
+
+AdBlockTokenIndex::AdBlockTokenIndex() {}
+
+AdBlockTokenIndex::~AdBlockTokenIndex() {}
+
+void AdBlockTokenIndex::clear() {
+  m_rules.clear();
+}
+
+bool AdBlockTokenIndex::add(const AdBlockRule* rule) {
+  uint best_hash = 0;
+  int best_size = -1;
+  int best_length = 0;
+
+  // Pick token with fewest rules stored so far, prefer longer tokens when tied.
+  foreach (const QString& token, rule->m_tokens) {
+    if (isBadToken(token)) {
+      continue;
+    }
+
+    const uint hash = qHash(token);
+    const int size = m_rules.value(hash).size();
+
+    if (best_size < 0 || size < best_size || (size == best_size && token.size() > best_length)) {
+      best_hash = hash;
+      best_size = size;
+      best_length = token.size();
+    }
+  }
+
+  if (best_size < 0) {
+    return false;
+  }
+
+  m_rules[best_hash].append(rule);
+  return true;
+}
+
+const AdBlockRule* AdBlockTokenIndex::find(const AdBlockRequest& request, const QString& domain,
+                                           const QString& urlString) const {
+  if (m_rules.isEmpty()) {
+    return nullptr;
+  }
+
+  QVector<uint> hashes;
+
+  collectTokenHashes(urlString.toLower(), hashes);
+  collectTokenHashes(domain.toLower(), hashes);
+
+  std::sort(hashes.begin(), hashes.end());
+  hashes.erase(std::unique(hashes.begin(), hashes.end()), hashes.end());
+
+  foreach (uint hash, hashes) {
+    const auto bucket = m_rules.constFind(hash);
+
+    if (bucket == m_rules.constEnd()) {
+      continue;
+    }
+
+    foreach (const AdBlockRule* rule, bucket.value()) {
+      if (rule->networkMatch(request, domain, urlString)) {
+        return rule;
+      }
+    }
+  }
+
+  return nullptr;
+}
+
+void AdBlockTokenIndex::collectTokenHashes(const QString& string, QVector<uint>& hashes) const {
+  const int len = string.size();
+  const QChar* data = string.constData();
+  int i = 0;
+
+  while (i < len) {
+    if (!urlTokenCharacter(data[i].unicode())) {
+      ++i;
+      continue;
+    }
+
+    const int start = i;
+
+    while (i < len && urlTokenCharacter(data[i].unicode())) {
+      ++i;
+    }
+
+    if (i - start >= ADBLOCK_MIN_TOKEN_LENGTH) {
+      hashes.append(qHash(string.midRef(start, i - start)));
+    }
+  }
+}
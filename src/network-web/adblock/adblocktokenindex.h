@@ -0,0 +1,48 @@
+// This file is part of RSS Guard.
+
+//
+// Copyright (C) 2011-2017 by Martin Rotter <rotter.martinos@gmail.com>
+// Copyright (C) 2010-2014 by David Rosca <nowrep@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ADBLOCKTOKENINDEX_H
+#define ADBLOCKTOKENINDEX_H
+
+#include <QHash>
+#include <QVector>
+
+struct AdBlockRequest;
+class AdBlockRule;
+
+// Index of network rules keyed by hashes of tokens extracted from their filters.
+// Each rule is stored under single token, so only rules whose token
+// is present in the URL need to be evaluated.
+class AdBlockTokenIndex {
+  public:
+    explicit AdBlockTokenIndex();
+    virtual ~AdBlockTokenIndex();
+
+    void clear();
+
+    bool add(const AdBlockRule* rule);
+    const AdBlockRule* find(const AdBlockRequest& request, const QString& domain, const QString& urlString) const;
+
+  private:
+    void collectTokenHashes(const QString& string, QVector<uint>& hashes) const;
+
+    QHash<uint, QVector<const AdBlockRule*>> m_rules;
+};
+
+#endif // ADBLOCKTOKENINDEX_H
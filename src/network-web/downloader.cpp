@@ -26,7 +26,8 @@ Downloader::Downloader(QObject* parent)
   : QObject(parent), m_activeReply(nullptr), m_downloadManager(new SilentNetworkAccessManager(this)),
   m_timer(new QTimer(this)), m_customHeaders(QHash<QByteArray, QByteArray>()), m_inputData(QByteArray()),
   m_targetProtected(false), m_targetUsername(QString()), m_targetPassword(QString()),
-  m_lastOutputData(QByteArray()), m_lastOutputError(QNetworkReply::NoError), m_lastContentType(QVariant()) {
+  m_lastOutputData(QByteArray()), m_lastOutputError(QNetworkReply::NoError), m_lastContentType(QVariant()),
+  m_lastHttpStatusCode(0), m_lastRedirectCount(0) {
   m_timer->setInterval(DOWNLOAD_TIMEOUT);
   m_timer->setSingleShot(true);
   connect(m_timer, &QTimer::timeout, this, &Downloader::cancel);
@@ -58,6 +59,7 @@ void Downloader::manipulateData(const QString& url, QNetworkAccessManager::Opera
   }
 
   m_inputData = data;
+  m_lastRedirectCount = 0;
 
   // Set url for this request and fire it up.
   m_timer->setInterval(timeout);
@@ -111,6 +113,7 @@ void Downloader::finished() {
 
     m_activeReply->deleteLater();
     m_activeReply = nullptr;
+    m_lastRedirectCount++;
 
     if (reply_operation == QNetworkAccessManager::GetOperation) {
       runGetRequest(request);
@@ -131,6 +134,7 @@ void Downloader::finished() {
     m_lastOutputData = reply->readAll();
     m_lastContentType = reply->header(QNetworkRequest::ContentTypeHeader);
     m_lastOutputError = reply->error();
+    m_lastHttpStatusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
     m_activeReply->deleteLater();
     m_activeReply = nullptr;
     emit completed(m_lastOutputError, m_lastOutputData);
@@ -189,6 +193,14 @@ QVariant Downloader::lastContentType() const {
   return m_lastContentType;
 }
 
+int Downloader::lastHttpStatusCode() const {
+  return m_lastHttpStatusCode;
+}
+
+int Downloader::lastRedirectCount() const {
+  return m_lastRedirectCount;
+}
+
 void Downloader::cancel() {
   if (m_activeReply != nullptr) {
     // Download action timed-out, too slow connection or target is not reachable.
@@ -42,6 +42,8 @@ class Downloader : public QObject {
     QByteArray lastOutputData() const;
     QNetworkReply::NetworkError lastOutputError() const;
     QVariant lastContentType() const;
+    int lastHttpStatusCode() const;
+    int lastRedirectCount() const;
 
   public slots:
     void cancel();
@@ -98,6 +100,8 @@ class Downloader : public QObject {
 
     QNetworkReply::NetworkError m_lastOutputError;
     QVariant m_lastContentType;
+    int m_lastHttpStatusCode;
+    int m_lastRedirectCount;
 };
 
 #endif // DOWNLOADER_H
@@ -19,6 +19,7 @@
 #include "network-web/networkfactory.h"
 
 #include "definitions/definitions.h"
+#include "miscellaneous/cancellationtoken.h"
 #include "miscellaneous/settings.h"
 #include "network-web/downloader.h"
 #include "network-web/silentnetworkaccessmanager.h"
@@ -153,21 +154,23 @@ QString NetworkFactory::networkErrorText(QNetworkReply::NetworkError error_code)
   }
 }
 
-QNetworkReply::NetworkError NetworkFactory::downloadIcon(const QList<QString>& urls, int timeout, QIcon& output) {
+QNetworkReply::NetworkError NetworkFactory::downloadIcon(const QList<QString>& urls, int timeout, QByteArray& output) {
   QNetworkReply::NetworkError network_result = QNetworkReply::UnknownNetworkError;
 
   foreach (const QString& url, urls) {
     const QString google_s2_with_url = QString("http://www.google.com/s2/favicons?domain=%1").arg(QUrl(url).host());
-    QByteArray icon_data;
 
-    network_result = performNetworkOperation(google_s2_with_url, timeout, QByteArray(), icon_data,
+    network_result = performNetworkOperation(google_s2_with_url, timeout, QByteArray(), output,
                                              QNetworkAccessManager::GetOperation).first;
 
     if (network_result == QNetworkReply::NoError) {
-      QPixmap icon_pixmap;
+      break;
+    }
 
-      icon_pixmap.loadFromData(icon_data);
-      output = QIcon(icon_pixmap);
+    // NOTE: Timed out requests are reported as canceled too, only real cancellation stops trying other URLs.
+    CancellationToken* cancellation = CancellationToken::current();
+
+    if (cancellation != nullptr && cancellation->isCancelled()) {
       break;
     }
   }
@@ -175,6 +178,20 @@ QNetworkReply::NetworkError NetworkFactory::downloadIcon(const QList<QString>& u
   return network_result;
 }
 
+QNetworkReply::NetworkError NetworkFactory::downloadIcon(const QList<QString>& urls, int timeout, QIcon& output) {
+  QByteArray icon_data;
+  QNetworkReply::NetworkError network_result = downloadIcon(urls, timeout, icon_data);
+
+  if (network_result == QNetworkReply::NoError) {
+    QPixmap icon_pixmap;
+
+    icon_pixmap.loadFromData(icon_data);
+    output = QIcon(icon_pixmap);
+  }
+
+  return network_result;
+}
+
 Downloader* NetworkFactory::performAsyncNetworkOperation(const QString& url, int timeout, const QByteArray& input_data,
                                                          QNetworkAccessManager::Operation operation,
                                                          QList<QPair<QByteArray, QByteArray>> additional_headers,
@@ -198,14 +215,27 @@ NetworkResult NetworkFactory::performNetworkOperation(const QString& url, int ti
                                                       QByteArray& output, QNetworkAccessManager::Operation operation,
                                                       QList<QPair<QByteArray, QByteArray>> additional_headers,
                                                       bool protected_contents,
-                                                      const QString& username, const QString& password) {
+                                                      const QString& username, const QString& password,
+                                                      NetworkOperationInfo* info) {
   Downloader downloader;
   QEventLoop loop;
   NetworkResult result;
+  CancellationToken* cancellation = CancellationToken::current();
 
   // We need to quit event loop when the download finishes.
   QObject::connect(&downloader, &Downloader::completed, &loop, &QEventLoop::quit);
 
+  if (cancellation != nullptr) {
+    // Operation runs on behalf of cancellable operation, abort the request as soon as it is cancelled.
+    // NOTE: Token is checked only after connecting, so that cancellation cannot be missed.
+    QObject::connect(cancellation, &CancellationToken::cancelled, &downloader, &Downloader::cancel);
+
+    if (cancellation->isCancelled()) {
+      result.first = QNetworkReply::OperationCanceledError;
+      return result;
+    }
+  }
+
   foreach (const auto& header, additional_headers) {
     if (!header.first.isEmpty()) {
       downloader.appendRawHeader(header.first, header.second);
@@ -218,5 +248,12 @@ NetworkResult NetworkFactory::performNetworkOperation(const QString& url, int ti
   output = downloader.lastOutputData();
   result.first = downloader.lastOutputError();
   result.second = downloader.lastContentType();
+
+  if (info != nullptr) {
+    info->m_httpStatusCode = downloader.lastHttpStatusCode();
+    info->m_redirectCount = downloader.lastRedirectCount();
+    info->m_bytesReceived = output.size();
+  }
+
   return result;
 }
@@ -26,6 +26,13 @@
 
 typedef QPair<QNetworkReply::NetworkError, QVariant> NetworkResult;
 
+// Transport details of finished network operation.
+struct NetworkOperationInfo {
+  int m_httpStatusCode = 0;
+  int m_redirectCount = 0;
+  qint64 m_bytesReceived = 0;
+};
+
 class Downloader;
 
 class NetworkFactory {
@@ -45,6 +52,8 @@ class NetworkFactory {
 
     // Performs SYNCHRONOUS download if favicon for the site,
     // given URL belongs to.
+    // NOTE: Variant with raw icon data can be used outside of GUI thread.
+    static QNetworkReply::NetworkError downloadIcon(const QList<QString>& urls, int timeout, QByteArray& output);
     static QNetworkReply::NetworkError downloadIcon(const QList<QString>& urls, int timeout, QIcon& output);
     static Downloader* performAsyncNetworkOperation(const QString& url,
                                                     int timeout,
@@ -62,7 +71,8 @@ class NetworkFactory {
                                                              QByteArray>> additional_headers = QList<QPair<QByteArray, QByteArray>>(),
                                                  bool protected_contents = false,
                                                  const QString& username = QString(),
-                                                 const QString& password = QString());
+                                                 const QString& password = QString(),
+                                                 NetworkOperationInfo* info = nullptr);
 };
 
 #endif // NETWORKFACTORY_H
@@ -18,113 +18,407 @@
 
 #include "services/abstract/cacheforserviceroot.h"
 
+#include "definitions/definitions.h"
 #include "miscellaneous/application.h"
 #include "miscellaneous/mutex.h"
+#include "services/abstract/syncoperationqueue.h"
 
+#include <QDataStream>
 #include <QDir>
-#include <QSet>
+#include <QSaveFile>
 
 CacheForServiceRoot::CacheForServiceRoot() : m_cacheSaveMutex(new Mutex(QMutex::NonRecursive, nullptr)),
-  m_cachedStatesRead(QMap<RootItem::ReadStatus, QStringList>()),
-  m_cachedStatesImportant(QMap<RootItem::Importance, QList<Message>>()) {}
+  m_syncQueue(new SyncOperationQueue(this)),
+  m_cachedStatesRead(QHash<QString, RootItem::ReadStatus>()),
+  m_cachedStatesImportant(QHash<QString, CachedImportanceState>()), m_journalEntries(0) {}
 
 CacheForServiceRoot::~CacheForServiceRoot() {
+  Q_ASSERT_X(m_syncQueue->isIdle(), "CacheForServiceRoot::~CacheForServiceRoot",
+             "outbound queue must be aborted by destructor of service root");
+  delete m_syncQueue;
+  m_journal.close();
   m_cacheSaveMutex->deleteLater();
 }
 
+void CacheForServiceRoot::abortSynchronization() {
+  m_syncQueue->abort();
+}
+
 void CacheForServiceRoot::addMessageStatesToCache(const QList<Message>& ids_of_messages, RootItem::Importance importance) {
+  QByteArray record;
+  QDataStream stream(&record, QIODevice::WriteOnly);
+
+  stream << quint8(ImportanceStateRecord) << qint32(importance) << ids_of_messages;
+
   m_cacheSaveMutex->lock();
 
-  QList<Message>& list_act = m_cachedStatesImportant[importance];
-  QList<Message>& list_other = m_cachedStatesImportant[importance == RootItem::Important ? RootItem::NotImportant : RootItem::Important];
+  // Store changes, they will be sent to server later.
+  applyImportanceStates(ids_of_messages, importance);
+  appendToJournal(record, ids_of_messages.size());
+
+  m_cacheSaveMutex->unlock();
+}
+
+void CacheForServiceRoot::addMessageStatesToCache(const QStringList& ids_of_messages, RootItem::ReadStatus read) {
+  QByteArray record;
+  QDataStream stream(&record, QIODevice::WriteOnly);
+
+  stream << quint8(ReadStateRecord) << qint32(read) << ids_of_messages;
+
+  m_cacheSaveMutex->lock();
 
   // Store changes, they will be sent to server later.
-  list_act.append(ids_of_messages);
-  QSet<Message> set_act = list_act.toSet();
-  QSet<Message> set_other = list_other.toSet();
+  applyReadStates(ids_of_messages, read);
+  appendToJournal(record, ids_of_messages.size());
+
+  m_cacheSaveMutex->unlock();
+}
+
+void CacheForServiceRoot::returnMessageStatesToCache(const QList<Message>& ids_of_messages, RootItem::Importance importance) {
+  m_cacheSaveMutex->lock();
+
+  // NOTE: Returned changes were never removed from journal, so it is not touched.
+  foreach (const Message& msg, ids_of_messages) {
+    QHash<QString, CachedImportanceState>::iterator sending = m_sendingStatesImportant.find(msg.m_customId);
+
+    // Changes superseded by newer ones are thrown away.
+    if (sending != m_sendingStatesImportant.end() && sending.value().m_importance == importance) {
+      if (!m_cachedStatesImportant.contains(msg.m_customId)) {
+        m_cachedStatesImportant.insert(msg.m_customId, sending.value());
+      }
 
-  // Now, we want to remove all IDS from list_other, which are contained in list.
-  set_other -= set_act;
-  list_act.clear();
-  list_act.append(set_act.toList());
-  list_other.clear();
-  list_other.append(set_other.toList());
+      m_sendingStatesImportant.erase(sending);
+    }
+  }
 
   m_cacheSaveMutex->unlock();
 }
 
-void CacheForServiceRoot::addMessageStatesToCache(const QStringList& ids_of_messages, RootItem::ReadStatus read) {
+void CacheForServiceRoot::returnMessageStatesToCache(const QStringList& ids_of_messages, RootItem::ReadStatus read) {
   m_cacheSaveMutex->lock();
 
-  QStringList& list_act = m_cachedStatesRead[read];
-  QStringList& list_other = m_cachedStatesRead[read == RootItem::Read ? RootItem::Unread : RootItem::Read];
+  // NOTE: Returned changes were never removed from journal, so it is not touched.
+  foreach (const QString& id, ids_of_messages) {
+    QHash<QString, RootItem::ReadStatus>::iterator sending = m_sendingStatesRead.find(id);
 
-  // Store changes, they will be sent to server later.
-  list_act.append(ids_of_messages);
-  QSet<QString> set_act = list_act.toSet();
-  QSet<QString> set_other = list_other.toSet();
+    // Changes superseded by newer ones are thrown away.
+    if (sending != m_sendingStatesRead.end() && sending.value() == read) {
+      if (!m_cachedStatesRead.contains(id)) {
+        m_cachedStatesRead.insert(id, read);
+      }
 
-  // Now, we want to remove all IDS from list_other, which are contained in list.
-  set_other -= set_act;
-  list_act.clear();
-  list_act.append(set_act.toList());
-  list_other.clear();
-  list_other.append(set_other.toList());
+      m_sendingStatesRead.erase(sending);
+    }
+  }
 
   m_cacheSaveMutex->unlock();
 }
 
-void CacheForServiceRoot::saveCacheToFile(int acc_id) {
+void CacheForServiceRoot::confirmMessageStatesSent(const QList<Message>& ids_of_messages, RootItem::Importance importance) {
+  const QStringList ids = customIds(ids_of_messages);
+  QByteArray record;
+  QDataStream stream(&record, QIODevice::WriteOnly);
+
+  stream << quint8(ImportanceStateSentRecord) << qint32(importance) << ids;
+
   m_cacheSaveMutex->lock();
+  removeImportanceStates(m_sendingStatesImportant, ids, importance);
+  appendToJournal(record, ids.size());
+  m_cacheSaveMutex->unlock();
+}
 
-  // Save to file.
-  const QString file_cache = qApp->userDataFolder() + QDir::separator() + QString::number(acc_id) + "-cached-msgs.dat";
+void CacheForServiceRoot::confirmMessageStatesSent(const QStringList& ids_of_messages, RootItem::ReadStatus read) {
+  QByteArray record;
+  QDataStream stream(&record, QIODevice::WriteOnly);
 
-  if (isEmpty()) {
-    QFile::remove(file_cache);
+  stream << quint8(ReadStateSentRecord) << qint32(read) << ids_of_messages;
+
+  m_cacheSaveMutex->lock();
+  removeReadStates(m_sendingStatesRead, ids_of_messages, read);
+  appendToJournal(record, ids_of_messages.size());
+  m_cacheSaveMutex->unlock();
+}
+
+void CacheForServiceRoot::saveAllCachedData(bool async) {
+  const QPair<QMap<RootItem::ReadStatus, QStringList>, QMap<RootItem::Importance, QList<Message>>> msg_cache = takeMessageCache();
+
+  // Opposite changes of the same message were already merged
+  // by the cache, now we send what remains in batches.
+  foreach (RootItem::ReadStatus read, msg_cache.first.keys()) {
+    m_syncQueue->enqueueReadStates(read, msg_cache.first.value(read));
+  }
+
+  foreach (RootItem::Importance importance, msg_cache.second.keys()) {
+    m_syncQueue->enqueueImportanceStates(importance, msg_cache.second.value(importance));
+  }
+
+  if (!async) {
+    m_syncQueue->waitForDone();
+  }
+}
+
+int CacheForServiceRoot::syncBatchSize() const {
+  return SYNC_DEFAULT_BATCH_SIZE;
+}
+
+int CacheForServiceRoot::syncParallelism() const {
+  return SYNC_MAX_THREADS;
+}
+
+void CacheForServiceRoot::applyReadStates(const QStringList& ids_of_messages, RootItem::ReadStatus read) {
+  foreach (const QString& id, ids_of_messages) {
+    m_cachedStatesRead.insert(id, read);
+  }
+}
+
+void CacheForServiceRoot::applyImportanceStates(const QList<Message>& ids_of_messages, RootItem::Importance importance) {
+  foreach (const Message& msg, ids_of_messages) {
+    m_cachedStatesImportant.insert(msg.m_customId, importanceState(msg, importance));
+  }
+}
+
+void CacheForServiceRoot::removeReadStates(QHash<QString, RootItem::ReadStatus>& states, const QStringList& ids_of_messages,
+                                           RootItem::ReadStatus read) {
+  foreach (const QString& id, ids_of_messages) {
+    QHash<QString, RootItem::ReadStatus>::iterator state = states.find(id);
+
+    if (state != states.end() && state.value() == read) {
+      states.erase(state);
+    }
+  }
+}
+
+void CacheForServiceRoot::removeImportanceStates(QHash<QString, CachedImportanceState>& states,
+                                                 const QStringList& ids_of_messages, RootItem::Importance importance) {
+  foreach (const QString& id, ids_of_messages) {
+    QHash<QString, CachedImportanceState>::iterator state = states.find(id);
+
+    if (state != states.end() && state.value().m_importance == importance) {
+      states.erase(state);
+    }
+  }
+}
+
+CacheForServiceRoot::CachedImportanceState CacheForServiceRoot::importanceState(const Message& message,
+                                                                                RootItem::Importance importance) {
+  CachedImportanceState state;
+
+  state.m_importance = importance;
+  state.m_accountId = message.m_accountId;
+  state.m_id = message.m_id;
+  state.m_feedId = message.m_feedId;
+  state.m_customHash = message.m_customHash;
+  return state;
+}
+
+QStringList CacheForServiceRoot::customIds(const QList<Message>& messages) {
+  QStringList ids;
+
+  foreach (const Message& msg, messages) {
+    ids.append(msg.m_customId);
+  }
+
+  return ids;
+}
+
+QString CacheForServiceRoot::journalFilePath(int acc_id) const {
+  return qApp->userDataFolder() + QDir::separator() + QString::number(acc_id) + QSL("-cached-msgs.journal");
+}
+
+void CacheForServiceRoot::appendToJournal(const QByteArray& record, int entries_count) {
+  if (!m_journal.isOpen()) {
+    return;
+  }
+
+  if (m_journal.write(record) != record.size() || !m_journal.flush()) {
+    qWarning("Failed to append cached message states to journal '%s'.", qPrintable(m_journal.fileName()));
+  }
+
+  m_journalEntries += entries_count;
+
+  // Journal contains many superseded entries, rewrite it with current states only.
+  if (m_journalEntries > CACHE_JOURNAL_COMPACT_THRESHOLD &&
+      m_journalEntries > 2 * (m_cachedStatesRead.size() + m_cachedStatesImportant.size() +
+                              m_sendingStatesRead.size() + m_sendingStatesImportant.size())) {
+    compactJournal();
+  }
+}
+
+void CacheForServiceRoot::compactJournal() {
+  const QString file_name = m_journal.fileName();
+
+  if (file_name.isEmpty()) {
+    return;
+  }
+
+  m_journal.close();
+
+  if (isEmpty() && m_sendingStatesRead.isEmpty() && m_sendingStatesImportant.isEmpty()) {
+    QFile::remove(file_name);
+    m_journalEntries = 0;
   }
   else {
-    QFile file(file_cache);
+    QSaveFile snapshot(file_name);
 
-    if (file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
-      QDataStream stream(&file);
+    if (snapshot.open(QIODevice::WriteOnly)) {
+      QDataStream stream(&snapshot);
 
-      stream << m_cachedStatesImportant << m_cachedStatesRead;
-      file.flush();
-      file.close();
+      // Undelivered changes go first, so that newer cached changes win when journal is replayed.
+      writeStates(stream, m_sendingStatesRead, m_sendingStatesImportant);
+      writeStates(stream, m_cachedStatesRead, m_cachedStatesImportant);
+
+      if (!snapshot.commit()) {
+        qWarning("Failed to compact journal of cached message states '%s'.", qPrintable(file_name));
+      }
     }
 
-    clearCache();
+    m_journalEntries = m_cachedStatesRead.size() + m_cachedStatesImportant.size() +
+                       m_sendingStatesRead.size() + m_sendingStatesImportant.size();
   }
 
+  if (!m_journal.open(QIODevice::WriteOnly | QIODevice::Append)) {
+    qWarning("Failed to open journal of cached message states '%s'.", qPrintable(file_name));
+  }
+}
+
+void CacheForServiceRoot::writeStates(QDataStream& stream, const QHash<QString, RootItem::ReadStatus>& read_states,
+                                      const QHash<QString, CachedImportanceState>& important_states) {
+  const QPair<QMap<RootItem::ReadStatus, QStringList>, QMap<RootItem::Importance, QList<Message>>> states =
+    groupedStates(read_states, important_states);
+
+  foreach (RootItem::ReadStatus read, states.first.keys()) {
+    stream << quint8(ReadStateRecord) << qint32(read) << states.first.value(read);
+  }
+
+  foreach (RootItem::Importance importance, states.second.keys()) {
+    stream << quint8(ImportanceStateRecord) << qint32(importance) << states.second.value(importance);
+  }
+}
+
+void CacheForServiceRoot::replayJournal(int acc_id) {
+  QFile file(journalFilePath(acc_id));
+
+  if (file.exists() && file.open(QIODevice::ReadOnly)) {
+    QDataStream stream(&file);
+
+    while (!stream.atEnd()) {
+      quint8 type;
+      qint32 state;
+
+      stream >> type >> state;
+
+      if (type == ReadStateRecord) {
+        QStringList ids;
+
+        stream >> ids;
+
+        if (stream.status() == QDataStream::Ok) {
+          applyReadStates(ids, (RootItem::ReadStatus) state);
+          m_journalEntries += ids.size();
+        }
+      }
+      else if (type == ImportanceStateRecord) {
+        QList<Message> msgs;
+
+        stream >> msgs;
+
+        if (stream.status() == QDataStream::Ok) {
+          applyImportanceStates(msgs, (RootItem::Importance) state);
+          m_journalEntries += msgs.size();
+        }
+      }
+      else if (type == ReadStateSentRecord || type == ImportanceStateSentRecord) {
+        QStringList ids;
+
+        stream >> ids;
+
+        if (stream.status() == QDataStream::Ok) {
+          if (type == ReadStateSentRecord) {
+            removeReadStates(m_cachedStatesRead, ids, (RootItem::ReadStatus) state);
+          }
+          else {
+            removeImportanceStates(m_cachedStatesImportant, ids, (RootItem::Importance) state);
+          }
+
+          m_journalEntries += ids.size();
+        }
+      }
+      else {
+        stream.setStatus(QDataStream::ReadCorruptData);
+      }
+
+      if (stream.status() != QDataStream::Ok) {
+        // Last record was probably written only partially when application crashed.
+        qWarning("Journal of cached message states '%s' is corrupted, loading only valid records.", qPrintable(file.fileName()));
+        break;
+      }
+    }
+
+    file.close();
+  }
+}
+
+void CacheForServiceRoot::saveCacheToFile(int acc_id) {
+  // Changes which are being sent right now must be either
+  // delivered or returned to cache before it is saved.
+  abortSynchronization();
+  m_cacheSaveMutex->lock();
+
+  if (m_journal.fileName().isEmpty()) {
+    m_journal.setFileName(journalFilePath(acc_id));
+  }
+
+  // Journal is rewritten with current states only.
+  compactJournal();
+  m_journal.close();
+  clearCache();
+
   m_cacheSaveMutex->unlock();
 }
 
 void CacheForServiceRoot::clearCache() {
   m_cachedStatesRead.clear();
   m_cachedStatesImportant.clear();
+  m_sendingStatesRead.clear();
+  m_sendingStatesImportant.clear();
 }
 
 void CacheForServiceRoot::loadCacheFromFile(int acc_id) {
   m_cacheSaveMutex->lock();
   clearCache();
+  m_journal.close();
+  m_journalEntries = 0;
 
-  // Load from file.
+  // Load from legacy cache file, which is converted to journal.
   const QString file_cache = qApp->userDataFolder() + QDir::separator() + QString::number(acc_id) + "-cached-msgs.dat";
   QFile file(file_cache);
 
   if (file.exists()) {
     if (file.open(QIODevice::ReadOnly)) {
       QDataStream stream(&file);
+      QMap<RootItem::ReadStatus, QStringList> read_states;
+      QMap<RootItem::Importance, QList<Message>> important_states;
+
+      stream >> important_states >> read_states;
+
+      foreach (RootItem::ReadStatus read, read_states.keys()) {
+        applyReadStates(read_states.value(read), read);
+      }
+
+      foreach (RootItem::Importance importance, important_states.keys()) {
+        applyImportanceStates(important_states.value(importance), importance);
+      }
 
-      stream >> m_cachedStatesImportant >> m_cachedStatesRead;
-      file.flush();
       file.close();
     }
-
-    file.remove();
   }
 
+  // Load from journal and open it for appending of new changes.
+  replayJournal(acc_id);
+  m_journal.setFileName(journalFilePath(acc_id));
+  compactJournal();
+
+  file.remove();
   m_cacheSaveMutex->unlock();
 }
 
@@ -139,16 +433,61 @@ QPair<QMap<RootItem::ReadStatus, QStringList>, QMap<RootItem::Importance, QList<
   }
 
   // Make copy of changes.
-  QMap<RootItem::ReadStatus, QStringList> cached_data_read = m_cachedStatesRead;
-  cached_data_read.detach();
+  const QPair<QMap<RootItem::ReadStatus, QStringList>, QMap<RootItem::Importance, QList<Message>>> cached_data =
+    groupedStates(m_cachedStatesRead, m_cachedStatesImportant);
+
+  // Changes are now handed over to the outbound queue, they
+  // stay in journal until they are confirmed as delivered.
+  for (QHash<QString, RootItem::ReadStatus>::const_iterator i = m_cachedStatesRead.constBegin();
+       i != m_cachedStatesRead.constEnd(); i++) {
+    m_sendingStatesRead.insert(i.key(), i.value());
+  }
 
-  QMap<RootItem::Importance, QList<Message>> cached_data_imp = m_cachedStatesImportant;
-  cached_data_imp.detach();
+  for (QHash<QString, CachedImportanceState>::const_iterator i = m_cachedStatesImportant.constBegin();
+       i != m_cachedStatesImportant.constEnd(); i++) {
+    m_sendingStatesImportant.insert(i.key(), i.value());
+  }
 
-  clearCache();
+  m_cachedStatesRead.clear();
+  m_cachedStatesImportant.clear();
   m_cacheSaveMutex->unlock();
 
-  return QPair<QMap<RootItem::ReadStatus, QStringList>, QMap<RootItem::Importance, QList<Message>>>(cached_data_read, cached_data_imp);
+  return cached_data;
+}
+
+QPair<QMap<RootItem::ReadStatus, QStringList>, QMap<RootItem::Importance, QList<Message>>> CacheForServiceRoot::groupedStates(
+  const QHash<QString, RootItem::ReadStatus>& read_states_by_id,
+  const QHash<QString, CachedImportanceState>& important_states_by_id) {
+  QMap<RootItem::ReadStatus, QStringList> read_states;
+  QMap<RootItem::Importance, QList<Message>> important_states;
+
+  for (QHash<QString, RootItem::ReadStatus>::const_iterator i = read_states_by_id.constBegin();
+       i != read_states_by_id.constEnd(); i++) {
+    read_states[i.value()].append(i.key());
+  }
+
+  for (QHash<QString, CachedImportanceState>::const_iterator i = important_states_by_id.constBegin();
+       i != important_states_by_id.constEnd(); i++) {
+    Message msg;
+
+    msg.m_accountId = i.value().m_accountId;
+    msg.m_id = i.value().m_id;
+    msg.m_customId = i.key();
+    msg.m_feedId = i.value().m_feedId;
+    msg.m_customHash = i.value().m_customHash;
+    msg.m_isImportant = i.value().m_importance == RootItem::Important;
+    important_states[i.value().m_importance].append(msg);
+  }
+
+  return QPair<QMap<RootItem::ReadStatus, QStringList>, QMap<RootItem::Importance, QList<Message>>>(read_states, important_states);
+}
+
+bool CacheForServiceRoot::hasCachedChanges() const {
+  m_cacheSaveMutex->lock();
+  const bool has_changes = !isEmpty();
+
+  m_cacheSaveMutex->unlock();
+  return has_changes;
 }
 
 bool CacheForServiceRoot::isEmpty() const {
@@ -21,11 +21,16 @@
 
 #include "services/abstract/serviceroot.h"
 
+#include <QFile>
+#include <QHash>
 #include <QMap>
+#include <QNetworkReply>
 #include <QPair>
 #include <QStringList>
 
 class Mutex;
+class QDataStream;
+class SyncOperationQueue;
 
 class CacheForServiceRoot {
   public:
@@ -35,24 +40,113 @@ class CacheForServiceRoot {
     void addMessageStatesToCache(const QList<Message>& ids_of_messages, RootItem::Importance importance);
     void addMessageStatesToCache(const QStringList& ids_of_messages, RootItem::ReadStatus read);
 
+    // Returns changes which could not be sent to online service back to cache.
+    // Messages which have newer state cached already are skipped.
+    void returnMessageStatesToCache(const QList<Message>& ids_of_messages, RootItem::Importance importance);
+    void returnMessageStatesToCache(const QStringList& ids_of_messages, RootItem::ReadStatus read);
+
+    // Confirms that changes were delivered to online service, so they are removed from journal.
+    void confirmMessageStatesSent(const QList<Message>& ids_of_messages, RootItem::Importance importance);
+    void confirmMessageStatesSent(const QStringList& ids_of_messages, RootItem::ReadStatus read);
+
     // Persistently saves/loads cached changes to/from file.
-    // NOTE: The whole cache is cleared after save is done and before load is done.
+    // NOTE: Each cached change is also immediately appended to journal file,
+    // so that it survives crash of the application. Changes stay in journal
+    // until they are delivered to online service. Loading replays the journal
+    // and keeps it opened, saving compacts the journal and closes it.
+    // The whole cache is cleared after save is done and before load is done.
     void saveCacheToFile(int acc_id);
     void loadCacheFromFile(int acc_id);
 
-    virtual void saveAllCachedData(bool async = true) = 0;
+    // Sends all cached changes to online service via outbound queue,
+    // when not async, then method blocks until all changes are processed.
+    virtual void saveAllCachedData(bool async = true);
+
+    // Sends single batch of changes to online service, returns network error or
+    // QNetworkReply::NoError on success.
+    // NOTE: These methods are called from worker threads of outbound queue.
+    virtual QNetworkReply::NetworkError sendReadStatesToService(RootItem::ReadStatus read, const QStringList& custom_ids) = 0;
+    virtual QNetworkReply::NetworkError sendImportanceStatesToService(RootItem::Importance importance,
+                                                                      const QList<Message>& messages) = 0;
+
+    // Maximal count of messages sent in one request and maximal
+    // count of requests performed in parallel.
+    virtual int syncBatchSize() const;
+    virtual int syncParallelism() const;
 
   protected:
     QPair<QMap<RootItem::ReadStatus, QStringList>, QMap<RootItem::Importance, QList<Message>>> takeMessageCache();
 
+    // Aborts batches of outbound queue and returns them to cache. Service roots
+    // must call this in their destructors, because batches which are being sent
+    // call their virtual methods.
+    void abortSynchronization();
+
+    // Returns true if there are changes which were not handed over to outbound queue yet.
+    bool hasCachedChanges() const;
+
     Mutex* m_cacheSaveMutex;
+    SyncOperationQueue* m_syncQueue;
+
+    // Pending importance state of message. Only identification of the message
+    // is kept, which is the same data as in records of the journal.
+    struct CachedImportanceState {
+      RootItem::Importance m_importance;
+      int m_accountId;
+      int m_id;
+      QString m_feedId;
+      QString m_customHash;
+    };
+
+    // Pending states keyed by custom IDs of messages, newer
+    // state of the message replaces the older one.
+    QHash<QString, RootItem::ReadStatus> m_cachedStatesRead;
+    QHash<QString, CachedImportanceState> m_cachedStatesImportant;
 
-    QMap<RootItem::ReadStatus, QStringList> m_cachedStatesRead;
-    QMap<RootItem::Importance, QList<Message>> m_cachedStatesImportant;
+    // States which were handed over to outbound queue and are not delivered yet.
+    QHash<QString, RootItem::ReadStatus> m_sendingStatesRead;
+    QHash<QString, CachedImportanceState> m_sendingStatesImportant;
 
   private:
+    enum JournalRecordType {
+      ReadStateRecord = 1,
+      ImportanceStateRecord = 2,
+
+      // Changes were delivered, records contain only custom IDs of messages.
+      ReadStateSentRecord = 3,
+      ImportanceStateSentRecord = 4
+    };
+
+    void applyReadStates(const QStringList& ids_of_messages, RootItem::ReadStatus read);
+    void applyImportanceStates(const QList<Message>& ids_of_messages, RootItem::Importance importance);
+
+    // Removes given messages from states, but only if they are in given state.
+    static void removeReadStates(QHash<QString, RootItem::ReadStatus>& states, const QStringList& ids_of_messages,
+                                 RootItem::ReadStatus read);
+    static void removeImportanceStates(QHash<QString, CachedImportanceState>& states, const QStringList& ids_of_messages,
+                                       RootItem::Importance importance);
+    static CachedImportanceState importanceState(const Message& message, RootItem::Importance importance);
+    static QStringList customIds(const QList<Message>& messages);
+
+    // Returns given states grouped by the state.
+    static QPair<QMap<RootItem::ReadStatus, QStringList>, QMap<RootItem::Importance, QList<Message>>> groupedStates(
+      const QHash<QString, RootItem::ReadStatus>& read_states_by_id,
+      const QHash<QString, CachedImportanceState>& important_states_by_id);
+
+    // Journal manipulators, all of them expect that cache is locked.
+    QString journalFilePath(int acc_id) const;
+    static void writeStates(QDataStream& stream, const QHash<QString, RootItem::ReadStatus>& read_states,
+                            const QHash<QString, CachedImportanceState>& important_states);
+    void replayJournal(int acc_id);
+    void compactJournal();
+    void appendToJournal(const QByteArray& record, int entries_count);
+
+    // Returns true if there are no changes waiting to be handed over to outbound queue.
     bool isEmpty() const;
     void clearCache();
+
+    QFile m_journal;
+    int m_journalEntries;
 };
 
 #endif // CACHEFORSERVICEROOT_H
@@ -18,9 +18,12 @@
 
 #include "services/abstract/feed.h"
 
+#include "core/feedfailuretracker.h"
 #include "definitions/definitions.h"
 #include "miscellaneous/application.h"
+#include "miscellaneous/cancellationtoken.h"
 #include "miscellaneous/databasequeries.h"
+#include "miscellaneous/debugging.h"
 #include "miscellaneous/feedreader.h"
 #include "miscellaneous/iconfactory.h"
 #include "miscellaneous/mutex.h"
@@ -29,12 +32,15 @@
 #include "services/abstract/recyclebin.h"
 #include "services/abstract/serviceroot.h"
 
+#include <QCryptographicHash>
+#include <QElapsedTimer>
 #include <QThread>
+#include <QUrl>
 
 Feed::Feed(RootItem* parent)
   : RootItem(parent), m_url(QString()), m_status(Normal), m_autoUpdateType(DefaultAutoUpdate),
   m_autoUpdateInitialInterval(DEFAULT_AUTO_UPDATE_INTERVAL), m_autoUpdateRemainingInterval(DEFAULT_AUTO_UPDATE_INTERVAL),
-  m_totalCount(0), m_unreadCount(0) {
+  m_totalCount(0), m_unreadCount(0), m_cancellation(nullptr) {
   setKind(RootItemKind::Feed);
   setAutoDelete(false);
 }
@@ -58,7 +64,7 @@ Feed::Feed(const QSqlRecord& record) : Feed(nullptr) {
   qDebug("Custom ID of feed when loading from DB is '%s'.", qPrintable(customId()));
 }
 
-Feed::Feed(const Feed& other) : RootItem(other) {
+Feed::Feed(const Feed& other) : RootItem(other), m_cancellation(nullptr) {
   setKind(RootItemKind::Feed);
   setAutoDelete(false);
 
@@ -164,6 +170,10 @@ void Feed::setUrl(const QString& url) {
   m_url = url;
 }
 
+QString Feed::updateHost() const {
+  return QUrl(m_url).host().toLower();
+}
+
 void Feed::updateCounts(bool including_total_count) {
   bool is_main_thread = QThread::currentThread() == qApp->thread();
   QSqlDatabase database = is_main_thread ?
@@ -179,14 +189,39 @@ void Feed::updateCounts(bool including_total_count) {
 }
 
 void Feed::run() {
-  qDebug().nospace() << "Downloading new messages for feed "
+  qCDebugHot(LOG_FEEDS).nospace() << "Downloading new messages for feed "
                      << customId() << " in thread: \'"
                      << QThread::currentThreadId() << "\'.";
 
-  bool error_during_obtaining;
+  bool error_during_obtaining = false;
+  const Status status_before_update = status();
+  QElapsedTimer obtaining_timer;
+
+  m_updateMetrics = FeedUpdateMetrics();
+  m_updateMetrics.m_feedId = id();
+  m_updateMetrics.m_feedTitle = title();
+  m_updateMetrics.m_feedUrl = url();
+  obtaining_timer.start();
 
+  // Network operations of this thread are aborted when the update is cancelled.
+  CancellationToken::setCurrent(m_cancellation);
   QList<Message> msgs = obtainNewMessages(&error_during_obtaining);
-  qDebug().nospace() << "Downloaded " << msgs.size() << " messages for feed "
+
+  CancellationToken::setCurrent(nullptr);
+
+  if (m_cancellation != nullptr && m_cancellation->isCancelled()) {
+    // Update was stopped, partially obtained data are thrown away
+    // and aborted network operations are not errors of this feed.
+    qCDebugHot(LOG_FEEDS, "Update of feed '%s' was cancelled.", qPrintable(customId()));
+    msgs.clear();
+    error_during_obtaining = true;
+    setStatus(status_before_update);
+  }
+
+  m_updateMetrics.m_obtainingTime = obtaining_timer.elapsed();
+  m_updateMetrics.m_obtainedMessages = msgs.size();
+  m_updateMetrics.m_error = error_during_obtaining;
+  qCDebugHot(LOG_FEEDS).nospace() << "Downloaded " << msgs.size() << " messages for feed "
                      << customId() << " in thread: \'"
                      << QThread::currentThreadId() << "\'.";
 
@@ -209,6 +244,14 @@ void Feed::run() {
   emit messagesObtained(msgs, error_during_obtaining);
 }
 
+void Feed::setCancellationToken(CancellationToken* cancellation) {
+  m_cancellation = cancellation;
+}
+
+FeedUpdateMetrics& Feed::updateMetrics() {
+  return m_updateMetrics;
+}
+
 bool Feed::cleanMessages(bool clean_read_only) {
   return getParentServiceRoot()->cleanFeeds(QList<Feed*>() << this, clean_read_only);
 }
@@ -224,14 +267,29 @@ bool Feed::markAsReadUnread(RootItem::ReadStatus status) {
   return service->markFeedsReadUnread(QList<Feed*>() << this, status);
 }
 
+bool Feed::isPayloadUnchanged(const QByteArray& payload) {
+  m_pendingPayloadFingerprint = QCryptographicHash::hash(payload, QCryptographicHash::Md5);
+  return !m_payloadFingerprint.isEmpty() && m_payloadFingerprint == m_pendingPayloadFingerprint;
+}
+
+void Feed::resetPayloadFingerprint() {
+  m_payloadFingerprint.clear();
+  m_pendingPayloadFingerprint.clear();
+}
+
 int Feed::updateMessages(const QList<Message>& messages, bool error_during_obtaining) {
   QList<RootItem*> items_to_update;
   int updated_messages = 0;
   bool is_main_thread = QThread::currentThread() == qApp->thread();
 
-  qDebug("Updating messages in DB. Main thread: '%s'.", qPrintable(is_main_thread ? "true" : "false"));
+  qCDebugHot(LOG_DATABASE, "Updating messages in DB. Main thread: '%s'.", qPrintable(is_main_thread ? "true" : "false"));
 
-  if (!error_during_obtaining) {
+  if (!error_during_obtaining && m_updateMetrics.m_unchangedPayload) {
+    // Payload is the same as the last processed one, so stored messages
+    // and their counts are still valid.
+    setStatus(Normal);
+  }
+  else if (!error_during_obtaining) {
     bool anything_updated = false;
     bool ok = true;
 
@@ -246,6 +304,7 @@ int Feed::updateMessages(const QList<Message>& messages, bool error_during_obtai
     }
 
     if (ok) {
+      m_payloadFingerprint = m_pendingPayloadFingerprint;
       setStatus(updated_messages > 0 ? NewMessages : Normal);
       updateCounts(true);
 
@@ -310,6 +369,13 @@ QString Feed::getStatusDescription() const {
 }
 
 QString Feed::additionalTooltip() const {
-  return tr("Auto-update status: %1\n"
-            "Status: %2").arg(getAutoUpdateStatusDescription(), getStatusDescription());
+  QString tooltip = tr("Auto-update status: %1\n"
+                       "Status: %2").arg(getAutoUpdateStatusDescription(), getStatusDescription());
+  const QString failures = qApp->feedReader()->failureTracker()->description(this);
+
+  if (!failures.isEmpty()) {
+    tooltip += QL1C('\n') + failures;
+  }
+
+  return tooltip;
 }
@@ -21,11 +21,14 @@
 
 #include "services/abstract/rootitem.h"
 
+#include "core/feedupdatestatistics.h"
 #include "core/message.h"
 
 #include <QRunnable>
 #include <QVariant>
 
+class CancellationToken;
+
 // Base class for "feed" nodes.
 class Feed : public RootItem, public QRunnable {
   Q_OBJECT
@@ -84,9 +87,18 @@ class Feed : public RootItem, public QRunnable {
     QString url() const;
     void setUrl(const QString& url);
 
+    // Host which is contacted when this feed is updated.
+    virtual QString updateHost() const;
+
     // Runs update in thread (thread pooled).
     void run();
 
+    // Measurements of last update of this feed.
+    FeedUpdateMetrics& updateMetrics();
+
+    // Token which stops running update of this feed.
+    void setCancellationToken(CancellationToken* cancellation);
+
     bool markAsReadUnread(ReadStatus status);
     bool cleanMessages(bool clean_read_only);
 
@@ -98,6 +110,15 @@ class Feed : public RootItem, public QRunnable {
     QString getAutoUpdateStatusDescription() const;
     QString getStatusDescription() const;
 
+    // Checks whether downloaded payload is byte-identical to the last successfully
+    // processed payload of this feed. Fingerprint of given payload is remembered
+    // and becomes "last processed" once messages of this update are stored.
+    bool isPayloadUnchanged(const QByteArray& payload);
+    void resetPayloadFingerprint();
+
+  protected:
+    FeedUpdateMetrics m_updateMetrics;
+
   signals:
     void messagesObtained(QList<Message> messages, bool error_during_obtaining);
 
@@ -114,6 +135,9 @@ class Feed : public RootItem, public QRunnable {
     int m_autoUpdateRemainingInterval;
     int m_totalCount;
     int m_unreadCount;
+    QByteArray m_payloadFingerprint;
+    QByteArray m_pendingPayloadFingerprint;
+    CancellationToken* m_cancellation;
 };
 
 Q_DECLARE_METATYPE(Feed::AutoUpdateType)
@@ -22,6 +22,7 @@
 #include "definitions/definitions.h"
 #include "gui/baselineedit.h"
 #include "gui/messagebox.h"
+#include "gui/retentionpolicyedit.h"
 #include "gui/systemtrayicon.h"
 #include "miscellaneous/iconfactory.h"
 #include "miscellaneous/textfactory.h"
@@ -314,6 +315,7 @@ void FormFeedDetails::setEditableFeed(Feed* editable_feed) {
   m_ui->m_txtUrl->lineEdit()->setText(editable_feed->url());
   m_ui->m_cmbAutoUpdateType->setCurrentIndex(m_ui->m_cmbAutoUpdateType->findData(QVariant::fromValue((int) editable_feed->autoUpdateType())));
   m_ui->m_spinAutoUpdateInterval->setValue(editable_feed->autoUpdateInitialInterval());
+  m_retentionPolicy->loadPolicy(m_serviceRoot->accountId(), editable_feed->customId());
 }
 
 void FormFeedDetails::initialize() {
@@ -385,6 +387,10 @@ void FormFeedDetails::initialize() {
   m_ui->m_cmbAutoUpdateType->addItem(tr("Auto-update every"), QVariant::fromValue((int) Feed::SpecificAutoUpdate));
   m_ui->m_cmbAutoUpdateType->addItem(tr("Do not auto-update at all"), QVariant::fromValue((int) Feed::DontAutoUpdate));
 
+  // Setup retention policy, it is placed right above the buttons.
+  m_retentionPolicy = new RetentionPolicyEdit(this);
+  m_ui->verticalLayout->insertWidget(m_ui->verticalLayout->indexOf(m_ui->m_buttonBox), m_retentionPolicy);
+
   // Set tab order.
   setTabOrder(m_ui->m_cmbParentCategory, m_ui->m_cmbType);
   setTabOrder(m_ui->m_cmbType, m_ui->m_cmbEncoding);
@@ -398,6 +404,7 @@ void FormFeedDetails::initialize() {
   setTabOrder(m_ui->m_btnIcon, m_ui->m_gbAuthentication);
   setTabOrder(m_ui->m_gbAuthentication, m_ui->m_txtUsername->lineEdit());
   setTabOrder(m_ui->m_txtUsername->lineEdit(), m_ui->m_txtPassword->lineEdit());
+  setTabOrder(m_ui->m_txtPassword->lineEdit(), m_retentionPolicy);
   m_ui->m_txtUrl->lineEdit()->setFocus(Qt::TabFocusReason);
 }
 
@@ -412,3 +419,9 @@ void FormFeedDetails::loadCategories(const QList<Category*> categories, RootItem
                                        QVariant::fromValue((void*) category));
   }
 }
+
+void FormFeedDetails::saveRetentionPolicy(Feed* feed) {
+  if (!m_retentionPolicy->savePolicy(m_serviceRoot->accountId(), feed->customId())) {
+    qWarning("Retention policy of feed '%s' was not saved.", qPrintable(feed->customId()));
+  }
+}
@@ -28,6 +28,7 @@ namespace Ui {
 }
 
 class ServiceRoot;
+class RetentionPolicyEdit;
 class Feed;
 class Category;
 class RootItem;
@@ -86,6 +87,9 @@ class FormFeedDetails : public QDialog {
     // Loads categories into the dialog from the model.
     void loadCategories(const QList<Category*> categories, RootItem* root_item);
 
+    // Stores retention policy of given feed.
+    void saveRetentionPolicy(Feed* feed);
+
   protected:
     QScopedPointer<Ui::FormFeedDetails> m_ui;
     Feed* m_editableFeed;
@@ -95,6 +99,7 @@ class FormFeedDetails : public QDialog {
     QAction* m_actionUseDefaultIcon;
     QAction* m_actionFetchIcon;
     QAction* m_actionNoIcon;
+    RetentionPolicyEdit* m_retentionPolicy;
 };
 
 #endif // FORMFEEDDETAILS_H
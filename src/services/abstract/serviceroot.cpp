@@ -444,6 +444,11 @@ bool ServiceRoot::loadMessagesForItem(RootItem* item, MessagesModel* model) {
   return true;
 }
 
+bool ServiceRoot::requiresMessagesForStateChanges() const {
+  // Messages are needed only for caching of states, which are later synchronized with online service.
+  return dynamic_cast<const CacheForServiceRoot*>(this) != nullptr;
+}
+
 bool ServiceRoot::onBeforeSetMessagesRead(RootItem* selected_item, const QList<Message>& messages, RootItem::ReadStatus read) {
   Q_UNUSED(selected_item)
 
@@ -98,6 +98,11 @@ class ServiceRoot : public RootItem {
     // right when feeds are updated.
     virtual bool loadMessagesForItem(RootItem* item, MessagesModel* model);
 
+    // Returns true if lists of messages passed to methods below are needed
+    // by this account. If false is returned, bulk changes done in message list
+    // pass empty lists there, which saves time with large selections.
+    virtual bool requiresMessagesForStateChanges() const;
+
     // Called BEFORE this read status update (triggered by user in message list) is stored in DB,
     // when false is returned, change is aborted.
     // This is the place to make some other changes like updating
@@ -0,0 +1,181 @@
+// This file is part of RSS Guard.
+
+//
+// Copyright (C) 2011-2017 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#include "services/abstract/syncoperationqueue.h"
+
+#include "definitions/definitions.h"
+#include "miscellaneous/application.h"
+#include "miscellaneous/cancellationtoken.h"
+#include "services/abstract/cacheforserviceroot.h"
+
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+
+// Sends single batch of changes to online service.
+class SyncBatchSender : public QRunnable {
+  public:
+    explicit SyncBatchSender(SyncOperationQueue* queue, CacheForServiceRoot* cache, CancellationToken* cancellation,
+                             RootItem::ReadStatus read, const QStringList& custom_ids)
+      : m_queue(queue), m_cache(cache), m_cancellation(cancellation), m_isReadBatch(true), m_read(read),
+      m_importance(RootItem::NotImportant), m_customIds(custom_ids) {}
+
+    explicit SyncBatchSender(SyncOperationQueue* queue, CacheForServiceRoot* cache, CancellationToken* cancellation,
+                             RootItem::Importance importance, const QList<Message>& messages)
+      : m_queue(queue), m_cache(cache), m_cancellation(cancellation), m_isReadBatch(false), m_read(RootItem::Read),
+      m_importance(importance), m_messages(messages) {}
+
+    void run() {
+      QNetworkReply::NetworkError error = QNetworkReply::OperationCanceledError;
+      int attempts = 0;
+
+      // Network operations of the batch are aborted when queue is aborted.
+      CancellationToken::setCurrent(m_cancellation);
+
+      while (attempts < SYNC_MAX_ATTEMPTS && !m_cancellation->isCancelled()) {
+        // Wait before next attempt, delay is doubled with each failure.
+        if (attempts > 0 && m_cancellation->wait(SYNC_RETRY_DELAY << (attempts - 1))) {
+          break;
+        }
+
+        error = send();
+        attempts++;
+
+        if (error == QNetworkReply::NoError || !isRetryable(error)) {
+          break;
+        }
+      }
+
+      CancellationToken::setCurrent(nullptr);
+
+      if (error == QNetworkReply::NoError) {
+        // Changes are delivered, they can be forgotten.
+        if (m_isReadBatch) {
+          m_cache->confirmMessageStatesSent(m_customIds, m_read);
+        }
+        else {
+          m_cache->confirmMessageStatesSent(m_messages, m_importance);
+        }
+
+        return;
+      }
+
+      const int messages_count = m_isReadBatch ? m_customIds.size() : m_messages.size();
+
+      // Changes are returned to cache, they are not lost.
+      if (m_isReadBatch) {
+        m_cache->returnMessageStatesToCache(m_customIds, m_read);
+      }
+      else {
+        m_cache->returnMessageStatesToCache(m_messages, m_importance);
+      }
+
+      if (m_cancellation->isCancelled()) {
+        qDebug("Sending of batch of %d message state changes was aborted, returning it to cache.", messages_count);
+      }
+      else {
+        qWarning("Batch of %d message state changes was not sent after %d attempts (error %d), returning it to cache.",
+                 messages_count, attempts, int(error));
+        QMetaObject::invokeMethod(m_queue, "onBatchFailed", Qt::QueuedConnection, Q_ARG(int, messages_count));
+      }
+    }
+
+  private:
+    QNetworkReply::NetworkError send() {
+      if (m_isReadBatch) {
+        return m_cache->sendReadStatesToService(m_read, m_customIds);
+      }
+      else {
+        return m_cache->sendImportanceStatesToService(m_importance, m_messages);
+      }
+    }
+
+    // Repeating of requests which the service refused to authorize does not help.
+    static bool isRetryable(QNetworkReply::NetworkError error) {
+      switch (error) {
+        case QNetworkReply::AuthenticationRequiredError:
+        case QNetworkReply::ProxyAuthenticationRequiredError:
+        case QNetworkReply::ContentAccessDenied:
+          return false;
+
+        default:
+          return true;
+      }
+    }
+
+    SyncOperationQueue* m_queue;
+    CacheForServiceRoot* m_cache;
+    CancellationToken* m_cancellation;
+    bool m_isReadBatch;
+    RootItem::ReadStatus m_read;
+    RootItem::Importance m_importance;
+    QStringList m_customIds;
+    QList<Message> m_messages;
+};
+
+SyncOperationQueue::SyncOperationQueue(CacheForServiceRoot* cache, QObject* parent)
+  : QObject(parent), m_cache(cache), m_threadPool(new QThreadPool(this)), m_cancellation(new CancellationToken(this)) {}
+
+SyncOperationQueue::~SyncOperationQueue() {
+  abort();
+}
+
+void SyncOperationQueue::enqueueReadStates(RootItem::ReadStatus read, const QStringList& custom_ids) {
+  const int batch_size = qMax(1, m_cache->syncBatchSize());
+
+  updateThreadCount();
+
+  for (int i = 0; i < custom_ids.size(); i += batch_size) {
+    m_threadPool->start(new SyncBatchSender(this, m_cache, m_cancellation, read, custom_ids.mid(i, batch_size)));
+  }
+}
+
+void SyncOperationQueue::enqueueImportanceStates(RootItem::Importance importance, const QList<Message>& messages) {
+  const int batch_size = qMax(1, m_cache->syncBatchSize());
+
+  updateThreadCount();
+
+  for (int i = 0; i < messages.size(); i += batch_size) {
+    m_threadPool->start(new SyncBatchSender(this, m_cache, m_cancellation, importance, messages.mid(i, batch_size)));
+  }
+}
+
+void SyncOperationQueue::waitForDone() {
+  m_threadPool->waitForDone();
+}
+
+void SyncOperationQueue::abort() {
+  m_cancellation->cancel();
+  m_threadPool->waitForDone();
+  m_cancellation->reset();
+}
+
+bool SyncOperationQueue::isIdle() const {
+  return m_threadPool->activeThreadCount() == 0;
+}
+
+void SyncOperationQueue::onBatchFailed(int messages_count) {
+  qApp->showGuiMessage(tr("Cannot synchronize message states"),
+                       tr("%n message state change(s) could not be sent to online service. "
+                          "They will be sent again later.", nullptr, messages_count),
+                       QSystemTrayIcon::Warning);
+}
+
+void SyncOperationQueue::updateThreadCount() {
+  m_threadPool->setMaxThreadCount(qMax(1, m_cache->syncParallelism()));
+}
@@ -0,0 +1,68 @@
+// This file is part of RSS Guard.
+
+//
+// Copyright (C) 2011-2017 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef SYNCOPERATIONQUEUE_H
+#define SYNCOPERATIONQUEUE_H
+
+#include <QObject>
+
+#include "core/message.h"
+#include "services/abstract/rootitem.h"
+
+class CacheForServiceRoot;
+class CancellationToken;
+class QThreadPool;
+
+// Outbound queue of message state changes for single online account.
+// Changes are sent in batches by multiple threads. Failed batches are
+// retried with growing delay and if they still fail, their changes are
+// returned to the cache of the account, so that they are sent later.
+// Batches rejected by the service (e.g. when user is not logged in) are
+// returned to the cache immediately.
+class SyncOperationQueue : public QObject {
+  Q_OBJECT
+
+  public:
+    explicit SyncOperationQueue(CacheForServiceRoot* cache, QObject* parent = nullptr);
+    virtual ~SyncOperationQueue();
+
+    void enqueueReadStates(RootItem::ReadStatus read, const QStringList& custom_ids);
+    void enqueueImportanceStates(RootItem::Importance importance, const QList<Message>& messages);
+
+    // Blocks until all enqueued batches are sent or returned to cache.
+    void waitForDone();
+
+    // Aborts batches which are being sent, cancels pending retries and blocks
+    // until all batches are returned to cache. Queue can be used again afterwards.
+    void abort();
+
+    // Returns true if no batch is being sent.
+    bool isIdle() const;
+
+  private slots:
+    void onBatchFailed(int messages_count);
+
+  private:
+    void updateThreadCount();
+
+    CacheForServiceRoot* m_cache;
+    QThreadPool* m_threadPool;
+    CancellationToken* m_cancellation;
+};
+
+#endif // SYNCOPERATIONQUEUE_H
@@ -33,6 +33,7 @@
 #define INOREADER_DEFAULT_BATCH_SIZE    100
 #define INOREADER_MAX_BATCH_SIZE        999
 #define INOREADER_MIN_BATCH_SIZE        20
+#define INOREADER_MAX_EDIT_TAG_ITEMS    200
 
 #define INOREADER_STATE_READING_LIST    "state/com.google/reading-list"
 #define INOREADER_STATE_READ            "state/com.google/read"
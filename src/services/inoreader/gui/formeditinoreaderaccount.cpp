@@ -19,6 +19,7 @@
 #include "services/inoreader/gui/formeditinoreaderaccount.h"
 
 #include "gui/guiutilities.h"
+#include "gui/retentionpolicyedit.h"
 #include "miscellaneous/application.h"
 #include "miscellaneous/iconfactory.h"
 #include "network-web/oauth2service.h"
@@ -27,8 +28,10 @@
 
 FormEditInoreaderAccount::FormEditInoreaderAccount(QWidget* parent) : QDialog(parent),
   m_oauth(new OAuth2Service(INOREADER_OAUTH_AUTH_URL, INOREADER_OAUTH_TOKEN_URL,
-                            INOREADER_OAUTH_CLI_ID, INOREADER_OAUTH_CLI_KEY, INOREADER_OAUTH_SCOPE)), m_editableRoot(nullptr) {
+                            INOREADER_OAUTH_CLI_ID, INOREADER_OAUTH_CLI_KEY, INOREADER_OAUTH_SCOPE)), m_editableRoot(nullptr),
+  m_retentionPolicy(new RetentionPolicyEdit(this)) {
   m_ui.setupUi(this);
+  m_ui.verticalLayout->insertWidget(m_ui.verticalLayout->indexOf(m_ui.m_buttonBox), m_retentionPolicy);
 
   GuiUtilities::setLabelAsNotice(*m_ui.m_lblAuthInfo, true);
   GuiUtilities::applyDialogProperties(*this, qApp->icons()->miscIcon(QSL("inoreader")));
@@ -44,7 +47,8 @@ FormEditInoreaderAccount::FormEditInoreaderAccount(QWidget* parent) : QDialog(pa
   setTabOrder(m_ui.m_txtAppKey, m_ui.m_txtRedirectUrl);
   setTabOrder(m_ui.m_txtRedirectUrl, m_ui.m_spinLimitMessages);
   setTabOrder(m_ui.m_spinLimitMessages, m_ui.m_btnTestSetup);
-  setTabOrder(m_ui.m_btnTestSetup, m_ui.m_buttonBox);
+  setTabOrder(m_ui.m_btnTestSetup, m_retentionPolicy);
+  setTabOrder(m_retentionPolicy, m_ui.m_buttonBox);
 
   connect(m_ui.m_txtAppId->lineEdit(), &BaseLineEdit::textChanged, this, &FormEditInoreaderAccount::checkOAuthValue);
   connect(m_ui.m_txtAppKey->lineEdit(), &BaseLineEdit::textChanged, this, &FormEditInoreaderAccount::checkOAuthValue);
@@ -105,6 +109,7 @@ void FormEditInoreaderAccount::onClickedOk() {
   m_editableRoot->network()->setUsername(m_ui.m_txtUsername->lineEdit()->text());
   m_editableRoot->network()->setBatchSize(m_ui.m_spinLimitMessages->value());
   m_editableRoot->saveAccountDataToDatabase();
+  m_retentionPolicy->savePolicy(m_editableRoot->accountId(), QString());
   accept();
 
   if (editing_account) {
@@ -183,6 +188,7 @@ void FormEditInoreaderAccount::execForEdit(InoreaderServiceRoot* existing_root)
 
   m_ui.m_txtUsername->lineEdit()->setText(existing_root->network()->userName());
   m_ui.m_spinLimitMessages->setValue(existing_root->network()->batchSize());
+  m_retentionPolicy->loadPolicy(existing_root->accountId(), QString());
 
   exec();
 }
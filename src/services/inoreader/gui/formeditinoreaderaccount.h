@@ -30,6 +30,7 @@ namespace Ui {
 }
 
 class InoreaderServiceRoot;
+class RetentionPolicyEdit;
 
 class FormEditInoreaderAccount : public QDialog {
   Q_OBJECT
@@ -57,7 +58,7 @@ class FormEditInoreaderAccount : public QDialog {
 
     Ui::FormEditInoreaderAccount m_ui;
     OAuth2Service* m_oauth;
-    InoreaderServiceRoot* m_editableRoot;
+    InoreaderServiceRoot* m_editableRoot;    RetentionPolicyEdit* m_retentionPolicy;
 };
 
 #endif // FORMEDITINOREADERACCOUNT_H
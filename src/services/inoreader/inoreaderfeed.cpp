@@ -20,9 +20,12 @@
 
 #include "miscellaneous/application.h"
 #include "miscellaneous/iconfactory.h"
+#include "services/inoreader/definitions.h"
 #include "services/inoreader/inoreaderserviceroot.h"
 #include "services/inoreader/network/inoreadernetworkfactory.h"
 
+#include <QUrl>
+
 InoreaderFeed::InoreaderFeed(RootItem* parent) : Feed(parent) {}
 
 InoreaderFeed::InoreaderFeed(const QSqlRecord& record) : Feed(record) {}
@@ -31,9 +34,14 @@ InoreaderServiceRoot* InoreaderFeed::serviceRoot() const {
   return qobject_cast<InoreaderServiceRoot*>(getParentServiceRoot());
 }
 
+QString InoreaderFeed::updateHost() const {
+  // Messages are obtained from Inoreader API, not from the feed itself.
+  return QUrl(INOREADER_API_FEED_CONTENTS).host().toLower();
+}
+
 QList<Message> InoreaderFeed::obtainNewMessages(bool* error_during_obtaining) {
   Feed::Status error;
-  QList<Message> messages = serviceRoot()->network()->messages(customId(), error);
+  QList<Message> messages = serviceRoot()->network()->messages(customId(), error, &m_updateMetrics.m_networkError);
 
   setStatus(error);
 
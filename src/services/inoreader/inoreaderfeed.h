@@ -29,6 +29,7 @@ class InoreaderFeed : public Feed {
     explicit InoreaderFeed(const QSqlRecord& record);
 
     InoreaderServiceRoot* serviceRoot() const;
+    QString updateHost() const;
 
   private:
     QList<Message> obtainNewMessages(bool* error_during_obtaining);
@@ -24,11 +24,15 @@
 #include "miscellaneous/iconfactory.h"
 #include "network-web/oauth2service.h"
 #include "services/abstract/recyclebin.h"
+#include "services/inoreader/definitions.h"
 #include "services/inoreader/gui/formeditinoreaderaccount.h"
 #include "services/inoreader/inoreaderentrypoint.h"
 #include "services/inoreader/network/inoreadernetworkfactory.h"
 #include "services/inoreader/network/inoreadernetworkfactory.h"
 
+#include <QMutexLocker>
+#include <QThread>
+
 InoreaderServiceRoot::InoreaderServiceRoot(InoreaderNetworkFactory* network, RootItem* parent) : ServiceRoot(parent),
   CacheForServiceRoot(), m_serviceMenu(QList<QAction*>()), m_network(network) {
   if (network == nullptr) {
@@ -42,7 +46,9 @@ InoreaderServiceRoot::InoreaderServiceRoot(InoreaderNetworkFactory* network, Roo
   setIcon(InoreaderEntryPoint().icon());
 }
 
-InoreaderServiceRoot::~InoreaderServiceRoot() {}
+InoreaderServiceRoot::~InoreaderServiceRoot() {
+  abortSynchronization();
+}
 
 void InoreaderServiceRoot::updateTitle() {
   setTitle(m_network->userName() + QSL(" (Inoreader)"));
@@ -166,37 +172,49 @@ void InoreaderServiceRoot::addNewFeed(const QString& url) {
 void InoreaderServiceRoot::addNewCategory() {}
 
 void InoreaderServiceRoot::saveAllCachedData(bool async) {
-  QPair<QMap<RootItem::ReadStatus, QStringList>, QMap<RootItem::Importance, QList<Message>>> msgCache = takeMessageCache();
-  QMapIterator<RootItem::ReadStatus, QStringList> i(msgCache.first);
+  if (!hasCachedChanges()) {
+    return;
+  }
 
-  // Save the actual data read/unread.
-  while (i.hasNext()) {
-    i.next();
-    auto key = i.key();
-    QStringList ids = i.value();
+  // Bearer is obtained before changes are queued, because OAuth service asks
+  // user to login when needed, which can be done only in GUI thread.
+  // Changes stay in cache until user logs in.
+  if (network()->oauth()->isFullyLoggedIn() || QThread::currentThread() == qApp->thread()) {
+    const QString bearer = network()->oauth()->bearer();
 
-    if (!ids.isEmpty()) {
-      network()->markMessagesRead(key, ids, async);
+    if (bearer.isEmpty()) {
+      return;
     }
+
+    m_syncBearerMutex.lock();
+    m_syncBearer = bearer;
+    m_syncBearerMutex.unlock();
+
+    CacheForServiceRoot::saveAllCachedData(async);
   }
+}
+
+QNetworkReply::NetworkError InoreaderServiceRoot::sendReadStatesToService(RootItem::ReadStatus read, const QStringList& custom_ids) {
+  return network()->markMessagesRead(read, custom_ids, syncBearer());
+}
 
-  QMapIterator<RootItem::Importance, QList<Message>> j(msgCache.second);
+QNetworkReply::NetworkError InoreaderServiceRoot::sendImportanceStatesToService(RootItem::Importance importance,
+                                                                                const QList<Message>& messages) {
+  QStringList custom_ids;
 
-  // Save the actual data important/not important.
-  while (j.hasNext()) {
-    j.next();
-    auto key = j.key();
+  foreach (const Message& msg, messages) {
+    custom_ids.append(msg.m_customId);
+  }
 
-    QList<Message> messages = j.value();
+  return network()->markMessagesStarred(importance, custom_ids, syncBearer());
+}
 
-    if (!messages.isEmpty()) {
-      QStringList custom_ids;
+QString InoreaderServiceRoot::syncBearer() const {
+  QMutexLocker locker(&m_syncBearerMutex);
 
-      foreach (const Message& msg, messages) {
-        custom_ids.append(msg.m_customId);
-      }
+  return m_syncBearer;
+}
 
-      network()->markMessagesStarred(key, custom_ids, async);
-    }
-  }
+int InoreaderServiceRoot::syncBatchSize() const {
+  return INOREADER_MAX_EDIT_TAG_ITEMS;
 }
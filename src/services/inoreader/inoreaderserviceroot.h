@@ -23,6 +23,8 @@
 #include "services/abstract/cacheforserviceroot.h"
 #include "services/abstract/serviceroot.h"
 
+#include <QMutex>
+
 class InoreaderNetworkFactory;
 
 class InoreaderServiceRoot : public ServiceRoot, public CacheForServiceRoot {
@@ -50,6 +52,9 @@ class InoreaderServiceRoot : public ServiceRoot, public CacheForServiceRoot {
     RootItem* obtainNewTreeForSyncIn() const;
 
     void saveAllCachedData(bool async = true);
+    QNetworkReply::NetworkError sendReadStatesToService(RootItem::ReadStatus read, const QStringList& custom_ids);
+    QNetworkReply::NetworkError sendImportanceStatesToService(RootItem::Importance importance, const QList<Message>& messages);
+    int syncBatchSize() const;
 
   public slots:
     void addNewFeed(const QString& url);
@@ -61,8 +66,14 @@ class InoreaderServiceRoot : public ServiceRoot, public CacheForServiceRoot {
     QList<QAction*> serviceMenu();
 
   private:
+    QString syncBearer() const;
+
     QList<QAction*> m_serviceMenu;
     InoreaderNetworkFactory* m_network;
+
+    // Bearer used by outbound queue, it is obtained in GUI thread.
+    mutable QMutex m_syncBearerMutex;
+    QString m_syncBearer;
 };
 
 inline void InoreaderServiceRoot::setNetwork(InoreaderNetworkFactory* network) {
@@ -89,71 +89,92 @@ void InoreaderNetworkFactory::setUsername(const QString& username) {
 // NOTE: oauth: https://developers.google.com/oauthplayground/#step3&scopes=read%20write&auth_code=497815bc3362aba9ad60c5ae3e01811fe2da4bb5&refresh_token=bacb9c36f82ba92667282d6175bb857a091e7f0c&access_token_field=094f92bc7aedbd27fbebc3efc9172b258be8944a&url=https%3A%2F%2Fwww.inoreader.com%2Freader%2Fapi%2F0%2Fsubscription%2Flist&content_type=application%2Fjson&http_method=GET&useDefaultOauthCred=unchecked&oauthEndpointSelect=Custom&oauthAuthEndpointValue=https%3A%2F%2Fwww.inoreader.com%2Foauth2%2Fauth%3Fstate%3Dtest&oauthTokenEndpointValue=https%3A%2F%2Fwww.inoreader.com%2Foauth2%2Ftoken&oauthClientId=1000000595&expires_in=3599&oauthClientSecret=_6pYUZgtNLWwSaB9pC1YOz6p4zwu3haL&access_token_issue_date=1506198338&for_access_token=094f92bc7aedbd27fbebc3efc9172b258be8944a&includeCredentials=checked&accessTokenType=bearer&autoRefreshToken=unchecked&accessType=offline&prompt=consent&response_type=code
 
 RootItem* InoreaderNetworkFactory::feedsCategories(bool obtain_icons) {
-  Downloader downloader;
-  QEventLoop loop;
   QString bearer = m_oauth2->bearer().toLocal8Bit();
 
   if (bearer.isEmpty()) {
     return nullptr;
   }
 
-  downloader.appendRawHeader(QString("Authorization").toLocal8Bit(), bearer.toLocal8Bit());
-
-  // We need to quit event loop when the download finishes.
-  connect(&downloader, &Downloader::completed, &loop, &QEventLoop::quit);
-  downloader.manipulateData(INOREADER_API_LIST_LABELS, QNetworkAccessManager::Operation::GetOperation);
-  loop.exec();
+  QList<QPair<QByteArray, QByteArray>> headers;
+  headers.append(QPair<QByteArray, QByteArray>(QString(HTTP_HEADERS_AUTHORIZATION).toLocal8Bit(),
+                                               bearer.toLocal8Bit()));
 
-  if (downloader.lastOutputError() != QNetworkReply::NetworkError::NoError) {
+  int timeout = qApp->settings()->value(GROUP(Feeds), SETTING(Feeds::UpdateTimeout)).toInt();
+  QByteArray category_data;
+  NetworkResult network_reply = NetworkFactory::performNetworkOperation(INOREADER_API_LIST_LABELS,
+                                                                        timeout,
+                                                                        QByteArray(),
+                                                                        category_data,
+                                                                        QNetworkAccessManager::Operation::GetOperation,
+                                                                        headers);
+
+  if (network_reply.first != QNetworkReply::NoError) {
     return nullptr;
   }
 
-  QString category_data = downloader.lastOutputData();
+  QByteArray feed_data;
 
-  downloader.manipulateData(INOREADER_API_LIST_FEEDS, QNetworkAccessManager::Operation::GetOperation);
-  loop.exec();
+  network_reply = NetworkFactory::performNetworkOperation(INOREADER_API_LIST_FEEDS,
+                                                          timeout,
+                                                          QByteArray(),
+                                                          feed_data,
+                                                          QNetworkAccessManager::Operation::GetOperation,
+                                                          headers);
 
-  if (downloader.lastOutputError() != QNetworkReply::NetworkError::NoError) {
+  if (network_reply.first != QNetworkReply::NoError) {
     return nullptr;
   }
 
-  QString feed_data = downloader.lastOutputData();
-
   return decodeFeedCategoriesData(category_data, feed_data, obtain_icons);
 }
 
-QList<Message> InoreaderNetworkFactory::messages(const QString& stream_id, Feed::Status& error) {
-  Downloader downloader;
-  QEventLoop loop;
+QList<Message> InoreaderNetworkFactory::messages(const QString& stream_id, Feed::Status& error,
+                                                 QNetworkReply::NetworkError* network_error) {
   QString target_url = INOREADER_API_FEED_CONTENTS;
   QString bearer = m_oauth2->bearer().toLocal8Bit();
 
   if (bearer.isEmpty()) {
     error = Feed::Status::AuthError;
+
+    if (network_error != nullptr) {
+      *network_error = QNetworkReply::AuthenticationRequiredError;
+    }
+
     return QList<Message>();
   }
 
   target_url += QSL("/") + QUrl::toPercentEncoding(stream_id) + QString("?n=%1").arg(batchSize());
-  downloader.appendRawHeader(QString("Authorization").toLocal8Bit(), bearer.toLocal8Bit());
 
-  // We need to quit event loop when the download finishes.
-  connect(&downloader, &Downloader::completed, &loop, &QEventLoop::quit);
-  downloader.manipulateData(target_url, QNetworkAccessManager::Operation::GetOperation);
-  loop.exec();
+  QList<QPair<QByteArray, QByteArray>> headers;
+  headers.append(QPair<QByteArray, QByteArray>(QString(HTTP_HEADERS_AUTHORIZATION).toLocal8Bit(),
+                                               bearer.toLocal8Bit()));
+
+  // Request is aborted as soon as the running update is cancelled.
+  int timeout = qApp->settings()->value(GROUP(Feeds), SETTING(Feeds::UpdateTimeout)).toInt();
+  QByteArray messages_data;
+  NetworkResult network_reply = NetworkFactory::performNetworkOperation(target_url,
+                                                                        timeout,
+                                                                        QByteArray(),
+                                                                        messages_data,
+                                                                        QNetworkAccessManager::Operation::GetOperation,
+                                                                        headers);
+
+  if (network_error != nullptr) {
+    *network_error = network_reply.first;
+  }
 
-  if (downloader.lastOutputError() != QNetworkReply::NetworkError::NoError) {
+  if (network_reply.first != QNetworkReply::NoError) {
     error = Feed::Status::NetworkError;
     return QList<Message>();
   }
   else {
-    QString messages_data = downloader.lastOutputData();
-
     error = Feed::Status::Normal;
     return decodeMessages(messages_data, stream_id);
   }
 }
 
-void InoreaderNetworkFactory::markMessagesRead(RootItem::ReadStatus status, const QStringList& custom_ids, bool async) {
+QNetworkReply::NetworkError InoreaderNetworkFactory::markMessagesRead(RootItem::ReadStatus status, const QStringList& custom_ids,
+                                                                      const QString& bearer) {
   QString target_url = INOREADER_API_EDIT_TAG;
 
   if (status == RootItem::ReadStatus::Read) {
@@ -163,15 +184,13 @@ void InoreaderNetworkFactory::markMessagesRead(RootItem::ReadStatus status, cons
     target_url += QString("?r=user/-/") + INOREADER_STATE_READ + "&";
   }
 
-  QString bearer = m_oauth2->bearer().toLocal8Bit();
-
   if (bearer.isEmpty()) {
-    return;
+    return QNetworkReply::AuthenticationRequiredError;
   }
 
   QList<QPair<QByteArray, QByteArray>> headers;
   headers.append(QPair<QByteArray, QByteArray>(QString(HTTP_HEADERS_AUTHORIZATION).toLocal8Bit(),
-                                               m_oauth2->bearer().toLocal8Bit()));
+                                               bearer.toLocal8Bit()));
 
   QStringList trimmed_ids;
   QRegularExpression regex_short_id(QSL("[0-9a-zA-Z]+$"));
@@ -185,43 +204,39 @@ void InoreaderNetworkFactory::markMessagesRead(RootItem::ReadStatus status, cons
   QStringList working_subset;
   int timeout = qApp->settings()->value(GROUP(Feeds), SETTING(Feeds::UpdateTimeout)).toInt();
 
-  working_subset.reserve(trimmed_ids.size() > 200 ? 200 : trimmed_ids.size());
+  working_subset.reserve(qMin(trimmed_ids.size(), INOREADER_MAX_EDIT_TAG_ITEMS));
 
-  // Now, we perform messages update in batches (max 200 messages per batch).
+  // Now, we perform messages update in batches.
   while (!trimmed_ids.isEmpty()) {
-    // We take 200 IDs.
-    for (int i = 0; i < 200 && !trimmed_ids.isEmpty(); i++) {
+    for (int i = 0; i < INOREADER_MAX_EDIT_TAG_ITEMS && !trimmed_ids.isEmpty(); i++) {
       working_subset.append(trimmed_ids.takeFirst());
     }
 
     QString batch_final_url = target_url + working_subset.join(QL1C('&'));
+    QByteArray output;
 
     // We send this batch.
-    if (async) {
-
-      NetworkFactory::performAsyncNetworkOperation(batch_final_url,
-                                                   timeout,
-                                                   QByteArray(),
-                                                   QNetworkAccessManager::Operation::GetOperation,
-                                                   headers);
-    }
-    else {
-      QByteArray output;
-
-      NetworkFactory::performNetworkOperation(batch_final_url,
-                                              timeout,
-                                              QByteArray(),
-                                              output,
-                                              QNetworkAccessManager::Operation::GetOperation,
-                                              headers);
+    NetworkResult network_reply = NetworkFactory::performNetworkOperation(batch_final_url,
+                                                                          timeout,
+                                                                          QByteArray(),
+                                                                          output,
+                                                                          QNetworkAccessManager::Operation::GetOperation,
+                                                                          headers);
+
+    if (network_reply.first != QNetworkReply::NoError) {
+      qWarning("Inoreader: Editing of message tags failed with error %d.", network_reply.first);
+      return network_reply.first;
     }
 
     // Cleanup for next batch.
     working_subset.clear();
   }
+
+  return QNetworkReply::NoError;
 }
 
-void InoreaderNetworkFactory::markMessagesStarred(RootItem::Importance importance, const QStringList& custom_ids, bool async) {
+QNetworkReply::NetworkError InoreaderNetworkFactory::markMessagesStarred(RootItem::Importance importance, const QStringList& custom_ids,
+                                                                         const QString& bearer) {
   QString target_url = INOREADER_API_EDIT_TAG;
 
   if (importance == RootItem::Importance::Important) {
@@ -231,15 +246,13 @@ void InoreaderNetworkFactory::markMessagesStarred(RootItem::Importance importanc
     target_url += QString("?r=user/-/") + INOREADER_STATE_IMPORTANT + "&";
   }
 
-  QString bearer = m_oauth2->bearer().toLocal8Bit();
-
   if (bearer.isEmpty()) {
-    return;
+    return QNetworkReply::AuthenticationRequiredError;
   }
 
   QList<QPair<QByteArray, QByteArray>> headers;
   headers.append(QPair<QByteArray, QByteArray>(QString(HTTP_HEADERS_AUTHORIZATION).toLocal8Bit(),
-                                               m_oauth2->bearer().toLocal8Bit()));
+                                               bearer.toLocal8Bit()));
 
   QStringList trimmed_ids;
   QRegularExpression regex_short_id(QSL("[0-9a-zA-Z]+$"));
@@ -253,40 +266,35 @@ void InoreaderNetworkFactory::markMessagesStarred(RootItem::Importance importanc
   QStringList working_subset;
   int timeout = qApp->settings()->value(GROUP(Feeds), SETTING(Feeds::UpdateTimeout)).toInt();
 
-  working_subset.reserve(trimmed_ids.size() > 200 ? 200 : trimmed_ids.size());
+  working_subset.reserve(qMin(trimmed_ids.size(), INOREADER_MAX_EDIT_TAG_ITEMS));
 
-  // Now, we perform messages update in batches (max 200 messages per batch).
+  // Now, we perform messages update in batches.
   while (!trimmed_ids.isEmpty()) {
-    // We take 200 IDs.
-    for (int i = 0; i < 200 && !trimmed_ids.isEmpty(); i++) {
+    for (int i = 0; i < INOREADER_MAX_EDIT_TAG_ITEMS && !trimmed_ids.isEmpty(); i++) {
       working_subset.append(trimmed_ids.takeFirst());
     }
 
     QString batch_final_url = target_url + working_subset.join(QL1C('&'));
+    QByteArray output;
 
     // We send this batch.
-    if (async) {
-
-      NetworkFactory::performAsyncNetworkOperation(batch_final_url,
-                                                   timeout,
-                                                   QByteArray(),
-                                                   QNetworkAccessManager::Operation::GetOperation,
-                                                   headers);
-    }
-    else {
-      QByteArray output;
-
-      NetworkFactory::performNetworkOperation(batch_final_url,
-                                              timeout,
-                                              QByteArray(),
-                                              output,
-                                              QNetworkAccessManager::Operation::GetOperation,
-                                              headers);
+    NetworkResult network_reply = NetworkFactory::performNetworkOperation(batch_final_url,
+                                                                          timeout,
+                                                                          QByteArray(),
+                                                                          output,
+                                                                          QNetworkAccessManager::Operation::GetOperation,
+                                                                          headers);
+
+    if (network_reply.first != QNetworkReply::NoError) {
+      qWarning("Inoreader: Editing of message tags failed with error %d.", network_reply.first);
+      return network_reply.first;
     }
 
     // Cleanup for next batch.
     working_subset.clear();
   }
+
+  return QNetworkReply::NoError;
 }
 
 void InoreaderNetworkFactory::onTokensError(const QString& error, const QString& error_description) {
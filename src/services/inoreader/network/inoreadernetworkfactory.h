@@ -54,9 +54,13 @@ class InoreaderNetworkFactory : public QObject {
     // Returned items do not have primary IDs assigned.
     RootItem* feedsCategories(bool obtain_icons);
 
-    QList<Message> messages(const QString& stream_id, Feed::Status& error);
-    void markMessagesRead(RootItem::ReadStatus status, const QStringList& custom_ids, bool async = true);
-    void markMessagesStarred(RootItem::Importance importance, const QStringList& custom_ids, bool async = true);
+    QList<Message> messages(const QString& stream_id, Feed::Status& error, QNetworkReply::NetworkError* network_error = nullptr);
+    // NOTE: These methods do not touch OAuth service, so they can be called from any
+    // thread. Bearer HTTP header value must be obtained in advance.
+    QNetworkReply::NetworkError markMessagesRead(RootItem::ReadStatus status, const QStringList& custom_ids,
+                                                 const QString& bearer);
+    QNetworkReply::NetworkError markMessagesStarred(RootItem::Importance importance, const QStringList& custom_ids,
+                                                    const QString& bearer);
 
   private slots:
     void onTokensError(const QString& error, const QString& error_description);
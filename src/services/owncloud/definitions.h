@@ -24,5 +24,6 @@
 #define OWNCLOUD_API_PATH             "index.php/apps/news/api/v1-2/"
 #define OWNCLOUD_MIN_VERSION          "6.0.5"
 #define OWNCLOUD_UNLIMITED_BATCH_SIZE -1
+#define OWNCLOUD_SYNC_BATCH_SIZE      1000
 
 #endif // OWNCLOUD_DEFINITIONS_H
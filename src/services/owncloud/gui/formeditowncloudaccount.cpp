@@ -19,6 +19,7 @@
 #include "services/owncloud/gui/formeditowncloudaccount.h"
 
 #include "gui/guiutilities.h"
+#include "gui/retentionpolicyedit.h"
 #include "miscellaneous/iconfactory.h"
 #include "network-web/networkfactory.h"
 #include "services/owncloud/definitions.h"
@@ -26,8 +27,10 @@
 #include "services/owncloud/owncloudserviceroot.h"
 
 FormEditOwnCloudAccount::FormEditOwnCloudAccount(QWidget* parent)
-  : QDialog(parent), m_ui(new Ui::FormEditOwnCloudAccount), m_editableRoot(nullptr) {
+  : QDialog(parent), m_ui(new Ui::FormEditOwnCloudAccount), m_editableRoot(nullptr),
+  m_retentionPolicy(new RetentionPolicyEdit(this)) {
   m_ui->setupUi(this);
+  m_ui->verticalLayout->insertWidget(m_ui->verticalLayout->indexOf(m_ui->m_buttonBox), m_retentionPolicy);
   m_btnOk = m_ui->m_buttonBox->button(QDialogButtonBox::Ok);
 
   GuiUtilities::applyDialogProperties(*this, qApp->icons()->fromTheme(QSL("owncloud")));
@@ -65,7 +68,8 @@ FormEditOwnCloudAccount::FormEditOwnCloudAccount(QWidget* parent)
   setTabOrder(m_ui->m_txtUsername->lineEdit(), m_ui->m_txtPassword->lineEdit());
   setTabOrder(m_ui->m_txtPassword->lineEdit(), m_ui->m_checkShowPassword);
   setTabOrder(m_ui->m_checkShowPassword, m_ui->m_btnTestSetup);
-  setTabOrder(m_ui->m_btnTestSetup, m_ui->m_buttonBox);
+  setTabOrder(m_ui->m_btnTestSetup, m_retentionPolicy);
+  setTabOrder(m_retentionPolicy, m_ui->m_buttonBox);
 
   connect(m_ui->m_checkShowPassword, &QCheckBox::toggled, this, &FormEditOwnCloudAccount::displayPassword);
   connect(m_ui->m_buttonBox, &QDialogButtonBox::accepted, this, &FormEditOwnCloudAccount::onClickedOk);
@@ -102,6 +106,7 @@ void FormEditOwnCloudAccount::execForEdit(OwnCloudServiceRoot* existing_root) {
   m_ui->m_txtUrl->lineEdit()->setText(existing_root->network()->url());
   m_ui->m_checkServerSideUpdate->setChecked(existing_root->network()->forceServerSideUpdate());
   m_ui->m_spinLimitMessages->setValue(existing_root->network()->batchSize());
+  m_retentionPolicy->loadPolicy(existing_root->accountId(), QString());
 
   exec();
 }
@@ -166,6 +171,7 @@ void FormEditOwnCloudAccount::onClickedOk() {
   m_editableRoot->network()->setForceServerSideUpdate(m_ui->m_checkServerSideUpdate->isChecked());
   m_editableRoot->network()->setBatchSize(m_ui->m_spinLimitMessages->value());
   m_editableRoot->saveAccountDataToDatabase();
+  m_retentionPolicy->savePolicy(m_editableRoot->accountId(), QString());
   accept();
 
   if (editing_account) {
@@ -28,6 +28,7 @@ namespace Ui {
 }
 
 class OwnCloudServiceRoot;
+class RetentionPolicyEdit;
 
 class FormEditOwnCloudAccount : public QDialog {
   Q_OBJECT
@@ -54,7 +55,7 @@ class FormEditOwnCloudAccount : public QDialog {
   private:
     QScopedPointer<Ui::FormEditOwnCloudAccount> m_ui;
     OwnCloudServiceRoot* m_editableRoot;
-    QPushButton* m_btnOk;
+    QPushButton* m_btnOk;    RetentionPolicyEdit* m_retentionPolicy;
 };
 
 #endif // FORMEDITOWNCLOUDACCOUNT_H
@@ -18,6 +18,7 @@
 
 #include "services/owncloud/gui/formowncloudfeeddetails.h"
 
+#include "gui/retentionpolicyedit.h"
 #include "miscellaneous/application.h"
 #include "services/owncloud/network/owncloudnetworkfactory.h"
 #include "services/owncloud/owncloudfeed.h"
@@ -36,6 +37,9 @@ FormOwnCloudFeedDetails::FormOwnCloudFeedDetails(ServiceRoot* service_root, QWid
   m_ui->m_txtTitle->setEnabled(false);
   m_ui->m_txtUrl->setEnabled(true);
   m_ui->m_txtDescription->setEnabled(false);
+
+  // Feed gets its ID after next sync, so policy can be set only for existing feeds.
+  m_retentionPolicy->setEnabled(false);
 }
 
 void FormOwnCloudFeedDetails::apply() {
@@ -60,6 +64,7 @@ void FormOwnCloudFeedDetails::apply() {
     new_feed_data->setAutoUpdateInitialInterval(m_ui->m_spinAutoUpdateInterval->value());
     qobject_cast<OwnCloudFeed*>(m_editableFeed)->editItself(new_feed_data);
     delete new_feed_data;
+    saveRetentionPolicy(m_editableFeed);
 
     if (renamed) {
       QTimer::singleShot(200, m_serviceRoot, SLOT(syncIn()));
@@ -91,6 +96,7 @@ void FormOwnCloudFeedDetails::apply() {
 
 void FormOwnCloudFeedDetails::setEditableFeed(Feed* editable_feed) {
   m_ui->m_cmbAutoUpdateType->setEnabled(true);
+  m_retentionPolicy->setEnabled(true);
   FormFeedDetails::setEditableFeed(editable_feed);
   m_ui->m_txtTitle->setEnabled(true);
   m_ui->m_gbAuthentication->setEnabled(false);
@@ -25,6 +25,7 @@
 #include "services/owncloud/owncloudserviceroot.h"
 
 #include <QPointer>
+#include <QUrl>
 
 OwnCloudFeed::OwnCloudFeed(RootItem* parent) : Feed(parent) {}
 
@@ -82,10 +83,17 @@ OwnCloudServiceRoot* OwnCloudFeed::serviceRoot() const {
   return qobject_cast<OwnCloudServiceRoot*>(getParentServiceRoot());
 }
 
+QString OwnCloudFeed::updateHost() const {
+  // Messages are obtained from Nextcloud server, not from the feed itself.
+  return QUrl(serviceRoot()->network()->url()).host().toLower();
+}
+
 QList<Message> OwnCloudFeed::obtainNewMessages(bool* error_during_obtaining) {
   OwnCloudGetMessagesResponse messages = serviceRoot()->network()->getMessages(customNumericId());
 
-  if (serviceRoot()->network()->lastError() != QNetworkReply::NoError) {
+  m_updateMetrics.m_networkError = serviceRoot()->network()->lastError();
+
+  if (m_updateMetrics.m_networkError != QNetworkReply::NoError) {
     setStatus(Feed::NetworkError);
     *error_during_obtaining = true;
     serviceRoot()->itemChanged(QList<RootItem*>() << this);
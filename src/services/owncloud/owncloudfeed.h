@@ -40,6 +40,7 @@ class OwnCloudFeed : public Feed {
     bool removeItself();
 
     OwnCloudServiceRoot* serviceRoot() const;
+    QString updateHost() const;
 
   private:
     QList<Message> obtainNewMessages(bool* error_during_obtaining);
@@ -25,6 +25,7 @@
 #include "miscellaneous/mutex.h"
 #include "miscellaneous/textfactory.h"
 #include "services/abstract/recyclebin.h"
+#include "services/owncloud/definitions.h"
 #include "services/owncloud/gui/formeditowncloudaccount.h"
 #include "services/owncloud/gui/formowncloudfeeddetails.h"
 #include "services/owncloud/network/owncloudnetworkfactory.h"
@@ -38,6 +39,7 @@ OwnCloudServiceRoot::OwnCloudServiceRoot(RootItem* parent)
 }
 
 OwnCloudServiceRoot::~OwnCloudServiceRoot() {
+  abortSynchronization();
   delete m_network;
 }
 
@@ -106,41 +108,23 @@ OwnCloudNetworkFactory* OwnCloudServiceRoot::network() const {
   return m_network;
 }
 
-void OwnCloudServiceRoot::saveAllCachedData(bool async) {
-  QPair<QMap<RootItem::ReadStatus, QStringList>, QMap<RootItem::Importance, QList<Message>>> msgCache = takeMessageCache();
-  QMapIterator<RootItem::ReadStatus, QStringList> i(msgCache.first);
+QNetworkReply::NetworkError OwnCloudServiceRoot::sendReadStatesToService(RootItem::ReadStatus read, const QStringList& custom_ids) {
+  return network()->markMessagesRead(read, custom_ids);
+}
 
-  // Save the actual data read/unread.
-  while (i.hasNext()) {
-    i.next();
-    auto key = i.key();
-    QStringList ids = i.value();
+QNetworkReply::NetworkError OwnCloudServiceRoot::sendImportanceStatesToService(RootItem::Importance importance, const QList<Message>& messages) {
+  QStringList feed_ids, guid_hashes;
 
-    if (!ids.isEmpty()) {
-      network()->markMessagesRead(key, ids, async);
-    }
+  foreach (const Message& msg, messages) {
+    feed_ids.append(msg.m_feedId);
+    guid_hashes.append(msg.m_customHash);
   }
 
-  QMapIterator<RootItem::Importance, QList<Message>> j(msgCache.second);
-
-  // Save the actual data important/not important.
-  while (j.hasNext()) {
-    j.next();
-    auto key = j.key();
-
-    QList<Message> messages = j.value();
-
-    if (!messages.isEmpty()) {
-      QStringList feed_ids, guid_hashes;
-
-      foreach (const Message& msg, messages) {
-        feed_ids.append(msg.m_feedId);
-        guid_hashes.append(msg.m_customHash);
-      }
+  return network()->markMessagesStarred(importance, feed_ids, guid_hashes);
+}
 
-      network()->markMessagesStarred(key, feed_ids, guid_hashes, async);
-    }
-  }
+int OwnCloudServiceRoot::syncBatchSize() const {
+  return OWNCLOUD_SYNC_BATCH_SIZE;
 }
 
 void OwnCloudServiceRoot::updateTitle() {
@@ -50,7 +50,9 @@ class OwnCloudServiceRoot : public ServiceRoot, public CacheForServiceRoot {
     void updateTitle();
     void saveAccountDataToDatabase();
 
-    void saveAllCachedData(bool async = true);
+    QNetworkReply::NetworkError sendReadStatesToService(RootItem::ReadStatus read, const QStringList& custom_ids);
+    QNetworkReply::NetworkError sendImportanceStatesToService(RootItem::Importance importance, const QList<Message>& messages);
+    int syncBatchSize() const;
 
   public slots:
     void addNewFeed(const QString& url);
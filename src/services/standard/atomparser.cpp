@@ -19,12 +19,13 @@
 #include "services/standard/atomparser.h"
 
 #include "miscellaneous/application.h"
+#include "miscellaneous/debugging.h"
 #include "miscellaneous/textfactory.h"
 #include "network-web/webfactory.h"
 
 #include "exceptions/applicationexception.h"
 
-AtomParser::AtomParser(const QString& data) : FeedParser(data) {
+AtomParser::AtomParser(const QByteArray& data, const QString& fallback_encoding) : FeedParser(data, fallback_encoding) {
   QString version = m_xml.documentElement().attribute(QSL("version"));
 
   if (version == QSL("0.3")) {
@@ -100,7 +101,7 @@ Message AtomParser::extractMessage(const QDomElement& msg_element, QDateTime cur
 
     if (attribute == QSL("enclosure")) {
       new_message.m_enclosures.append(Enclosure(link.attribute(QSL("href")), link.attribute(QSL("type"))));
-      qDebug("Adding enclosure '%s' for the message.", qPrintable(new_message.m_enclosures.last().m_url));
+      qCDebugHot(LOG_PARSER, "Adding enclosure '%s' for the message.", qPrintable(new_message.m_enclosures.last().m_url));
     }
     else if (attribute.isEmpty() || attribute == QSL("alternate")) {
       last_link_alternate = link.attribute(QSL("href"));
@@ -28,7 +28,7 @@
 
 class AtomParser : public FeedParser {
   public:
-    explicit AtomParser(const QString& data);
+    explicit AtomParser(const QByteArray& data, const QString& fallback_encoding = QString());
     virtual ~AtomParser();
 
   private:
@@ -21,9 +21,10 @@
 #include "exceptions/applicationexception.h"
 
 #include <QDebug>
+#include <QTextCodec>
 
-FeedParser::FeedParser(const QString& data) : m_xmlData(data) {
-  m_xml.setContent(m_xmlData, true);
+FeedParser::FeedParser(const QByteArray& data, const QString& fallback_encoding) {
+  loadXml(m_xml, data, fallback_encoding, true);
 }
 
 FeedParser::~FeedParser() {}
@@ -97,6 +98,110 @@ QStringList FeedParser::textsFromPath(const QDomElement& element, const QString&
   return result;
 }
 
+QString FeedParser::documentEncoding(const QByteArray& data) {
+  if (data.startsWith("\xEF\xBB\xBF")) {
+    return QSL("UTF-8");
+  }
+  else if (data.startsWith("\xFE\xFF")) {
+    return QSL("UTF-16BE");
+  }
+  else if (data.startsWith("\xFF\xFE")) {
+    return QSL("UTF-16LE");
+  }
+
+  // Only the XML declaration at the very beginning of the document is inspected.
+  if (!data.startsWith("<?xml")) {
+    return QString();
+  }
+
+  const int declaration_end = data.indexOf("?>");
+
+  if (declaration_end < 0) {
+    return QString();
+  }
+
+  const QByteArray declaration = QByteArray::fromRawData(data.constData(), declaration_end);
+  int position = declaration.indexOf("encoding");
+
+  if (position < 0) {
+    return QString();
+  }
+
+  position = declaration.indexOf('=', position);
+
+  if (position < 0) {
+    return QString();
+  }
+
+  while (++position < declaration.size() && (declaration.at(position) == ' ' || declaration.at(position) == '\t')) {}
+
+  if (position >= declaration.size() || (declaration.at(position) != '"' && declaration.at(position) != '\'')) {
+    return QString();
+  }
+
+  const int value_end = declaration.indexOf(declaration.at(position), position + 1);
+
+  if (value_end < 0) {
+    return QString();
+  }
+
+  return QString::fromLatin1(declaration.mid(position + 1, value_end - position - 1)).trimmed();
+}
+
+QString FeedParser::contentTypeEncoding(const QString& content_type) {
+  foreach (const QString& parameter, content_type.split(QL1C(';'), QString::SkipEmptyParts)) {
+    const QString trimmed_parameter = parameter.trimmed();
+
+    if (trimmed_parameter.startsWith(QL1S("charset="), Qt::CaseInsensitive)) {
+      QString charset = trimmed_parameter.mid(8).trimmed();
+
+      charset.remove(QL1C('"'));
+      charset.remove(QL1C('\''));
+      return charset;
+    }
+  }
+
+  return QString();
+}
+
+QByteArray FeedParser::declareEncoding(const QByteArray& data, const QString& encoding) {
+  if (data.startsWith("\xEF\xBB\xBF") || data.startsWith("\xFE\xFF") || data.startsWith("\xFF\xFE")) {
+    return data;
+  }
+
+  // Original declaration is replaced.
+  int body_start = 0;
+
+  if (data.startsWith("<?xml")) {
+    const int declaration_end = data.indexOf("?>");
+
+    body_start = declaration_end < 0 ? 0 : declaration_end + 2;
+  }
+
+  QByteArray declared_data;
+
+  declared_data.reserve(data.size() - body_start + 64);
+  declared_data.append("<?xml version=\"1.0\" encoding=\"");
+  declared_data.append(encoding.toLatin1());
+  declared_data.append("\"?>");
+  declared_data.append(data.constData() + body_start, data.size() - body_start);
+  return declared_data;
+}
+
+bool FeedParser::loadXml(QDomDocument& xml, const QByteArray& data, const QString& fallback_encoding,
+                         bool namespace_processing, QString* error_msg, int* error_line, int* error_column) {
+  if (!documentEncoding(data).isEmpty() || fallback_encoding.isEmpty() ||
+      fallback_encoding.compare(QL1S("UTF-8"), Qt::CaseInsensitive) == 0 ||
+      QTextCodec::codecForName(fallback_encoding.toLatin1()) == nullptr) {
+    // XML reader decodes the document itself.
+    return xml.setContent(data, namespace_processing, error_msg, error_line, error_column);
+  }
+
+  // Document does not declare its encoding, so we declare it, still
+  // without decoding whole document.
+  return xml.setContent(declareEncoding(data, fallback_encoding), namespace_processing, error_msg, error_line, error_column);
+}
+
 QString FeedParser::feedAuthor() const {
   return "";
 }
@@ -26,11 +26,32 @@
 
 class FeedParser {
   public:
-    explicit FeedParser(const QString& data);
+    // Parsers consume raw downloaded bytes, only extracted text fields are decoded.
+    // Fallback encoding is used only if document does not specify its own encoding.
+    explicit FeedParser(const QByteArray& data, const QString& fallback_encoding = QString());
     virtual ~FeedParser();
 
     virtual QList<Message> messages();
 
+    // Detects encoding of XML document from its BOM or XML declaration.
+    // Returns empty string if document does not specify its encoding.
+    static QString documentEncoding(const QByteArray& data);
+
+    // Extracts "charset" parameter from HTTP Content-Type header value.
+    static QString contentTypeEncoding(const QString& content_type);
+
+    // Returns XML data with its declaration replaced by one which declares given encoding,
+    // so that XML reader decodes the document with it. Documents which start with
+    // byte order mark are returned unchanged.
+    static QByteArray declareEncoding(const QByteArray& data, const QString& encoding);
+
+    // Loads raw XML data into DOM document. If the document does not specify its
+    // encoding, then fallback encoding is declared for it, so that XML reader
+    // decodes it, default XML encoding (UTF-8) is used otherwise.
+    static bool loadXml(QDomDocument& xml, const QByteArray& data, const QString& fallback_encoding,
+                        bool namespace_processing, QString* error_msg = nullptr,
+                        int* error_line = nullptr, int* error_column = nullptr);
+
   protected:
     QStringList textsFromPath(const QDomElement& element, const QString& namespace_uri, const QString& xml_path, bool only_first) const;
     virtual QDomNodeList messageElements() = 0;
@@ -38,7 +59,6 @@ class FeedParser {
     virtual Message extractMessage(const QDomElement& msg_element, QDateTime current_time) const = 0;
 
   protected:
-    QString m_xmlData;
     QDomDocument m_xml;
 };
 
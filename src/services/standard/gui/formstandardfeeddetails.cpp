@@ -49,6 +49,7 @@ void FormStandardFeedDetails::apply() {
   if (m_editableFeed == nullptr) {
     // Add the feed.
     if (new_feed->addItself(parent)) {
+      saveRetentionPolicy(new_feed);
       m_serviceRoot->requestItemReassignment(new_feed, parent);
       accept();
     }
@@ -66,6 +67,7 @@ void FormStandardFeedDetails::apply() {
     bool edited = qobject_cast<StandardFeed*>(m_editableFeed)->editItself(new_feed);
 
     if (edited) {
+      saveRetentionPolicy(m_editableFeed);
       m_serviceRoot->requestItemReassignment(m_editableFeed, new_feed->parent());
       accept();
     }
@@ -45,6 +45,10 @@ FormStandardImportExport::FormStandardImportExport(StandardServiceRoot* service_
   m_ui->m_lblResult->setStatus(WidgetWithStatus::Warning, tr("No operation executed yet."), tr("No operation executed yet."));
   connect(m_ui->m_buttonBox->button(QDialogButtonBox::Ok), &QPushButton::clicked, this, &FormStandardImportExport::performAction);
   connect(m_ui->m_btnSelectFile, &QPushButton::clicked, this, &FormStandardImportExport::selectFile);
+  m_btnStopFetching = m_ui->m_buttonBox->addButton(tr("&Stop fetching metadata"), QDialogButtonBox::ActionRole);
+  m_btnStopFetching->setVisible(false);
+  connect(m_btnStopFetching, &QPushButton::clicked, m_model, &FeedsImportExportModel::cancelMetadataFetching);
+  connect(this, &FormStandardImportExport::rejected, m_model, &FeedsImportExportModel::cancelMetadataFetching);
   connect(m_ui->m_btnCheckAllItems, &QPushButton::clicked, m_model, &FeedsImportExportModel::checkAllItems);
   connect(m_ui->m_btnUncheckAllItems, &QPushButton::clicked, m_model, &FeedsImportExportModel::uncheckAllItems);
 }
@@ -117,6 +121,7 @@ void FormStandardImportExport::onParsingStarted() {
 void FormStandardImportExport::onParsingFinished(int count_failed, int count_succeeded, bool parsing_error) {
   Q_UNUSED(count_failed)
   Q_UNUSED(count_succeeded)
+  m_btnStopFetching->setVisible(false);
   m_ui->m_progressBar->setVisible(false);
   m_ui->m_progressBar->setValue(0);
   m_model->checkAllItems();
@@ -138,6 +143,11 @@ void FormStandardImportExport::onParsingFinished(int count_failed, int count_suc
 }
 
 void FormStandardImportExport::onParsingProgress(int completed, int total) {
+  if (m_model->isFetchingMetadata() && !m_btnStopFetching->isVisible()) {
+    m_ui->m_lblResult->setStatus(WidgetWithStatus::Progress, tr("Fetching metadata..."), tr("Fetching metadata..."));
+    m_btnStopFetching->setVisible(true);
+  }
+
   m_ui->m_progressBar->setMaximum(total);
   m_ui->m_progressBar->setValue(completed);
 }
@@ -202,8 +212,8 @@ void FormStandardImportExport::selectImportFile() {
     QMessageBox::StandardButton answer = MessageBox::show(this,
                                                           QMessageBox::Warning,
                                                           tr("Get online metadata"),
-                                                          tr("Metadata for your feeds can be fetched online. Note that the action "
-                                                             "could take several minutes, depending on number of feeds."),
+                                                          tr("Metadata for your feeds can be fetched online. Several feeds are processed "
+                                                             "at once, but the action could still take a while, depending on number of feeds."),
                                                           tr("Do you want to fetch feed metadata online?"),
                                                           QString(),
                                                           QMessageBox::Yes | QMessageBox::No,
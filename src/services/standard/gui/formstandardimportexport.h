@@ -65,6 +65,7 @@ class FormStandardImportExport : public QDialog {
     void loadCategories(const QList<Category*> categories, RootItem* root_item);
 
     QScopedPointer<Ui::FormStandardImportExport> m_ui;
+    QPushButton* m_btnStopFetching;
     ConversionType m_conversionType;
     FeedsImportExportModel* m_model;
     StandardServiceRoot* m_serviceRoot;
@@ -28,12 +28,12 @@ RdfParser::RdfParser() {}
 
 RdfParser::~RdfParser() {}
 
-QList<Message> RdfParser::parseXmlData(const QString& data) {
+QList<Message> RdfParser::parseXmlData(const QByteArray& data, const QString& fallback_encoding) {
   QList<Message> messages;
   QDomDocument xml_file;
   QDateTime current_time = QDateTime::currentDateTime();
 
-  xml_file.setContent(data, true);
+  FeedParser::loadXml(xml_file, data, fallback_encoding, true);
 
   // Pull out all messages.
   QDomNodeList messages_in_xml = xml_file.elementsByTagName(QSL("item"));
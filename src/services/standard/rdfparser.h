@@ -28,7 +28,7 @@ class RdfParser {
     explicit RdfParser();
     virtual ~RdfParser();
 
-    QList<Message> parseXmlData(const QString& data);
+    QList<Message> parseXmlData(const QByteArray& data, const QString& fallback_encoding = QString());
 };
 
 #endif // RDFPARSER_H
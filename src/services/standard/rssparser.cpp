@@ -20,13 +20,14 @@
 
 #include "exceptions/applicationexception.h"
 #include "miscellaneous/application.h"
+#include "miscellaneous/debugging.h"
 #include "miscellaneous/iofactory.h"
 #include "miscellaneous/textfactory.h"
 #include "network-web/webfactory.h"
 
 #include <QDomDocument>
 
-RssParser::RssParser(const QString& data) : FeedParser(data) {}
+RssParser::RssParser(const QByteArray& data, const QString& fallback_encoding) : FeedParser(data, fallback_encoding) {}
 
 RssParser::~RssParser() {}
 
@@ -74,7 +75,7 @@ Message RssParser::extractMessage(const QDomElement& msg_element, QDateTime curr
 
   if (!elem_enclosure.isEmpty()) {
     new_message.m_enclosures.append(Enclosure(elem_enclosure, elem_enclosure_type));
-    qDebug("Adding enclosure '%s' for the message.", qPrintable(elem_enclosure));
+    qCDebugHot(LOG_PARSER, "Adding enclosure '%s' for the message.", qPrintable(elem_enclosure));
   }
 
   // Deal with link and author.
@@ -27,7 +27,7 @@
 
 class RssParser : public FeedParser {
   public:
-    explicit RssParser(const QString& data);
+    explicit RssParser(const QByteArray& data, const QString& fallback_encoding = QString());
     virtual ~RssParser();
 
   private:
@@ -113,8 +113,11 @@ bool StandardCategory::removeItself() {
 }
 
 bool StandardCategory::addItself(RootItem* parent) {
+  return addItself(parent, qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings));
+}
+
+bool StandardCategory::addItself(RootItem* parent, QSqlDatabase database) {
   // Now, add category to persistent storage.
-  QSqlDatabase database = qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings);
   int new_id = DatabaseQueries::addCategory(database, parent->id(), parent->getParentServiceRoot()->accountId(),
                                             title(), description(), creationDate(), icon());
 
@@ -22,6 +22,7 @@
 #include "services/abstract/category.h"
 
 #include <QCoreApplication>
+#include <QSqlDatabase>
 #include <QSqlRecord>
 
 class FeedsModel;
@@ -52,6 +53,7 @@ class StandardCategory : public Category {
     bool deleteViaGui();
 
     bool addItself(RootItem* parent);
+    bool addItself(RootItem* parent, QSqlDatabase database);
     bool editItself(StandardCategory* new_category_data);
     bool removeItself();
 };
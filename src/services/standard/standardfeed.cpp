@@ -23,6 +23,7 @@
 #include "gui/feedmessageviewer.h"
 #include "gui/feedsview.h"
 #include "miscellaneous/databasequeries.h"
+#include "miscellaneous/debugging.h"
 #include "miscellaneous/iconfactory.h"
 #include "miscellaneous/settings.h"
 #include "miscellaneous/simplecrypt/simplecrypt.h"
@@ -38,6 +39,7 @@
 #include <QDomDocument>
 #include <QDomElement>
 #include <QDomNode>
+#include <QElapsedTimer>
 #include <QPointer>
 #include <QTextCodec>
 #include <QVariant>
@@ -72,11 +74,11 @@ QList<QAction*> StandardFeed::contextMenu() {
 }
 
 QString StandardFeed::additionalTooltip() const {
-  return Feed::additionalTooltip() + tr("Network status: %1\n"
-                                        "Encoding: %2\n"
-                                        "Type: %3").arg(NetworkFactory::networkErrorText(m_networkError),
-                                                        encoding(),
-                                                        StandardFeed::typeToString(type()));
+  return Feed::additionalTooltip() + QL1C('\n') + tr("Network status: %1\n"
+                                                       "Encoding: %2\n"
+                                                       "Type: %3").arg(NetworkFactory::networkErrorText(m_networkError),
+                                                                       encoding(),
+                                                                       StandardFeed::typeToString(type()));
 }
 
 bool StandardFeed::canBeEdited() const {
@@ -152,7 +154,8 @@ void StandardFeed::fetchMetadataForItself() {
 
 QPair<StandardFeed*, QNetworkReply::NetworkError> StandardFeed::guessFeed(const QString& url,
                                                                           const QString& username,
-                                                                          const QString& password) {
+                                                                          const QString& password,
+                                                                          QByteArray* icon_data) {
   QPair<StandardFeed*, QNetworkReply::NetworkError> result;
   result.first = nullptr;
   QByteArray feed_contents;
@@ -173,34 +176,24 @@ QPair<StandardFeed*, QNetworkReply::NetworkError> StandardFeed::guessFeed(const
   if (result.second == QNetworkReply::NoError || !feed_contents.isEmpty()) {
     // Feed XML was obtained, now we need to try to guess
     // its encoding before we can read further data.
-    QString xml_schema_encoding;
-    QString xml_contents_encoded;
-    QRegExp encoding_rexp(QSL("encoding=\"[^\"]\\S+\""));
-
-    if (encoding_rexp.indexIn(feed_contents) != -1 &&
-        !(xml_schema_encoding = encoding_rexp.cap(0)).isEmpty()) {
-      // Some "encoding" attribute was found get the encoding
-      // out of it.
-      encoding_rexp.setPattern(QSL("[^\"]\\S+[^\"]"));
-      encoding_rexp.indexIn(xml_schema_encoding, 9);
-      xml_schema_encoding = encoding_rexp.cap(0);
+    QString xml_schema_encoding = FeedParser::documentEncoding(feed_contents);
+
+    if (xml_schema_encoding.isEmpty()) {
+      xml_schema_encoding = FeedParser::contentTypeEncoding(network_result.second.toString());
     }
 
     if (result.first == nullptr) {
       result.first = new StandardFeed();
     }
 
-    QTextCodec* custom_codec = QTextCodec::codecForName(xml_schema_encoding.toLocal8Bit());
-
-    if (custom_codec != nullptr) {
+    if (QTextCodec::codecForName(xml_schema_encoding.toLatin1()) != nullptr) {
       // Feed encoding was probably guessed.
-      xml_contents_encoded = custom_codec->toUnicode(feed_contents);
       result.first->setEncoding(xml_schema_encoding);
     }
     else {
       // Feed encoding probably not guessed, set it as
       // default.
-      xml_contents_encoded = feed_contents;
+      xml_schema_encoding.clear();
       result.first->setEncoding(DEFAULT_FEED_ENCODING);
     }
 
@@ -209,10 +202,13 @@ QPair<StandardFeed*, QNetworkReply::NetworkError> StandardFeed::guessFeed(const
     QString error_msg;
     int error_line, error_column;
 
-    if (!xml_document.setContent(xml_contents_encoded,
-                                 &error_msg,
-                                 &error_line,
-                                 &error_column)) {
+    if (!FeedParser::loadXml(xml_document,
+                             feed_contents,
+                             xml_schema_encoding,
+                             false,
+                             &error_msg,
+                             &error_line,
+                             &error_column)) {
       qDebug("XML of feed '%s' is not valid and cannot be loaded. Error: '%s' "
              "(line %d, column %d).",
              qPrintable(url),
@@ -282,13 +278,19 @@ QPair<StandardFeed*, QNetworkReply::NetworkError> StandardFeed::guessFeed(const
     }
 
     // Try to obtain icon.
-    QIcon icon_data;
+    if (icon_data != nullptr) {
+      // Icon is built by caller.
+      result.second = NetworkFactory::downloadIcon(icon_possible_locations, DOWNLOAD_TIMEOUT, *icon_data);
+    }
+    else {
+      QIcon icon;
 
-    if ((result.second = NetworkFactory::downloadIcon(icon_possible_locations,
-                                                      DOWNLOAD_TIMEOUT,
-                                                      icon_data)) == QNetworkReply::NoError) {
-      // Icon for feed was downloaded and is stored now in _icon_data.
-      result.first->setIcon(icon_data);
+      if ((result.second = NetworkFactory::downloadIcon(icon_possible_locations,
+                                                        DOWNLOAD_TIMEOUT,
+                                                        icon)) == QNetworkReply::NoError) {
+        // Icon for feed was downloaded and is stored now in icon.
+        result.first->setIcon(icon);
+      }
     }
   }
 
@@ -322,8 +324,11 @@ bool StandardFeed::removeItself() {
 }
 
 bool StandardFeed::addItself(RootItem* parent) {
+  return addItself(parent, qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings));
+}
+
+bool StandardFeed::addItself(RootItem* parent, QSqlDatabase database) {
   // Now, add feed to persistent storage.
-  QSqlDatabase database = qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings);
   bool ok;
   int new_id = DatabaseQueries::addFeed(database, parent->id(), parent->getParentServiceRoot()->accountId(), title(),
                                         description(), creationDate(), icon(), encoding(), url(), passwordProtected(),
@@ -370,6 +375,9 @@ bool StandardFeed::editItself(StandardFeed* new_feed_data) {
   original_feed->setAutoUpdateInitialInterval(new_feed_data->autoUpdateInitialInterval());
   original_feed->setType(new_feed_data->type());
 
+  // Changed URL, encoding or type may produce different messages from the same payload.
+  original_feed->resetPayloadFingerprint();
+
   // Editing is done.
   return true;
 }
@@ -419,14 +427,30 @@ QList<Message> StandardFeed::obtainNewMessages(bool* error_during_obtaining) {
   int download_timeout = qApp->settings()->value(GROUP(Feeds), SETTING(Feeds::UpdateTimeout)).toInt();
 
   QList<QPair<QByteArray, QByteArray>> headers;
+  NetworkOperationInfo network_info;
+  QElapsedTimer phase_timer;
+
   headers << NetworkFactory::generateBasicAuthHeader(username(), password());
+  phase_timer.start();
+
+  NetworkResult network_result = NetworkFactory::performNetworkOperation(url(),
+                                                                         download_timeout,
+                                                                         QByteArray(),
+                                                                         feed_contents,
+                                                                         QNetworkAccessManager::GetOperation,
+                                                                         headers,
+                                                                         false,
+                                                                         QString(),
+                                                                         QString(),
+                                                                         &network_info);
 
-  m_networkError = NetworkFactory::performNetworkOperation(url(),
-                                                           download_timeout,
-                                                           QByteArray(),
-                                                           feed_contents,
-                                                           QNetworkAccessManager::GetOperation,
-                                                           headers).first;
+  m_networkError = network_result.first;
+  m_updateMetrics.m_networkError = m_networkError;
+
+  m_updateMetrics.m_networkTime = phase_timer.restart();
+  m_updateMetrics.m_httpStatusCode = network_info.m_httpStatusCode;
+  m_updateMetrics.m_redirectCount = network_info.m_redirectCount;
+  m_updateMetrics.m_bytesReceived = network_info.m_bytesReceived;
 
   if (m_networkError != QNetworkReply::NoError) {
     qWarning("Error during fetching of new messages for feed '%s' (id %d).", qPrintable(url()), id());
@@ -438,40 +462,69 @@ QList<Message> StandardFeed::obtainNewMessages(bool* error_during_obtaining) {
     *error_during_obtaining = false;
   }
 
-  // Encode downloaded data for further parsing.
-  QTextCodec* codec = QTextCodec::codecForName(encoding().toLocal8Bit());
-  QString formatted_feed_contents;
+  // Many servers do not send cache validators and return the same body
+  // between refreshes, there is nothing new to parse and store then.
+  if (isPayloadUnchanged(feed_contents)) {
+    qCDebugHot(LOG_FEEDS, "Payload of feed '%s' (id %d) did not change since last update.", qPrintable(url()), id());
+    m_updateMetrics.m_unchangedPayload = true;
+    return QList<Message>();
+  }
+
+  // Downloaded data are not decoded as a whole, parsers read raw bytes and
+  // decode only text fields. Non-default encoding explicitly configured for this
+  // feed is authoritative, only BOM of the document overrides it. Otherwise encoding
+  // declared by document itself takes precedence, then charset from HTTP header.
+  QString fallback_encoding;
 
-  if (codec == nullptr) {
-    // No suitable codec for this encoding was found.
-    // Use non-converted data.
-    formatted_feed_contents = feed_contents;
+  if (encoding().compare(QL1S(DEFAULT_FEED_ENCODING), Qt::CaseInsensitive) != 0 &&
+      QTextCodec::codecForName(encoding().toLatin1()) != nullptr) {
+    feed_contents = FeedParser::declareEncoding(feed_contents, encoding());
   }
   else {
-    formatted_feed_contents = codec->toUnicode(feed_contents);
+    fallback_encoding = FeedParser::contentTypeEncoding(network_result.second.toString());
+
+    if (fallback_encoding.isEmpty()) {
+      fallback_encoding = encoding();
+    }
   }
 
-  // Feed data are downloaded and encoded.
+  m_updateMetrics.m_decodingTime = phase_timer.restart();
+
+  // Feed data are downloaded.
   // Parse data and obtain messages.
   QList<Message> messages;
 
   switch (type()) {
     case StandardFeed::Rss0X:
-    case StandardFeed::Rss2X:
-      messages = RssParser(formatted_feed_contents).messages();
+    case StandardFeed::Rss2X: {
+      ScopedTiming timing("RssParser::messages");
+
+      messages = RssParser(feed_contents, fallback_encoding).messages();
+      timing.setItems(messages.size());
       break;
+    }
 
-    case StandardFeed::Rdf:
-      messages = RdfParser().parseXmlData(formatted_feed_contents);
+    case StandardFeed::Rdf: {
+      ScopedTiming timing("RdfParser::parseXmlData");
+
+      messages = RdfParser().parseXmlData(feed_contents, fallback_encoding);
+      timing.setItems(messages.size());
       break;
+    }
 
-    case StandardFeed::Atom10:
-      messages = AtomParser(formatted_feed_contents).messages();
+    case StandardFeed::Atom10: {
+      ScopedTiming timing("AtomParser::messages");
+
+      messages = AtomParser(feed_contents, fallback_encoding).messages();
+      timing.setItems(messages.size());
+      break;
+    }
 
     default:
       break;
   }
 
+  m_updateMetrics.m_parsingTime = phase_timer.elapsed();
   return messages;
 }
 
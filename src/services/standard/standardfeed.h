@@ -26,6 +26,7 @@
 #include <QMetaType>
 #include <QNetworkReply>
 #include <QPair>
+#include <QSqlDatabase>
 #include <QSqlRecord>
 
 class StandardServiceRoot;
@@ -66,6 +67,7 @@ class StandardFeed : public Feed {
     bool performDragDropChange(RootItem* target_item);
 
     bool addItself(RootItem* parent);
+    bool addItself(RootItem* parent, QSqlDatabase database);
     bool editItself(StandardFeed* new_feed_data);
     bool removeItself();
 
@@ -88,9 +90,12 @@ class StandardFeed : public Feed {
     // Returns pointer to guessed feed (if at least partially
     // guessed) and retrieved error/status code from network layer
     // or NULL feed.
+    // If "icon_data" is given, raw icon is stored into it instead of being set
+    // to the feed, so that the method can be called outside of GUI thread.
     static QPair<StandardFeed*, QNetworkReply::NetworkError> guessFeed(const QString& url,
                                                                        const QString& username = QString(),
-                                                                       const QString& password = QString());
+                                                                       const QString& password = QString(),
+                                                                       QByteArray* icon_data = nullptr);
 
     // Converts particular feed type to string.
     static QString typeToString(Type type);
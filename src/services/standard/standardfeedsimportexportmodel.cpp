@@ -20,7 +20,9 @@
 
 #include "definitions/definitions.h"
 #include "miscellaneous/application.h"
+#include "miscellaneous/cancellationtoken.h"
 #include "miscellaneous/iconfactory.h"
+#include "miscellaneous/settings.h"
 #include "services/standard/standardcategory.h"
 #include "services/standard/standardfeed.h"
 #include "services/standard/standardserviceroot.h"
@@ -29,12 +31,66 @@
 #include <QDomDocument>
 #include <QDomElement>
 #include <QLocale>
+#include <QPixmap>
+#include <QRunnable>
 #include <QStack>
+#include <QThreadPool>
+
+// Fetches metadata of single imported feed in thread pool.
+// NOTE: Icon is passed as raw data, pixmaps can be built in GUI thread only.
+class FeedMetadataFetcher : public QRunnable {
+  public:
+    explicit FeedMetadataFetcher(FeedsImportExportModel* model, CancellationToken* cancellation,
+                                 int import_generation, int feed_index, const QString& url)
+      : m_model(model), m_cancellation(cancellation), m_importGeneration(import_generation),
+      m_feedIndex(feed_index), m_url(url) {}
+
+    void run() {
+      QByteArray icon_data;
+
+      CancellationToken::setCurrent(m_cancellation);
+      QPair<StandardFeed*, QNetworkReply::NetworkError> guessed = StandardFeed::guessFeed(m_url, QString(), QString(),
+                                                                                          &icon_data);
+      CancellationToken::setCurrent(nullptr);
+
+      if (guessed.first != nullptr) {
+        // Guessed feed is handed over to main thread.
+        guessed.first->moveToThread(qApp->thread());
+      }
+
+      QMetaObject::invokeMethod(m_model, "onMetadataFetched", Qt::QueuedConnection,
+                                Q_ARG(int, m_importGeneration),
+                                Q_ARG(int, m_feedIndex),
+                                Q_ARG(StandardFeed*, guessed.first),
+                                Q_ARG(QByteArray, icon_data),
+                                Q_ARG(int, int(guessed.second)));
+    }
+
+  private:
+    FeedsImportExportModel* m_model;
+    CancellationToken* m_cancellation;
+    int m_importGeneration;
+    int m_feedIndex;
+    QString m_url;
+};
 
 FeedsImportExportModel::FeedsImportExportModel(QObject* parent)
-  : AccountCheckModel(parent), m_mode(Import) {}
+  : AccountCheckModel(parent), m_mode(Import), m_threadPool(new QThreadPool(this)),
+  m_cancellation(new CancellationToken(this)), m_importGeneration(0),
+  m_importRoot(nullptr), m_metadataPending(0), m_metadataCompleted(0), m_importFailed(0), m_importSucceeded(0) {
+  qRegisterMetaType<StandardFeed*>("StandardFeed*");
+  m_threadPool->setMaxThreadCount(qMax(1, qApp->settings()->value(GROUP(Feeds), SETTING(Feeds::ImportMetadataThreads)).toInt()));
+}
 
 FeedsImportExportModel::~FeedsImportExportModel() {
+  // Abort running metadata fetchers and wait for them, so
+  // that they do not report back to destroyed model.
+  stopMetadataFetchers();
+
+  if (m_importRoot != nullptr) {
+    delete m_importRoot;
+  }
+
   if (m_rootItem != nullptr && m_mode == Import) {
     // Delete all model items, but only if we are in import mode. Export mode shares
     // root item with main feed model, thus cannot be deleted from memory now.
@@ -142,6 +198,8 @@ bool FeedsImportExportModel::exportToOMPL20(QByteArray& result) {
 }
 
 void FeedsImportExportModel::importAsOPML20(const QByteArray& data, bool fetch_metadata_online) {
+  discardMetadataFetching();
+
   emit parsingStarted();
   emit layoutAboutToBeChanged();
 
@@ -151,12 +209,14 @@ void FeedsImportExportModel::importAsOPML20(const QByteArray& data, bool fetch_m
 
   if (!opml_document.setContent(data)) {
     emit parsingFinished(0, 0, true);
+    return;
   }
 
   if (opml_document.documentElement().isNull() || opml_document.documentElement().tagName() != QSL("opml") ||
       opml_document.documentElement().elementsByTagName(QSL("body")).size() != 1) {
     // This really is not an OPML file.
     emit parsingFinished(0, 0, true);
+    return;
   }
 
   int completed = 0, total = 0, succeded = 0, failed = 0;
@@ -188,48 +248,39 @@ void FeedsImportExportModel::importAsOPML20(const QByteArray& data, bool fetch_m
           QString feed_url = child_element.attribute(QSL("xmlUrl"));
 
           if (!feed_url.isEmpty()) {
-            QPair<StandardFeed*, QNetworkReply::NetworkError> guessed;
+            QString feed_title = child_element.attribute(QSL("text"));
+            QString feed_encoding = child_element.attribute(QSL("encoding"), DEFAULT_FEED_ENCODING);
+            QString feed_type = child_element.attribute(QSL("version"), DEFAULT_FEED_TYPE).toUpper();
+            QString feed_description = child_element.attribute(QSL("description"));
+            QIcon feed_icon = qApp->icons()->fromByteArray(child_element.attribute(QSL("rssguard:icon")).toLocal8Bit());
+            StandardFeed* new_feed = new StandardFeed(active_model_item);
+
+            new_feed->setTitle(feed_title);
+            new_feed->setDescription(feed_description);
+            new_feed->setEncoding(feed_encoding);
+            new_feed->setUrl(feed_url);
+            new_feed->setCreationDate(QDateTime::currentDateTime());
+            new_feed->setIcon(feed_icon.isNull() ? qApp->icons()->fromTheme(QSL("application-rss+xml")) : feed_icon);
+
+            if (feed_type == QL1S("RSS1")) {
+              new_feed->setType(StandardFeed::Rdf);
+            }
+            else if (feed_type == QL1S("ATOM")) {
+              new_feed->setType(StandardFeed::Atom10);
+            }
+            else {
+              new_feed->setType(StandardFeed::Rss2X);
+            }
 
-            if (fetch_metadata_online &&
-                (guessed = StandardFeed::guessFeed(feed_url)).second == QNetworkReply::NoError) {
-              // We should obtain fresh metadata from online feed source.
-              guessed.first->setUrl(feed_url);
-              active_model_item->appendChild(guessed.first);
-              succeded++;
+            active_model_item->appendChild(new_feed);
+
+            if (fetch_metadata_online) {
+              // Data from OPML file are kept if online metadata
+              // cannot be fetched.
+              m_feedsWaitingForMetadata.append(new_feed);
             }
             else {
-              QString feed_title = child_element.attribute(QSL("text"));
-              QString feed_encoding = child_element.attribute(QSL("encoding"), DEFAULT_FEED_ENCODING);
-              QString feed_type = child_element.attribute(QSL("version"), DEFAULT_FEED_TYPE).toUpper();
-              QString feed_description = child_element.attribute(QSL("description"));
-              QIcon feed_icon = qApp->icons()->fromByteArray(child_element.attribute(QSL("rssguard:icon")).toLocal8Bit());
-              StandardFeed* new_feed = new StandardFeed(active_model_item);
-
-              new_feed->setTitle(feed_title);
-              new_feed->setDescription(feed_description);
-              new_feed->setEncoding(feed_encoding);
-              new_feed->setUrl(feed_url);
-              new_feed->setCreationDate(QDateTime::currentDateTime());
-              new_feed->setIcon(feed_icon.isNull() ? qApp->icons()->fromTheme(QSL("application-rss+xml")) : feed_icon);
-
-              if (feed_type == QL1S("RSS1")) {
-                new_feed->setType(StandardFeed::Rdf);
-              }
-              else if (feed_type == QL1S("ATOM")) {
-                new_feed->setType(StandardFeed::Atom10);
-              }
-              else {
-                new_feed->setType(StandardFeed::Rss2X);
-              }
-
-              active_model_item->appendChild(new_feed);
-
-              if (fetch_metadata_online && guessed.second != QNetworkReply::NoError) {
-                failed++;
-              }
-              else {
-                succeded++;
-              }
+              succeded++;
             }
           }
         }
@@ -268,11 +319,12 @@ void FeedsImportExportModel::importAsOPML20(const QByteArray& data, bool fetch_m
   }
 
   // Now, XML is processed and we have result in form of pointer item structure.
-  emit layoutAboutToBeChanged();
-
-  setRootItem(root_item);
-  emit layoutChanged();
-  emit parsingFinished(failed, succeded, false);
+  if (fetch_metadata_online && !m_feedsWaitingForMetadata.isEmpty()) {
+    fetchMetadataOnline(root_item, failed, succeded);
+  }
+  else {
+    finishImport(root_item, failed, succeded);
+  }
 }
 
 bool FeedsImportExportModel::exportToTxtURLPerLine(QByteArray& result) {
@@ -284,6 +336,8 @@ bool FeedsImportExportModel::exportToTxtURLPerLine(QByteArray& result) {
 }
 
 void FeedsImportExportModel::importAsTxtURLPerLine(const QByteArray& data, bool fetch_metadata_online) {
+  discardMetadataFetching();
+
   emit parsingStarted();
   emit layoutAboutToBeChanged();
 
@@ -296,33 +350,21 @@ void FeedsImportExportModel::importAsTxtURLPerLine(const QByteArray& data, bool
 
   foreach (const QByteArray& url, urls) {
     if (!url.isEmpty()) {
-      QPair<StandardFeed*, QNetworkReply::NetworkError> guessed;
+      StandardFeed* feed = new StandardFeed();
 
-      if (fetch_metadata_online &&
-          (guessed = StandardFeed::guessFeed(url)).second == QNetworkReply::NoError) {
-        guessed.first->setUrl(url);
-        root_item->appendChild(guessed.first);
-        succeded++;
+      feed->setUrl(url);
+      feed->setTitle(url);
+      feed->setCreationDate(QDateTime::currentDateTime());
+      feed->setIcon(qApp->icons()->fromTheme(QSL("application-rss+xml")));
+      feed->setEncoding(DEFAULT_FEED_ENCODING);
+      root_item->appendChild(feed);
+
+      if (fetch_metadata_online) {
+        m_feedsWaitingForMetadata.append(feed);
       }
       else {
-        StandardFeed* feed = new StandardFeed();
-
-        feed->setUrl(url);
-        feed->setTitle(url);
-        feed->setCreationDate(QDateTime::currentDateTime());
-        feed->setIcon(qApp->icons()->fromTheme(QSL("application-rss+xml")));
-        feed->setEncoding(DEFAULT_FEED_ENCODING);
-        root_item->appendChild(feed);
-
-        if (fetch_metadata_online && guessed.second != QNetworkReply::NoError) {
-          failed++;
-        }
-        else {
-          succeded++;
-        }
+        succeded++;
       }
-
-      qApp->processEvents();
     }
     else {
       qWarning("Detected empty URL when parsing input TXT [one URL per line] data.");
@@ -333,11 +375,132 @@ void FeedsImportExportModel::importAsTxtURLPerLine(const QByteArray& data, bool
   }
 
   // Now, XML is processed and we have result in form of pointer item structure.
+  if (fetch_metadata_online && !m_feedsWaitingForMetadata.isEmpty()) {
+    fetchMetadataOnline(root_item, failed, succeded);
+  }
+  else {
+    finishImport(root_item, failed, succeded);
+  }
+}
+
+bool FeedsImportExportModel::isFetchingMetadata() const {
+  return m_importRoot != nullptr;
+}
+
+void FeedsImportExportModel::cancelMetadataFetching() {
+  if (m_importRoot == nullptr) {
+    return;
+  }
+
+  qDebug("Cancelling fetching of metadata for %d imported feeds.", m_metadataPending);
+
+  // Fetchers which did not start yet are thrown away, running
+  // fetchers are aborted and report back with obsolete generation.
+  stopMetadataFetchers();
+  m_importGeneration++;
+
+  StandardServiceRoot* root_item = m_importRoot;
+
+  // Feeds without fetched metadata are counted as failed ones.
+  m_importFailed += m_metadataPending;
+  m_importRoot = nullptr;
+  m_feedsWaitingForMetadata.clear();
+  m_metadataPending = 0;
+  finishImport(root_item, m_importFailed, m_importSucceeded);
+}
+
+void FeedsImportExportModel::discardMetadataFetching() {
+  if (m_importRoot != nullptr) {
+    stopMetadataFetchers();
+    m_importGeneration++;
+
+    delete m_importRoot;
+    m_importRoot = nullptr;
+  }
+
+  m_feedsWaitingForMetadata.clear();
+  m_metadataPending = 0;
+}
+
+void FeedsImportExportModel::stopMetadataFetchers() {
+  m_threadPool->clear();
+
+  // Network operations of running fetchers are aborted, so waiting is short.
+  m_cancellation->cancel();
+  m_threadPool->waitForDone();
+  m_cancellation->reset();
+}
+
+void FeedsImportExportModel::fetchMetadataOnline(StandardServiceRoot* root_item, int count_failed, int count_succeeded) {
+  m_importRoot = root_item;
+  m_importFailed = count_failed;
+  m_importSucceeded = count_succeeded;
+  m_metadataCompleted = 0;
+  m_metadataPending = m_feedsWaitingForMetadata.size();
+
+  qDebug("Fetching metadata for %d imported feeds with %d threads.", m_metadataPending, m_threadPool->maxThreadCount());
+  emit parsingProgress(0, m_metadataPending);
+
+  for (int i = 0; i < m_feedsWaitingForMetadata.size(); i++) {
+    m_threadPool->start(new FeedMetadataFetcher(this, m_cancellation, m_importGeneration, i, m_feedsWaitingForMetadata.at(i)->url()));
+  }
+}
+
+void FeedsImportExportModel::onMetadataFetched(int import_generation, int feed_index, StandardFeed* guessed_feed,
+                                               const QByteArray& icon_data, int network_error) {
+  if (import_generation != m_importGeneration || m_importRoot == nullptr) {
+    // This is result for import which is already cancelled.
+    if (guessed_feed != nullptr) {
+      delete guessed_feed;
+    }
+
+    return;
+  }
+
+  StandardFeed* feed = m_feedsWaitingForMetadata.at(feed_index);
+
+  if (guessed_feed != nullptr && network_error == QNetworkReply::NoError) {
+    // We should obtain fresh metadata from online feed source.
+    feed->setTitle(guessed_feed->title());
+    feed->setDescription(guessed_feed->description());
+    feed->setEncoding(guessed_feed->encoding());
+    feed->setType(guessed_feed->type());
+
+    QPixmap icon_pixmap;
+
+    if (icon_pixmap.loadFromData(icon_data)) {
+      feed->setIcon(QIcon(icon_pixmap));
+    }
+
+    m_importSucceeded++;
+  }
+  else {
+    m_importFailed++;
+  }
+
+  if (guessed_feed != nullptr) {
+    delete guessed_feed;
+  }
+
+  m_metadataCompleted++;
+  m_metadataPending--;
+  emit parsingProgress(m_metadataCompleted, m_feedsWaitingForMetadata.size());
+
+  if (m_metadataPending <= 0) {
+    StandardServiceRoot* root_item = m_importRoot;
+
+    m_importRoot = nullptr;
+    m_feedsWaitingForMetadata.clear();
+    finishImport(root_item, m_importFailed, m_importSucceeded);
+  }
+}
+
+void FeedsImportExportModel::finishImport(StandardServiceRoot* root_item, int count_failed, int count_succeeded) {
   emit layoutAboutToBeChanged();
 
   setRootItem(root_item);
   emit layoutChanged();
-  emit parsingFinished(failed, succeded, false);
+  emit parsingFinished(count_failed, count_succeeded, false);
 }
 
 FeedsImportExportModel::Mode FeedsImportExportModel::mode() const {
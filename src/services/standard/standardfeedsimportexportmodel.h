@@ -21,6 +21,12 @@
 
 #include "services/abstract/accountcheckmodel.h"
 
+#include "services/standard/standardfeed.h"
+
+class CancellationToken;
+class StandardServiceRoot;
+class QThreadPool;
+
 class FeedsImportExportModel : public AccountCheckModel {
   Q_OBJECT
 
@@ -47,6 +53,20 @@ class FeedsImportExportModel : public AccountCheckModel {
     Mode mode() const;
     void setMode(const Mode& mode);
 
+    // Returns true if online metadata of imported feeds
+    // are being fetched right now.
+    bool isFetchingMetadata() const;
+
+  public slots:
+
+    // Stops fetching of online metadata, feeds which
+    // were not processed yet keep metadata from input file.
+    void cancelMetadataFetching();
+
+  private slots:
+    void onMetadataFetched(int import_generation, int feed_index, StandardFeed* guessed_feed,
+                           const QByteArray& icon_data, int network_error);
+
   signals:
 
     // These signals are emitted when user selects some data
@@ -56,7 +76,25 @@ class FeedsImportExportModel : public AccountCheckModel {
     void parsingFinished(int count_failed, int count_succeeded, bool parsing_error);
 
   private:
+    void discardMetadataFetching();
+    void stopMetadataFetchers();
+    void fetchMetadataOnline(StandardServiceRoot* root_item, int count_failed, int count_succeeded);
+    void finishImport(StandardServiceRoot* root_item, int count_failed, int count_succeeded);
+
     Mode m_mode;
+
+    // Feeds are fetched in parallel, each import
+    // has its generation, so that results of cancelled
+    // imports can be recognized and thrown away.
+    QThreadPool* m_threadPool;
+    CancellationToken* m_cancellation;
+    int m_importGeneration;
+    StandardServiceRoot* m_importRoot;
+    QList<StandardFeed*> m_feedsWaitingForMetadata;
+    int m_metadataPending;
+    int m_metadataCompleted;
+    int m_importFailed;
+    int m_importSucceeded;
 };
 
 #endif // STANDARDFEEDSIMPORTEXPORTMODEL_H
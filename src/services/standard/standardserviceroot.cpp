@@ -38,6 +38,7 @@
 
 #include <QAction>
 #include <QClipboard>
+#include <QSqlError>
 #include <QSqlTableModel>
 #include <QStack>
 
@@ -58,8 +59,9 @@ StandardServiceRoot::~StandardServiceRoot() {
 void StandardServiceRoot::start(bool freshly_activated) {
   loadFromDatabase();
 
-  if (freshly_activated && getSubTree(RootItemKind::Feed).isEmpty()) {
+  if (freshly_activated && getSubTree(RootItemKind::Feed).isEmpty() && !qApp->isHeadless()) {
     // In other words, if there are no feeds or categories added.
+    // Headless instance cannot ask, so it stays empty.
     if (MessageBox::show(qApp->mainFormWidget(), QMessageBox::Question, QObject::tr("Load initial set of feeds"),
                          tr("This new account does not include any feeds. You can now add default set of feeds."),
                          tr("Do you want to load initial set of feeds?"),
@@ -207,6 +209,13 @@ bool StandardServiceRoot::mergeImportExportModel(FeedsImportExportModel* model,
   new_parents.push(model->rootItem());
   bool some_feed_category_error = false;
 
+  // All items are inserted within single transaction, which is
+  // significantly faster than committing each of them separately.
+  QSqlDatabase database = qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings);
+  QList<RootItem*> added_items;
+
+  database.transaction();
+
   // Iterate all new items we would like to merge into current model.
   while (!new_parents.isEmpty()) {
     RootItem* target_parent = original_parents.pop();
@@ -227,8 +236,9 @@ bool StandardServiceRoot::mergeImportExportModel(FeedsImportExportModel* model,
         // Add category to model.
         new_category->clearChildren();
 
-        if (new_category->addItself(target_parent)) {
+        if (new_category->addItself(target_parent, database)) {
           requestItemReassignment(new_category, target_parent);
+          added_items.append(new_category);
 
           // Process all children of this category.
           original_parents.push(new_category);
@@ -262,8 +272,9 @@ bool StandardServiceRoot::mergeImportExportModel(FeedsImportExportModel* model,
         StandardFeed* new_feed = new StandardFeed(*source_feed);
 
         // Append this feed and end this iteration.
-        if (new_feed->addItself(target_parent)) {
+        if (new_feed->addItself(target_parent, database)) {
           requestItemReassignment(new_feed, target_parent);
+          added_items.append(new_feed);
         }
         else {
           delete new_feed;
@@ -273,6 +284,21 @@ bool StandardServiceRoot::mergeImportExportModel(FeedsImportExportModel* model,
     }
   }
 
+  if (!database.commit()) {
+    qCritical("Transaction commit for feeds import failed, reason: '%s'.", qPrintable(database.lastError().text()));
+    database.rollback();
+
+    // Nothing was stored, remove top-level imported items (and thus their descendants) from the model.
+    foreach (RootItem* added_item, added_items) {
+      if (!added_items.contains(added_item->parent())) {
+        requestItemRemoval(added_item);
+      }
+    }
+
+    output_message = tr("Import failed, feeds/categories could not be stored in database.");
+    return false;
+  }
+
   if (some_feed_category_error) {
     output_message = tr("Import successful, but some feeds/categories were not imported due to error.");
   }
@@ -19,6 +19,7 @@
 #include "services/tt-rss/gui/formeditttrssaccount.h"
 
 #include "gui/guiutilities.h"
+#include "gui/retentionpolicyedit.h"
 #include "miscellaneous/iconfactory.h"
 #include "network-web/networkfactory.h"
 #include "services/tt-rss/definitions.h"
@@ -26,8 +27,10 @@
 #include "services/tt-rss/ttrssserviceroot.h"
 
 FormEditTtRssAccount::FormEditTtRssAccount(QWidget* parent)
-  : QDialog(parent), m_ui(new Ui::FormEditTtRssAccount), m_editableRoot(nullptr) {
+  : QDialog(parent), m_ui(new Ui::FormEditTtRssAccount), m_editableRoot(nullptr),
+  m_retentionPolicy(new RetentionPolicyEdit(this)) {
   m_ui->setupUi(this);
+  m_ui->verticalLayout->insertWidget(m_ui->verticalLayout->indexOf(m_ui->m_buttonBox), m_retentionPolicy);
   m_btnOk = m_ui->m_buttonBox->button(QDialogButtonBox::Ok);
 
   GuiUtilities::applyDialogProperties(*this, qApp->icons()->fromTheme(QSL("tinytinyrss")));
@@ -57,7 +60,8 @@ FormEditTtRssAccount::FormEditTtRssAccount(QWidget* parent)
   setTabOrder(m_ui->m_txtHttpUsername->lineEdit(), m_ui->m_txtHttpPassword->lineEdit());
   setTabOrder(m_ui->m_txtHttpPassword->lineEdit(), m_ui->m_checkShowHttpPassword);
   setTabOrder(m_ui->m_checkShowHttpPassword, m_ui->m_btnTestSetup);
-  setTabOrder(m_ui->m_btnTestSetup, m_ui->m_buttonBox);
+  setTabOrder(m_ui->m_btnTestSetup, m_retentionPolicy);
+  setTabOrder(m_retentionPolicy, m_ui->m_buttonBox);
 
   connect(m_ui->m_checkShowPassword, &QCheckBox::toggled, this, &FormEditTtRssAccount::displayPassword);
   connect(m_ui->m_buttonBox, &QDialogButtonBox::accepted, this, &FormEditTtRssAccount::onClickedOk);
@@ -103,6 +107,7 @@ void FormEditTtRssAccount::execForEdit(TtRssServiceRoot* existing_root) {
   m_ui->m_txtPassword->lineEdit()->setText(existing_root->network()->password());
   m_ui->m_txtUrl->lineEdit()->setText(existing_root->network()->url());
   m_ui->m_checkServerSideUpdate->setChecked(existing_root->network()->forceServerSideUpdate());
+  m_retentionPolicy->loadPolicy(existing_root->accountId(), QString());
   exec();
 }
 
@@ -203,6 +208,7 @@ void FormEditTtRssAccount::onClickedOk() {
   m_editableRoot->network()->setAuthPassword(m_ui->m_txtHttpPassword->lineEdit()->text());
   m_editableRoot->network()->setForceServerSideUpdate(m_ui->m_checkServerSideUpdate->isChecked());
   m_editableRoot->saveAccountDataToDatabase();
+  m_retentionPolicy->savePolicy(m_editableRoot->accountId(), QString());
   accept();
 
   if (editing_account) {
@@ -28,6 +28,7 @@ namespace Ui {
 }
 
 class TtRssServiceRoot;
+class RetentionPolicyEdit;
 
 class FormEditTtRssAccount : public QDialog {
   Q_OBJECT
@@ -57,7 +58,7 @@ class FormEditTtRssAccount : public QDialog {
   private:
     QScopedPointer<Ui::FormEditTtRssAccount> m_ui;
     TtRssServiceRoot* m_editableRoot;
-    QPushButton* m_btnOk;
+    QPushButton* m_btnOk;    RetentionPolicyEdit* m_retentionPolicy;
 };
 
 #endif // FORMEDITACCOUNT_H
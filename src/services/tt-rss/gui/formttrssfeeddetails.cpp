@@ -18,6 +18,7 @@
 
 #include "services/tt-rss/gui/formttrssfeeddetails.h"
 
+#include "gui/retentionpolicyedit.h"
 #include "miscellaneous/application.h"
 #include "services/tt-rss/definitions.h"
 #include "services/tt-rss/network/ttrssnetworkfactory.h"
@@ -36,6 +37,9 @@ FormTtRssFeedDetails::FormTtRssFeedDetails(ServiceRoot* service_root, QWidget* p
   m_ui->m_btnIcon->setEnabled(false);
   m_ui->m_txtTitle->setEnabled(false);
   m_ui->m_txtDescription->setEnabled(false);
+
+  // Feed gets its ID after next sync, so policy can be set only for existing feeds.
+  m_retentionPolicy->setEnabled(false);
 }
 
 void FormTtRssFeedDetails::apply() {
@@ -48,6 +52,7 @@ void FormTtRssFeedDetails::apply() {
     new_feed_data->setAutoUpdateInitialInterval(m_ui->m_spinAutoUpdateInterval->value());
     qobject_cast<TtRssFeed*>(m_editableFeed)->editItself(new_feed_data);
     delete new_feed_data;
+    saveRetentionPolicy(m_editableFeed);
   }
   else {
     RootItem* parent = static_cast<RootItem*>(m_ui->m_cmbParentCategory->itemData(
@@ -81,6 +86,7 @@ void FormTtRssFeedDetails::apply() {
 
 void FormTtRssFeedDetails::setEditableFeed(Feed* editable_feed) {
   m_ui->m_cmbAutoUpdateType->setEnabled(true);
+  m_retentionPolicy->setEnabled(true);
   FormFeedDetails::setEditableFeed(editable_feed);
 
   // Tiny Tiny RSS does not support editing of these features.
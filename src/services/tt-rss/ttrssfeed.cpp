@@ -29,6 +29,7 @@
 #include "services/tt-rss/ttrssserviceroot.h"
 
 #include <QPointer>
+#include <QUrl>
 
 TtRssFeed::TtRssFeed(RootItem* parent)
   : Feed(parent) {}
@@ -83,6 +84,11 @@ bool TtRssFeed::editItself(TtRssFeed* new_feed_data) {
   }
 }
 
+QString TtRssFeed::updateHost() const {
+  // Messages are obtained from TT-RSS server, not from the feed itself.
+  return QUrl(serviceRoot()->network()->url()).host().toLower();
+}
+
 QList<Message> TtRssFeed::obtainNewMessages(bool* error_during_obtaining) {
   QList<Message> messages;
   int newly_added_messages = 0;
@@ -93,7 +99,9 @@ QList<Message> TtRssFeed::obtainNewMessages(bool* error_during_obtaining) {
     TtRssGetHeadlinesResponse headlines = serviceRoot()->network()->getHeadlines(customId().toInt(), limit, skip,
                                                                                  true, true, false);
 
-    if (serviceRoot()->network()->lastError() != QNetworkReply::NoError) {
+    m_updateMetrics.m_networkError = serviceRoot()->network()->lastError();
+
+    if (m_updateMetrics.m_networkError != QNetworkReply::NoError) {
       setStatus(Feed::NetworkError);
       *error_during_obtaining = true;
       serviceRoot()->itemChanged(QList<RootItem*>() << this);
@@ -34,6 +34,7 @@ class TtRssFeed : public Feed {
     virtual ~TtRssFeed();
 
     TtRssServiceRoot* serviceRoot() const;
+    QString updateHost() const;
 
     bool canBeEdited() const;
     bool editViaGui();
@@ -44,6 +44,7 @@ TtRssServiceRoot::TtRssServiceRoot(RootItem* parent)
 }
 
 TtRssServiceRoot::~TtRssServiceRoot() {
+  abortSynchronization();
   delete m_network;
 }
 
@@ -125,44 +126,42 @@ bool TtRssServiceRoot::canBeDeleted() const {
   return true;
 }
 
-void TtRssServiceRoot::saveAllCachedData(bool async) {
-  QPair<QMap<RootItem::ReadStatus, QStringList>, QMap<RootItem::Importance, QList<Message>>> msgCache = takeMessageCache();
-  QMapIterator<RootItem::ReadStatus, QStringList> i(msgCache.first);
+QNetworkReply::NetworkError TtRssServiceRoot::sendReadStatesToService(RootItem::ReadStatus read, const QStringList& custom_ids) {
+  TtRssUpdateArticleResponse response = network()->updateArticles(custom_ids,
+                                                                  UpdateArticle::Unread,
+                                                                  read == RootItem::Unread ? UpdateArticle::SetToTrue :
+                                                                  UpdateArticle::SetToFalse);
 
-  // Save the actual data read/unread.
-  while (i.hasNext()) {
-    i.next();
-    auto key = i.key();
-    QStringList ids = i.value();
-
-    if (!ids.isEmpty()) {
-      network()->updateArticles(ids,
-                                UpdateArticle::Unread,
-                                key == RootItem::Unread ? UpdateArticle::SetToTrue : UpdateArticle::SetToFalse,
-                                async);
-    }
-  }
-
-  QMapIterator<RootItem::Importance, QList<Message>> j(msgCache.second);
-
-  // Save the actual data important/not important.
-  while (j.hasNext()) {
-    j.next();
-    auto key = j.key();
+  return updateArticlesError(response);
+}
 
-    QList<Message> messages = j.value();
+QNetworkReply::NetworkError TtRssServiceRoot::sendImportanceStatesToService(RootItem::Importance importance, const QList<Message>& messages) {
+  TtRssUpdateArticleResponse response = network()->updateArticles(customIDsOfMessages(messages),
+                                                                  UpdateArticle::Starred,
+                                                                  importance == RootItem::Important ? UpdateArticle::SetToTrue :
+                                                                  UpdateArticle::SetToFalse);
 
-    if (!messages.isEmpty()) {
-      QStringList ids = customIDsOfMessages(messages);
+  return updateArticlesError(response);
+}
 
-      network()->updateArticles(ids,
-                                UpdateArticle::Starred,
-                                key == RootItem::Important ? UpdateArticle::SetToTrue : UpdateArticle::SetToFalse,
-                                async);
-    }
+QNetworkReply::NetworkError TtRssServiceRoot::updateArticlesError(const TtRssUpdateArticleResponse& response) const {
+  if (response.status() == TTRSS_API_STATUS_OK) {
+    return QNetworkReply::NoError;
+  }
+  else if (network()->lastError() != QNetworkReply::NoError) {
+    return network()->lastError();
+  }
+  else {
+    // Request went through, but server refused it.
+    return QNetworkReply::UnknownServerError;
   }
 }
 
+int TtRssServiceRoot::syncParallelism() const {
+  // Requests share single session, which is renewed when it expires.
+  return 1;
+}
+
 QList<QAction*> TtRssServiceRoot::serviceMenu() {
   if (m_serviceMenu.isEmpty()) {
     m_actionSyncIn = new QAction(qApp->icons()->fromTheme(QSL("view-refresh")), tr("Sync in"), this);
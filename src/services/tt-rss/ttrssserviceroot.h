@@ -27,6 +27,7 @@
 class TtRssCategory;
 class TtRssFeed;
 class TtRssNetworkFactory;
+class TtRssUpdateArticleResponse;
 
 class TtRssServiceRoot : public ServiceRoot, public CacheForServiceRoot {
   Q_OBJECT
@@ -48,7 +49,9 @@ class TtRssServiceRoot : public ServiceRoot, public CacheForServiceRoot {
 
     QString additionalTooltip() const;
 
-    void saveAllCachedData(bool async = true);
+    QNetworkReply::NetworkError sendReadStatesToService(RootItem::ReadStatus read, const QStringList& custom_ids);
+    QNetworkReply::NetworkError sendImportanceStatesToService(RootItem::Importance importance, const QList<Message>& messages);
+    int syncParallelism() const;
 
     // Access to network.
     TtRssNetworkFactory* network() const;
@@ -63,6 +66,9 @@ class TtRssServiceRoot : public ServiceRoot, public CacheForServiceRoot {
   private:
     RootItem* obtainNewTreeForSyncIn() const;
 
+    // Returns error of sending of message states.
+    QNetworkReply::NetworkError updateArticlesError(const TtRssUpdateArticleResponse& response) const;
+
     void loadFromDatabase();
 
     QAction* m_actionSyncIn;